@@ -0,0 +1,40 @@
+#ifndef IOT_SIMULATION_DEVICE_HANDLE_H
+#define IOT_SIMULATION_DEVICE_HANDLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+namespace iot {
+
+    /**
+     * @brief Compact interned device identifier
+     *
+     * Handles are dense indices issued by a DeviceIdTable, so internal
+     * lookups can index arrays instead of hashing or comparing strings.
+     */
+    struct DeviceHandle {
+        static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+        uint32_t value = INVALID;
+
+        constexpr DeviceHandle() = default;
+        constexpr explicit DeviceHandle(uint32_t index) : value(index) {}
+
+        constexpr bool isValid() const { return value != INVALID; }
+        constexpr size_t index() const { return value; }
+
+        constexpr bool operator==(const DeviceHandle& other) const { return value == other.value; }
+        constexpr bool operator!=(const DeviceHandle& other) const { return value != other.value; }
+        constexpr bool operator<(const DeviceHandle& other) const { return value < other.value; }
+    };
+
+    struct DeviceHandleHash {
+        size_t operator()(const DeviceHandle& handle) const {
+            return std::hash<uint32_t>{}(handle.value);
+        }
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_DEVICE_HANDLE_H
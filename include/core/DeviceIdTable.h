@@ -0,0 +1,67 @@
+#ifndef IOT_SIMULATION_DEVICE_ID_TABLE_H
+#define IOT_SIMULATION_DEVICE_ID_TABLE_H
+
+#include "DeviceHandle.h"
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+
+namespace iot {
+
+    class CheckpointWriter;
+    class CheckpointReader;
+
+    /**
+     * @brief Thread-safe string <-> DeviceHandle interning table
+     *
+     * Handles are issued in first-seen order and never recycled, so a
+     * device that is unregistered and registered again keeps its handle.
+     * The table is only consulted at the edges (public string APIs).
+     */
+    class DeviceIdTable {
+    private:
+        std::unordered_map<std::string, DeviceHandle> handles;
+        std::deque<std::string> ids;  // deque keeps references stable
+        mutable std::shared_mutex tableMutex;
+
+    public:
+        DeviceIdTable() = default;
+
+        /**
+         * @brief Get the handle for an ID, issuing a new one if needed
+         */
+        DeviceHandle intern(const std::string& deviceId);
+
+        /**
+         * @brief Get the handle for an ID without issuing one
+         * @return Invalid handle if the ID was never interned
+         */
+        DeviceHandle find(const std::string& deviceId) const;
+
+        /**
+         * @brief Get the ID string for a handle
+         * @return Empty string for invalid or unknown handles
+         */
+        const std::string& name(DeviceHandle handle) const;
+
+        /**
+         * @brief Number of handles issued so far
+         */
+        size_t size() const;
+
+        /**
+         * @brief Save every ID in handle order
+         */
+        void writeCheckpoint(CheckpointWriter& out) const;
+
+        /**
+         * @brief Intern saved IDs under one lock so handles match the checkpoint
+         * @return false if the data is malformed or IDs already interned disagree
+         */
+        bool readCheckpoint(CheckpointReader& in);
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_DEVICE_ID_TABLE_H
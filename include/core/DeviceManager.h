@@ -2,11 +2,13 @@
 #define IOT_SIMULATION_DEVICE_MANAGER_H
 
 #include "IoTDevice.h"
+#include "DeviceIdTable.h"
 #include <map>
 #include <vector>
 #include <memory>
 #include <string>
 #include <mutex>
+#include <atomic>
 
 namespace iot{
 
@@ -14,9 +16,13 @@ namespace iot{
 
     class DeviceManager{
         private:
-            std::map<std::string, std::shared_ptr<IoTDevice>> devices;
-            std::vector<std::string> deviceIds;
+            std::shared_ptr<DeviceIdTable> idTable;
+            std::vector<std::shared_ptr<IoTDevice>> devices;  // indexed by handle
+            std::vector<DeviceHandle> registeredHandles;      // registration order
+            std::shared_ptr<const SimClock> simClock;  // attached to every device
+            uint64_t randomSeed;                        // device streams derive from it
             mutable std::mutex devicesMutex;
+            std::atomic<uint64_t> registrationVersion;  // bumped on register/unregister
             int nextId;
         public:  
             DeviceManager();
@@ -25,26 +31,86 @@ namespace iot{
 
             bool registerDevice(std::shared_ptr<IoTDevice> device);
 
+            /**
+             * @brief Register many devices under one lock, without per-device logging
+             *
+             * Meant for rebuilding large fleets (e.g. restoring a checkpoint).
+             * Null devices and IDs that are already registered are skipped.
+             * @return Number of devices registered
+             */
+            size_t registerDevices(const std::vector<std::shared_ptr<IoTDevice>>& newDevices);
+
     void printStats() const;
             bool unregisterDevice(const std::string& deviceId);
 
             std::shared_ptr<IoTDevice> getDevice(const std::string& deviceId) const;
 
+            std::shared_ptr<IoTDevice> getDevice(DeviceHandle handle) const;
+
+            /**
+             * @brief Resolve a device ID to its handle (invalid if never seen)
+             */
+            DeviceHandle getHandle(const std::string& deviceId) const;
+
+            /**
+             * @brief Resolve or issue the handle for a device ID
+             */
+            DeviceHandle internDeviceId(const std::string& deviceId);
+
+            /**
+             * @brief Get the device ID string for a handle
+             */
+            const std::string& getDeviceId(DeviceHandle handle) const;
+
+            /**
+             * @brief Interning table shared with other components (e.g. MeshNetwork)
+             */
+            std::shared_ptr<DeviceIdTable> getIdTable() const { return idTable; }
+
             std::vector<std::shared_ptr<IoTDevice>> getAllDevices() const;
 
             std::vector<std::string> getDeviceIds() const;
 
             bool deviceExists(const std::string& deviceId) const;
 
+            bool deviceExists(DeviceHandle handle) const;
+
+            std::vector<DeviceHandle> getDeviceHandles() const;
+
             size_t getDeviceCount() const;
 
+            /**
+             * @brief Changes whenever a device is registered or unregistered
+             *
+             * Lets callers cache getAllDevices() and refresh only when needed.
+             */
+            uint64_t getRegistrationVersion() const { return registrationVersion.load(std::memory_order_acquire); }
+
             std::string generateDeviceId(const std::string& prefix = "DEVICE");
 
             bool sendMessageToDevice(const Message& message);
+
+            bool sendMessageToDevice(DeviceHandle handle, const Message& message);
             
             void broadcastMessage(const Message& message);
 
             void listDevices() const;
+
+            /**
+             * @brief Attach a clock to all current and future devices
+             */
+            void setSimClock(std::shared_ptr<const SimClock> clock);
+
+            /**
+             * @brief Reseed the random streams of all current and future devices
+             *
+             * Defaults to the global seed at construction. A device's streams
+             * are keyed by this seed and its handle, so a fleet registered in
+             * the same order draws the same numbers on every run.
+             */
+            void setRandomSeed(uint64_t seed);
+
+            uint64_t getRandomSeed() const;
     };
 
    
@@ -1,21 +1,37 @@
 #ifndef IOT_SIMULATION_IOTDEVICE_H
 #define IOT_SIMULATION_IOTDEVICE_H
 
+#include "DeviceHandle.h"
+#include "Message.h"
+#include "../utils/CounterRng.h"
 #include <string>
 #include <memory>
 #include <chrono>
+#include <vector>
 
 
 namespace iot {
-    class Message;
+    class SimClock;
+    class CheckpointWriter;
+    class CheckpointReader;
 
     class IoTDevice{
         protected:
           std::string deviceId;
           std::string deviceType;
           std::string deviceName;
+          DeviceHandle handle;
           bool isActive;
           std::chrono::steady_clock::time_point lastUpdate;
+          std::shared_ptr<const SimClock> simClock;  // simulated time of day
+          std::vector<Message> outbox;  // flushed to the network at the end of each engine tick
+
+          /**
+           * @brief Key of this device's stream for one purpose
+           *
+           * Keyed by handle once registered; before that by a hash of the ID.
+           */
+          uint64_t randomStreamKey(uint64_t seed, StreamPurpose purpose) const;
 
         public: 
             IoTDevice(const std::string& id, const std::string& type, const std::string& name);
@@ -34,9 +50,60 @@ namespace iot {
 
             const std::string& getDeviceName() const { return deviceName; }
 
+            DeviceHandle getHandle() const { return handle; }
+
+            void setHandle(DeviceHandle deviceHandle) { handle = deviceHandle; }
+
             bool isActiveDevice() const { return isActive; }
 
             void setActive(bool active) { isActive = active; }
+
+            /**
+             * @brief Clock used for time-of-day behaviour (wall clock by default)
+             */
+            void setSimClock(std::shared_ptr<const SimClock> clock);
+
+            const std::shared_ptr<const SimClock>& getSimClock() const { return simClock; }
+
+            /**
+             * @brief Restart the device's random streams from a simulation seed
+             *
+             * Streams are keyed by (seed, purpose, handle), so a device draws
+             * the same numbers whichever thread runs it and in whatever order.
+             * DeviceManager calls this on registration; devices that draw no
+             * random numbers ignore it.
+             */
+            virtual void setRandomSeed(uint64_t seed) { (void)seed; }
+
+            /**
+             * @brief Queue a message for the engine's end-of-tick network flush
+             *
+             * Meant for the device's own update/sampling code; the outbox is
+             * not synchronised.
+             */
+            void queueMessage(Message message) { outbox.push_back(std::move(message)); }
+
+            /**
+             * @brief Move every queued message to the back of out
+             * @return Number of messages moved
+             */
+            size_t takeOutbox(std::vector<Message>& out);
+
+            size_t getOutboxSize() const { return outbox.size(); }
+
+            /**
+             * @brief Append the device's mutable state to a checkpoint record
+             *
+             * Overrides call the base version first, then add their own
+             * fields. Identity (ID, name, type) is stored by the caller.
+             */
+            virtual void writeState(CheckpointWriter& out) const;
+
+            /**
+             * @brief Restore what writeState wrote
+             * @return false if the record is malformed
+             */
+            virtual bool readState(CheckpointReader& in);
     };
 }
 
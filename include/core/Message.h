@@ -1,11 +1,22 @@
 #ifndef IOT_SIMULATION_MESSAGE_H
 #define IOT_SIMULATION_MESSAGE_H
 
+#include "DeviceHandle.h"
 #include <string>
 #include <chrono>
-#include <map>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace iot{
+    /**
+     * @brief Message exchanged between devices
+     *
+     * The payload lives in an immutable, reference-counted buffer, so
+     * copying a Message (queueing, broadcast fan-out) shares the bytes
+     * instead of duplicating them. Headers are a small flat vector.
+     */
     class Message{
         public:
             enum class MessageType{
@@ -16,13 +27,18 @@ namespace iot{
             };
         
         private: 
-            std::string messageId;
+            uint64_t messageId;
             std::string sourceDeviceId;
             std::string destinationDeviceId;
-            std::string payload;
+            DeviceHandle sourceHandle;
+            DeviceHandle destinationHandle;
+            std::shared_ptr<const std::string> payload;
             MessageType type;
             std::chrono::steady_clock::time_point timestamp;
-            std::map<std::string, std::string> headers;
+            std::vector<std::pair<std::string, std::string>> headers;
+
+            // Read through a moved-from message, whose payload pointer is null
+            inline static const std::string EMPTY_PAYLOAD;
 
         public: 
             Message(const std::string& sourceId, 
@@ -30,22 +46,72 @@ namespace iot{
                 const std::string& data,
                 MessageType msgType =  MessageType::DATA);
 
+            /**
+             * @brief Construct around an existing payload buffer without copying it
+             */
+            Message(const std::string& sourceId, 
+                const std::string& destId,
+                std::shared_ptr<const std::string> sharedPayload,
+                MessageType msgType =  MessageType::DATA);
+
             ~Message() = default;
+            
+            // Moving leaves the source valid but hollow: empty payload, no
+            // IDs or headers, so moves never allocate
+            Message(const Message&) = default;
+            Message(Message&&) noexcept = default;
+            Message& operator=(const Message&) = default;
+            Message& operator=(Message&&) noexcept = default;
 
-            const std::string& getMessageId() const { return messageId; }
+            /**
+             * @brief Unique ID: node (8 bits) | thread slot (16 bits) | per-thread sequence (40 bits)
+             */
+            uint64_t getMessageId() const { return messageId; }
             const std::string& getSourceDeviceId() const { return sourceDeviceId; }
             const std::string& getDestinationDeviceId() const { return destinationDeviceId; }
-            const std::string& getPayload() const { return payload; }
+            DeviceHandle getSourceHandle() const { return sourceHandle; }
+            DeviceHandle getDestinationHandle() const { return destinationHandle; }
+            const std::string& getPayload() const { return payload ? *payload : EMPTY_PAYLOAD; }
+            
+            /**
+             * @brief The payload buffer itself (null in a moved-from message)
+             */
+            const std::shared_ptr<const std::string>& getSharedPayload() const { return payload; }
             MessageType getMessageType() const { return type; }      
             std::chrono::steady_clock::time_point getTimestamp() const { return timestamp; }
          
-            void setPayload(const std::string& data) { payload = data; }
+            void setPayload(const std::string& data) { payload = std::make_shared<const std::string>(data); }
+            void setPayload(std::shared_ptr<const std::string> data);
+            
+            // Handles are resolved once at the network edge and reused internally
+            void setSourceHandle(DeviceHandle handle) { sourceHandle = handle; }
+            void setDestinationHandle(DeviceHandle handle) { destinationHandle = handle; }
             
             void addHeader(const std::string& key, const std::string& value);
             std::string getHeader(const std::string& key) const;
             bool hasHeader(const std::string& key) const;
+            const std::vector<std::pair<std::string, std::string>>& getHeaders() const { return headers; }
             
             std::string toString() const;
+            
+            /**
+             * @brief Format a message ID as "MSG_<node>-<thread>-<sequence>"
+             */
+            static std::string formatMessageId(uint64_t id);
+            
+            /**
+             * @brief Set the node prefix stamped into new message IDs (e.g. per process)
+             */
+            static void setNodeId(uint8_t nodeId);
+            
+        private:
+            /**
+             * @brief Next ID from the calling thread's counter (no locks, no shared RNG)
+             *
+             * A thread slot freed on thread exit is handed to a later thread
+             * with its sequence, so IDs stay unique past 65535 threads.
+             */
+            static uint64_t nextMessageId();
     };
 }
 
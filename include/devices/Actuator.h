@@ -29,6 +29,9 @@ namespace iot {
         bool getState() const { return state; }
 
         void toggle();
+
+        void writeState(CheckpointWriter& out) const override;
+        bool readState(CheckpointReader& in) override;
     };
     
 } 
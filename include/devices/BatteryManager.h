@@ -6,6 +6,9 @@
 
 namespace iot {
     
+    class CheckpointWriter;
+    class CheckpointReader;
+    
     /**
      * @brief Battery management for IoT devices
      */
@@ -84,6 +87,12 @@ namespace iot {
          * @return true if in low power mode
          */
         bool isInLowPowerMode() const { return lowPowerMode; }
+        
+        /**
+         * @brief Save or restore level, consumption rate and power mode (for checkpoints)
+         */
+        void writeState(CheckpointWriter& out) const;
+        bool readState(CheckpointReader& in);
     };
     
 } // namespace iot
@@ -3,7 +3,6 @@
 
 #include "Sensor.h"
 #include "BatteryManager.h"
-#include <random>
 
 namespace iot {
     
@@ -14,8 +13,9 @@ namespace iot {
     private:
         BatteryManager battery;
         double baselineTemp;
-        std::mt19937 rng;
-        std::uniform_real_distribution<double> noiseDistribution;
+        
+    protected:
+        double measure() override;
         
     public:
         BatteryTemperatureSensor(const std::string& id, const std::string& name);
@@ -29,6 +29,9 @@ namespace iot {
         bool isBatteryCritical() const { return battery.isBatteryCritical(); }
         bool isInLowPowerMode() const { return battery.isInLowPowerMode(); }
         void rechargeBattery(double amount) { battery.rechargeBattery(amount); }
+        
+        void writeState(CheckpointWriter& out) const override;
+        bool readState(CheckpointReader& in) override;
     };
     
     /**
@@ -38,11 +41,12 @@ namespace iot {
     private:
         BatteryManager battery;
         bool lastMotionState;
-        std::uniform_real_distribution<double> motionProbability;
-        std::mt19937 rng;
         int sleepInterval;  // Seconds between active periods
         int activeDuration; // Seconds of active sensing per cycle
         
+    protected:
+        double measure() override;
+        
     public:
         BatteryMotionSensor(const std::string& id, const std::string& name);
         double readValue() override;
@@ -56,6 +60,9 @@ namespace iot {
         bool isBatteryCritical() const { return battery.isBatteryCritical(); }
         bool isInLowPowerMode() const { return battery.isInLowPowerMode(); }
         void rechargeBattery(double amount) { battery.rechargeBattery(amount); }
+        
+        void writeState(CheckpointWriter& out) const override;
+        bool readState(CheckpointReader& in) override;
     };
     
 } // namespace iot
@@ -20,6 +20,8 @@ namespace iot {
         void setColor(const std::string& newColor);
         int getBrightness() const { return brightness; }
         const std::string& getColor() const { return color; }
+        void writeState(CheckpointWriter& out) const override;
+        bool readState(CheckpointReader& in) override;
     };
     
     /**
@@ -37,6 +39,8 @@ namespace iot {
         void stop();
         int getSpeed() const { return speed; }
         int getMaxSpeed() const { return maxSpeed; }
+        void writeState(CheckpointWriter& out) const override;
+        bool readState(CheckpointReader& in) override;
     };
     
     /**
@@ -47,13 +51,17 @@ namespace iot {
         double current;
         double maxCurrent;
         bool overloadProtection;
+        mutable RandomStream overloadRng;  // simulated overload events
         
     public:
         Relay(const std::string& id, const std::string& name, double maxCurr = 10.0);
         void setState(bool newState) override;
         bool isOverloaded() const;
+        void setRandomSeed(uint64_t seed) override;
         double getCurrent() const { return current; }
         double getMaxCurrent() const { return maxCurrent; }
+        void writeState(CheckpointWriter& out) const override;
+        bool readState(CheckpointReader& in) override;
     };
     
 } // namespace iot
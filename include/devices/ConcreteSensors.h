@@ -2,7 +2,6 @@
 #define IOT_SIMULATION_CONCRETE_SENSORS_H
 
 #include "Sensor.h"
-#include <random>
 
 namespace iot {
     
@@ -36,7 +35,6 @@ namespace iot {
     class MotionSensor : public Sensor {
     private:
         bool lastMotionState;
-        std::uniform_real_distribution<double> motionProbability;
         
     public:
         MotionSensor(const std::string& id, const std::string& name);
@@ -4,6 +4,7 @@
 #include "../core/IoTDevice.h"
 #include "../network/NetworkManager.h"
 #include "../network/ProtocolCharacteristics.h"
+#include "../utils/CheckpointStream.h"
 #include <iostream>
 namespace iot {
     
@@ -51,6 +52,20 @@ namespace iot {
             return characteristics.name;
         }
         
+        // Checkpoint support for the devices mixing this in
+        void writeProtocolState(CheckpointWriter& out) const {
+            out.writeU8(static_cast<uint8_t>(protocol));
+            out.writeDouble(batteryLevel);
+            out.writeBool(lowPowerMode);
+        }
+        
+        bool readProtocolState(CheckpointReader& in) {
+            protocol = static_cast<NetworkManager::Protocol>(in.readU8());
+            batteryLevel = in.readDouble();
+            lowPowerMode = in.readBool();
+            return in.ok();
+        }
+        
     private:
         void applyProtocolPowerSaving() {
             switch (protocol) {
@@ -4,7 +4,7 @@
 #include "ProtocolAwareDevice.h"
 #include "Sensor.h"
 #include <iostream>
-#include <random>
+#include <algorithm>
 
 namespace iot {
     
@@ -14,8 +14,13 @@ namespace iot {
         int transmissionInterval;  // Seconds between transmissions
         bool dutyCycleLimit;       // Comply with LoRa duty cycle regulations
         double baselineTemp;
-        std::mt19937 rng;
-        std::uniform_real_distribution<double> noiseDistribution;
+        
+    protected:
+        double measure() override {
+            // Simulate realistic temperature variations for LoRa sensor
+            double noise = rng.uniform(-0.1, 0.1) * 3.0;
+            return std::max(minValue, std::min(maxValue, baselineTemp + noise));
+        }
         
     public:
         LoRaTemperatureSensor(const std::string& id, const std::string& name)
@@ -23,16 +28,11 @@ namespace iot {
             , ProtocolAwareDevice(NetworkManager::Protocol::LORA)
             , transmissionInterval(300)  // 5 minutes default
             , dutyCycleLimit(true)
-            , baselineTemp(22.0)
-            , rng(std::random_device{}())
-            , noiseDistribution(-0.1, 0.1) {
+            , baselineTemp(22.0) {
         }
         
         double readValue() override {
-            // Simulate realistic temperature variations for LoRa sensor
-            double noise = noiseDistribution(rng) * 3.0;
-            double currentValue = baselineTemp + noise;
-            currentValue = std::max(minValue, std::min(maxValue, currentValue));
+            double currentValue = measure();
             
             // Simulate duty cycle compliance
             if (dutyCycleLimit) {
@@ -58,6 +58,19 @@ namespace iot {
         
         void setDutyCycleLimit(bool limit) { dutyCycleLimit = limit; }
         bool getDutyCycleLimit() const { return dutyCycleLimit; }
+        
+        void writeState(CheckpointWriter& out) const override {
+            Sensor::writeState(out);
+            writeProtocolState(out);
+            out.writeBool(dutyCycleLimit);
+        }
+        
+        bool readState(CheckpointReader& in) override {
+            Sensor::readState(in);
+            readProtocolState(in);
+            dutyCycleLimit = in.readBool();
+            return in.ok();
+        }
     };
     
     // ZigBee Motion Sensor - Optimized for mesh networking
@@ -65,22 +78,24 @@ namespace iot {
     private:
         bool meshRoutingEnabled;
         int hopCount;
-        std::uniform_real_distribution<double> motionProbability;
+        
+    protected:
+        double measure() override {
+            // Motion sensors return binary values (0 = no motion, 1 = motion detected)
+            double baseProbability = 0.15;  // Base motion probability
+            return rng.uniform() < baseProbability ? 1.0 : 0.0;
+        }
         
     public:
         ZigBeeMotionSensor(const std::string& id, const std::string& name)
             : Sensor(id, name, 0.0, 1.0)
             , ProtocolAwareDevice(NetworkManager::Protocol::ZIGBEE)
             , meshRoutingEnabled(true)
-            , hopCount(0)
-            , motionProbability(0.0, 1.0) {
+            , hopCount(0) {
         }
         
         double readValue() override {
-            // Motion sensors return binary values (0 = no motion, 1 = motion detected)
-            double baseProbability = 0.15;  // Base motion probability
-            double randomValue = motionProbability(rng);
-            double currentValue = (randomValue < baseProbability) ? 1.0 : 0.0;
+            double currentValue = measure();
             
             // ZigBee sensors can route through mesh - consume more power
             consumeBattery(0.2);
@@ -100,6 +115,21 @@ namespace iot {
         void setHopCount(int hops) { hopCount = hops; }
         int getHopCount() const { return hopCount; }
         void setMeshRouting(bool enabled) { meshRoutingEnabled = enabled; }
+        
+        void writeState(CheckpointWriter& out) const override {
+            Sensor::writeState(out);
+            writeProtocolState(out);
+            out.writeBool(meshRoutingEnabled);
+            out.writeSigned(hopCount);
+        }
+        
+        bool readState(CheckpointReader& in) override {
+            Sensor::readState(in);
+            readProtocolState(in);
+            meshRoutingEnabled = in.readBool();
+            hopCount = static_cast<int>(in.readSigned());
+            return in.ok();
+        }
     };
     
     // BLE Health Sensor - Optimized for wearable devices
@@ -108,8 +138,12 @@ namespace iot {
         bool connectionOriented;
         int connectionInterval;  // ms
         double baselineValue;
-        std::mt19937 rng;
-        std::uniform_real_distribution<double> noiseDistribution;
+        
+    protected:
+        double measure() override {
+            double noise = rng.uniform(-0.05, 0.05) * 10.0;
+            return std::max(minValue, std::min(maxValue, baselineValue + noise));
+        }
         
     public:
         BLEHealthSensor(const std::string& id, const std::string& name)
@@ -117,16 +151,11 @@ namespace iot {
             , ProtocolAwareDevice(NetworkManager::Protocol::BLUETOOTH_LE)
             , connectionOriented(true)
             , connectionInterval(7.5)  // 7.5ms default
-            , baselineValue(72.0)  // Average resting heart rate
-            , rng(std::random_device{}())
-            , noiseDistribution(-0.05, 0.05) {
+            , baselineValue(72.0) {  // Average resting heart rate
         }
         
         double readValue() override {
-            // BLE sensors typically read frequently but transmit less
-            double noise = noiseDistribution(rng) * 10.0;
-            double currentValue = baselineValue + noise;
-            currentValue = std::max(minValue, std::min(maxValue, currentValue));
+            double currentValue = measure();
             
             // BLE sensors typically read frequently but transmit less
             consumeBattery(0.05);  // Very low power for reading
@@ -145,6 +174,19 @@ namespace iot {
         
         void setConnectionOriented(bool oriented) { connectionOriented = oriented; }
         bool isConnectionOriented() const { return connectionOriented; }
+        
+        void writeState(CheckpointWriter& out) const override {
+            Sensor::writeState(out);
+            writeProtocolState(out);
+            out.writeBool(connectionOriented);
+        }
+        
+        bool readState(CheckpointReader& in) override {
+            Sensor::readState(in);
+            readProtocolState(in);
+            connectionOriented = in.readBool();
+            return in.ok();
+        }
     };
     
 } // namespace iot
@@ -3,7 +3,6 @@
 
 #include "../core/IoTDevice.h"
 #include "../core/Message.h"
-#include <random>
 
 namespace iot {
     
@@ -12,8 +11,16 @@ namespace iot {
         double currentValue;
         double minValue;
         double maxValue;
-        std::mt19937 rng;
-        std::uniform_real_distribution<double> noiseDistribution;
+        RandomStream rng;  // measurement noise
+        
+        /**
+         * @brief The reading alone, without charging energy or logging
+         *
+         * Sensors whose readValue() also draws battery override this with
+         * the measurement part; for the others readValue() is already free
+         * of side effects and is used as is.
+         */
+        virtual double measure() { return readValue(); }
         
     public:
         // Make sure this constructor is PUBLIC and properly defined
@@ -27,6 +34,23 @@ namespace iot {
         virtual void sendData();
         virtual void receiveData(const Message& message);
         
+        /**
+         * @brief Take a reading into currentValue without reporting it
+         *
+         * Goes through measure(), so sampling charges no battery and logs
+         * nothing; only readValue() and sendData() model the energy cost.
+         * @return The current value (unchanged if the sensor is inactive)
+         */
+        double sample();
+        
+        /**
+         * @brief Restart the noise stream so readings are reproducible
+         */
+        void setRandomSeed(uint64_t seed) override;
+        
+        void writeState(CheckpointWriter& out) const override;
+        bool readState(CheckpointReader& in) override;
+        
         // Getters
         double getCurrentValue() const { return currentValue; }
         double getMinValue() const { return minValue; }
@@ -0,0 +1,134 @@
+#ifndef IOT_SIMULATION_SENSOR_BANK_H
+#define IOT_SIMULATION_SENSOR_BANK_H
+
+#include "Sensor.h"
+#include "../simulation/SimClock.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iot {
+
+    /**
+     * @brief Structure-of-arrays storage for large numbers of simple sensors
+     *
+     * Temperature, humidity and motion sensors are kept as columns per kind
+     * (baseline, range, current value, RNG counter) instead of one heap
+     * object each. update() refreshes a whole column per tick in a
+     * branch-free loop; noise comes from a counter-based generator, so a
+     * sensor's RNG state is a single 64-bit counter.
+     *
+     * Not internally synchronised: update and reads belong to the
+     * simulation thread, like the per-object sensors.
+     */
+    class SensorBank {
+    public:
+        enum class Kind : uint8_t {
+            TEMPERATURE,
+            HUMIDITY,
+            MOTION
+        };
+
+        static constexpr size_t KIND_COUNT = 3;
+
+        /**
+         * @brief Position of one sensor inside the bank
+         */
+        struct Slot {
+            Kind kind;
+            uint32_t index;
+        };
+
+    private:
+        struct Columns {
+            std::vector<double> baseline;
+            std::vector<double> minValue;
+            std::vector<double> maxValue;
+            std::vector<double> currentValue;
+            std::vector<uint64_t> rngCounter;
+            std::vector<std::string> deviceIds;  // cold, only for exposure
+        };
+
+        Columns columns[KIND_COUNT];
+        uint64_t seed;
+        int hourOfDay;
+
+        Columns& columnsFor(Kind kind) { return columns[static_cast<size_t>(kind)]; }
+        const Columns& columnsFor(Kind kind) const { return columns[static_cast<size_t>(kind)]; }
+
+        void updateTemperature(double hourFactor);
+        void updateHumidity(double timeFactor);
+        void updateMotion(double probability);
+
+    public:
+        /**
+         * @brief Constructor
+         * @param seed Seed for every sensor's noise stream (0 = derive from the global seed)
+         */
+        explicit SensorBank(uint64_t seed = 0);
+
+        /**
+         * @brief Add a sensor with the same defaults as its per-object class
+         */
+        Slot addSensor(Kind kind, const std::string& deviceId);
+
+        /**
+         * @brief Reserve column capacity for a kind
+         */
+        void reserve(Kind kind, size_t count);
+
+        /**
+         * @brief Refresh every sensor for the given hour of day (0-23)
+         */
+        void update(int hour);
+
+        /**
+         * @brief Refresh every sensor for the clock's current hour
+         */
+        void update(const SimClock& clock) { update(clock.getHour()); }
+
+        double getValue(Slot slot) const { return columnsFor(slot.kind).currentValue[slot.index]; }
+        double getMinValue(Slot slot) const { return columnsFor(slot.kind).minValue[slot.index]; }
+        double getMaxValue(Slot slot) const { return columnsFor(slot.kind).maxValue[slot.index]; }
+        const std::string& getDeviceId(Slot slot) const { return columnsFor(slot.kind).deviceIds[slot.index]; }
+
+        /**
+         * @brief Contiguous current values of one kind, for bulk consumers
+         */
+        const std::vector<double>& getValues(Kind kind) const { return columnsFor(kind).currentValue; }
+
+        size_t size(Kind kind) const { return columnsFor(kind).currentValue.size(); }
+        size_t size() const;
+
+        int getHourOfDay() const { return hourOfDay; }
+
+        /**
+         * @brief Wrap one banked sensor as an IoTDevice (e.g. to register it)
+         */
+        static std::shared_ptr<Sensor> exposeSensor(std::shared_ptr<SensorBank> bank, Slot slot,
+                                                    const std::string& name);
+    };
+
+    /**
+     * @brief IoTDevice view of a sensor stored in a SensorBank
+     *
+     * readValue returns the reading from the bank's last update(), so a
+     * view never draws noise of its own.
+     */
+    class BankedSensor : public Sensor {
+    private:
+        std::shared_ptr<SensorBank> bank;
+        SensorBank::Slot slot;
+
+    public:
+        BankedSensor(std::shared_ptr<SensorBank> sensorBank, SensorBank::Slot bankSlot, const std::string& name);
+
+        double readValue() override;
+
+        SensorBank::Slot getSlot() const { return slot; }
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_SENSOR_BANK_H
@@ -0,0 +1,170 @@
+#ifndef IOT_SIMULATION_INGRESS_RING_H
+#define IOT_SIMULATION_INGRESS_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace iot {
+
+    /**
+     * @brief Bounded lock-free multi-producer / single-consumer ring
+     *
+     * Each cell carries a sequence number (Vyukov's bounded queue): a
+     * producer claims a position with one CAS on the enqueue cursor, writes
+     * the value and publishes it by bumping the cell sequence. The single
+     * consumer walks the cells in order, so it never needs a CAS.
+     */
+    template <typename T>
+    class IngressRing {
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            std::optional<T> value;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        size_t mask;
+        alignas(64) std::atomic<size_t> enqueuePos;
+        alignas(64) size_t dequeuePos;  // consumer only
+
+    public:
+        /**
+         * @brief Constructor
+         * @param capacity Number of slots, rounded up to a power of two
+         */
+        explicit IngressRing(size_t capacity = 8192)
+            : enqueuePos(0)
+            , dequeuePos(0) {
+            size_t size = 2;
+            while (size < capacity) size <<= 1;
+
+            cells.reset(new Cell[size]);
+            mask = size - 1;
+            for (size_t i = 0; i < size; ++i) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        IngressRing(const IngressRing&) = delete;
+        IngressRing& operator=(const IngressRing&) = delete;
+
+        size_t capacity() const { return mask + 1; }
+
+        /**
+         * @brief Append a value (any thread)
+         * @return false if the ring is full
+         */
+        bool tryPush(T&& value) {
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            Cell* cell;
+
+            while (true) {
+                cell = &cells[pos & mask];
+                size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;  // consumer has not freed this slot yet
+                } else {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value.emplace(std::move(value));
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Append up to count values with a single claim on the cursor (any thread)
+         *
+         * The consumer frees cells in order, so if the last cell of a run
+         * is free the whole run is. Values are moved from only if pushed.
+         * @return Number of values pushed from the front of the array (0 if full)
+         */
+        size_t tryPushBatch(T* values, size_t count) {
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            size_t claimed = 0;
+
+            while (true) {
+                claimed = std::min(count, capacity());
+                bool stale = false;
+                while (claimed > 0) {
+                    size_t last = pos + claimed - 1;
+                    size_t sequence = cells[last & mask].sequence.load(std::memory_order_acquire);
+                    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(last);
+                    if (diff == 0) break;
+                    if (diff > 0) {
+                        stale = true;  // another producer moved the cursor
+                        break;
+                    }
+                    claimed /= 2;  // run reaches cells the consumer still holds
+                }
+
+                if (stale) {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (claimed == 0) {
+                    return 0;
+                }
+                if (enqueuePos.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+
+            for (size_t i = 0; i < claimed; ++i) {
+                Cell& cell = cells[(pos + i) & mask];
+                cell.value.emplace(std::move(values[i]));
+                cell.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            return claimed;
+        }
+
+        /**
+         * @brief Hand every published value to a consumer (consumer thread only)
+         * @param consume Callable taking T&&
+         * @param limit Maximum number of values to take in this call
+         * @return Number of values consumed
+         */
+        template <typename Consumer>
+        size_t drain(Consumer&& consume, size_t limit = static_cast<size_t>(-1)) {
+            size_t consumed = 0;
+            while (consumed < limit) {
+                Cell* cell = &cells[dequeuePos & mask];
+                size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(dequeuePos + 1) < 0) {
+                    break;
+                }
+
+                consume(std::move(*cell->value));
+                cell->value.reset();
+                cell->sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+                dequeuePos++;
+                consumed++;
+            }
+            return consumed;
+        }
+
+        /**
+         * @brief Check for a published value (consumer thread only)
+         */
+        bool hasPending() const {
+            const Cell* cell = &cells[dequeuePos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            return static_cast<intptr_t>(sequence) - static_cast<intptr_t>(dequeuePos + 1) >= 0;
+        }
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_INGRESS_RING_H
@@ -1,6 +1,7 @@
 #ifndef IOT_SIMULATION_MESH_NETWORK_H
 #define IOT_SIMULATION_MESH_NETWORK_H
 
+#include "../core/DeviceIdTable.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -9,28 +10,35 @@
 
 namespace iot {
     
+    class CheckpointWriter;
+    class CheckpointReader;
+    
     /**
      * @brief Mesh Network Topology Manager
      */
     class MeshNetwork {
     private:
         struct MeshNode {
-            std::string deviceId;
-            std::vector<std::string> neighbors;
+            DeviceHandle handle;
+            std::vector<DeviceHandle> neighbors;
             int hopCountToGateway;
             bool isGateway;
+            bool present = false;
             double signalStrength;
         };
         
-        std::map<std::string, MeshNode> nodes;
-        std::string gatewayId;
+        std::shared_ptr<DeviceIdTable> idTable;
+        std::vector<MeshNode> nodes;  // indexed by handle, see MeshNode::present
+        size_t nodeCount;
+        DeviceHandle gateway;
         int maxHops;
         
     public:
         /**
          * @brief Constructor
+         * @param idTable Interning table to share with DeviceManager (a private one if null)
          */
-        MeshNetwork(int maxHopCount = 10);
+        MeshNetwork(int maxHopCount = 10, std::shared_ptr<DeviceIdTable> idTable = nullptr);
         
         /**
          * @brief Add device to mesh network
@@ -80,7 +88,21 @@ namespace iot {
         /**
          * @brief Get gateway device ID
          */
-        std::string getGateway() const { return gatewayId; }
+        std::string getGateway() const { return idTable->name(gateway); }
+        
+        /**
+         * @brief Connected regions of the mesh
+         *
+         * Devices in different regions have no mesh path between them, so
+         * each region is a natural unit for partitioning a simulation.
+         * @return One list of device handles per region, largest first
+         */
+        std::vector<std::vector<DeviceHandle>> getRegions() const;
+        
+        /**
+         * @brief Interning table used for device handles
+         */
+        const std::shared_ptr<DeviceIdTable>& getIdTable() const { return idTable; }
         
         /**
          * @brief Print mesh network topology
@@ -92,11 +114,31 @@ namespace iot {
          */
         void printStatistics() const;
         
+        /**
+         * @brief Save nodes, links, hop counts and the gateway by handle
+         */
+        void writeCheckpoint(CheckpointWriter& out) const;
+        
+        /**
+         * @brief Rebuild the mesh in one pass from a checkpoint
+         *
+         * Hop counts are restored as saved, so routing is not recomputed.
+         * Handles must match the shared ID table (restore it first).
+         * @return false if the data is malformed or the mesh is not empty
+         */
+        bool readCheckpoint(CheckpointReader& in);
+        
     private:
+        /**
+         * @brief Node for a handle, or null if it is not in the mesh
+         */
+        MeshNode* findNode(DeviceHandle handle);
+        const MeshNode* findNode(DeviceHandle handle) const;
+        
         /**
          * @brief Calculate shortest path using BFS
          */
-        std::vector<std::string> bfsShortestPath(const std::string& start, const std::string& target);
+        std::vector<DeviceHandle> bfsShortestPath(DeviceHandle start, DeviceHandle target) const;
         
         /**
          * @brief Update hop counts for all nodes
@@ -4,16 +4,29 @@
 #include "../core/Message.h"
 #include "../core/DeviceManager.h"
 #include "../security/IPSecManager.h"
+#include "ReceiveWaiter.h"
+#include "IngressRing.h"
+#include "../utils/CounterRng.h"
+#include "../utils/StreamCounters.h"
 #include <queue>
 #include <mutex>
-#include <random>
 #include <thread>
 #include <condition_variable>
 #include <chrono>
 #include <map>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <span>
 
 namespace iot {
     
+    class CheckpointWriter;
+    class CheckpointReader;
+    
+    class ReceiveAwaitable;
+    
     /**
      * @brief Network communication manager
      */
@@ -42,23 +55,103 @@ namespace iot {
         };
         
     private:
+        /**
+         * @brief Heap key for a message waiting for its simulated delay
+         *
+         * The message itself stays in the shard's in-flight slab so heap
+         * operations only shuffle these small keys.
+         */
+        struct PendingDelivery {
+            std::chrono::steady_clock::time_point dueTime;
+            uint64_t sequence;  // tie-break so equal due times stay FIFO
+            uint32_t slot;      // index into DeliveryShard::inFlight
+            
+            // Min-heap ordering: earliest due time on top
+            bool operator>(const PendingDelivery& other) const {
+                if (dueTime == other.dueTime) {
+                    return sequence > other.sequence;
+                }
+                return dueTime > other.dueTime;
+            }
+        };
+        
+        /**
+         * @brief Message handed from a sender to a delivery worker
+         *
+         * A broadcast is one entry per shard: the shared message plus the
+         * recipients that shard owns, rather than one copy per device.
+         */
+        struct IngressEntry {
+            Message message;
+            std::chrono::steady_clock::time_point sentTime;
+            std::shared_ptr<const std::vector<DeviceHandle>> fanOut;  // null for unicast
+            double delayDraw = 0.0;  // uniform in [0, 1) from the sender's link stream
+            
+            size_t recipientCount() const { return fanOut ? fanOut->size() : 1; }
+        };
+        
+        /**
+         * @brief One delivery worker and the slice of traffic it owns
+         *
+         * Messages are assigned to a shard by destination device, so each
+         * device keeps FIFO delivery while different devices are served in
+         * parallel. Senders append to a lock-free ingress ring and only wake
+         * the worker when it is actually asleep. While no worker drains the
+         * ring (before start()), entries that do not fit wait in an
+         * unbounded staging vector, which the worker takes after the ring.
+         * The worker stamps each message with a due time and keeps it in a
+         * min-heap, so in-flight delays overlap instead of being slept one
+         * after another. Counters are per shard atomics, summed on demand.
+         */
+        struct DeliveryShard {
+            IngressRing<IngressEntry> ingress;
+            
+            // Owned by the worker thread
+            std::vector<PendingDelivery> pending;  // heap ordered by due time
+            std::vector<std::optional<IngressEntry>> inFlight;
+            std::vector<uint32_t> freeSlots;
+            std::vector<std::chrono::steady_clock::time_point> lastDueTime;  // indexed by handle / shard count
+            uint64_t nextSequence = 0;
+            std::thread worker;
+            
+            // Wake-up handshake between senders and an idle worker
+            std::mutex wakeMutex;
+            std::condition_variable wakeCondition;
+            std::atomic<bool> sleeping{false};
+            
+            // Ring overflow while stopped; later entries queue behind it until taken
+            std::mutex stagingMutex;
+            std::vector<IngressEntry> staging;
+            std::atomic<bool> staged{false};
+            
+            std::atomic<size_t> queuedEntries{0};  // accepted, not yet delivered or abandoned
+            std::atomic<size_t> messagesSent{0};
+            std::atomic<size_t> messagesReceived{0};
+            std::atomic<size_t> messagesDropped{0};
+            std::atomic<size_t> errors{0};
+        };
+        
         std::shared_ptr<DeviceManager> deviceManager;
         std::shared_ptr<IPSecManager> ipsecManager;
-        std::queue<Message> messageQueue;
-        mutable std::mutex queueMutex;
-        mutable std::mutex statsMutex;
-        std::condition_variable queueCondition;
-        bool running;
-        std::thread processingThread;
-        NetworkStats stats;
-        std::map<std::string, Protocol> deviceProtocols;
+        std::vector<std::unique_ptr<DeliveryShard>> shards;
+        std::atomic<bool> running;
+        std::atomic<std::chrono::steady_clock::rep> statsStartTicks;
+        std::shared_ptr<DeviceIdTable> idTable;
+        mutable std::mutex protocolMutex;
+        std::vector<Protocol> deviceProtocols;  // indexed by device handle
+        
+        // Behaviours suspended in receive(), indexed by device handle
+        std::mutex receiveMutex;
+        std::vector<ReceiveWaiter*> receiveWaiters;
+        std::atomic<size_t> receiveWaiterCount;
         
         // Network failure simulation
         double packetLossRate;
         double networkDelayMin;
         double networkDelayMax;
-        std::mt19937 rng;
-        std::uniform_real_distribution<double> failureDistribution;
+        uint64_t lossSeed;
+        StreamCounters linkCounters;        // per sending device, indexed by handle
+        std::atomic<uint64_t> lossCounter;  // senders without a handle share this stream
         
     public:
       
@@ -73,42 +166,217 @@ namespace iot {
  
         bool sendMessage(const Message& message);
         
+        /**
+         * @brief Send a message the caller no longer needs, without copying it
+         */
+        bool sendMessage(Message&& message);
+        
+        /**
+         * @brief Send many messages with one ingress claim per destination shard
+         *
+         * Accepted messages are moved out of the span, so every element is
+         * left in an unspecified (but destructible and readable) state; the
+         * caller should clear and refill its buffer rather than reuse them.
+         * @return Number of messages accepted (the rest were lost to packet loss)
+         */
+        size_t sendBatch(std::span<Message> messages);
+        
+        /**
+         * @brief Deliver a message to every registered device except its source
+         *
+         * Asynchronous: each shard receives one entry sharing the message
+         * and listing the recipients it owns.
+         */
         void broadcastMessage(const Message& message);
         
+        /**
+         * @brief Set the number of delivery workers (only while stopped)
+         */
+        void setDeliveryWorkers(size_t workers);
+        
+        size_t getDeliveryWorkers() const { return shards.size(); }
+        
+        /**
+         * @brief Reseed packet-loss and delay draws (only while stopped)
+         *
+         * Each sending device has its own counter-based stream, keyed by
+         * the seed and its handle, and a message's loss and delay come from
+         * one draw at send time. A device's n-th message therefore meets
+         * the same conditions however sends from different devices
+         * interleave across threads.
+         */
+        void setRandomSeed(uint64_t seed);
+        
 
         void setDeviceProtocol(const std::string& deviceId, Protocol protocol);
         
 
         Protocol getDeviceProtocol(const std::string& deviceId) const;
+        Protocol getDeviceProtocol(DeviceHandle device) const;
+        
+        /**
+         * @brief Deliver a message on the calling thread, bypassing the delivery workers
+         *
+         * For callers that model the network delay themselves (such as
+         * PartitionedSimulation in virtual time). No loss or delay is
+         * applied; IPsec, statistics and receive() waiters work as usual.
+         * @return true if the destination device accepted the message
+         */
+        bool deliverNow(const Message& message);
+        
+        /**
+         * @brief Apply packet loss to a message the caller will deliver with deliverNow
+         *
+         * A lost message is counted as dropped.
+         * @return false if the message is lost
+         */
+        bool admitMessage(const Message& message);
         
 
         void setNetworkConditions(double packetLoss = 0.0, double delayMin = 0.0, double delayMax = 0.0);
         
+        /**
+         * @brief co_await receive() in a Behavior: wait for the next message to a device
+         * @param device Device to wait on (default: the behaviour's own device)
+         *
+         * ReceiveAwaitable and this function's body belong to the simulation
+         * layer (simulation/Behavior.h), which any coroutine already includes.
+         */
+        ReceiveAwaitable receive(DeviceHandle device = DeviceHandle());
+        
         void setIPSecManager(std::shared_ptr<IPSecManager> ipsec);
         std::shared_ptr<IPSecManager> getIPSecManager() const { return ipsecManager; }
         NetworkStats getStats() const;
         
+        /**
+         * @brief Messages accepted but not yet delivered
+         *
+         * Counts queued entries, so a broadcast counts once per delivery
+         * worker it reaches. Checkpoints cannot hold these (see
+         * SimulationCheckpoint::capture).
+         */
+        size_t getInFlightMessages() const;
+        
 
         void resetStats();
         
+        /**
+         * @brief Save network conditions, loss stream position, device protocols and statistics
+         *
+         * Messages in flight on the delivery workers are not included.
+         */
+        void writeCheckpoint(CheckpointWriter& out) const;
+        
+        /**
+         * @brief Restore what writeCheckpoint saved (only while stopped)
+         * @return false if the data is malformed or the manager is running
+         */
+        bool readCheckpoint(CheckpointReader& in);
+        
 
         void printStats() const;
         
     private:
-
-        void processMessages();
+        friend class ReceiveWaiter;
+        
+        void processMessages(DeliveryShard& shard);
+        
+        /**
+         * @brief Register a waiter on waiter.device
+         * @return false if another behaviour is already waiting on it
+         */
+        bool addReceiveWaiter(ReceiveWaiter& waiter);
+        
+        void removeReceiveWaiter(ReceiveWaiter& waiter);
+        
+        /**
+         * @brief Hand a delivered message to the behaviour waiting on destination, if any
+         */
+        void wakeReceiver(const Message& message, DeviceHandle destination);
         
         /**
-         * @brief Simulate network delay and packet loss
+         * @brief Shard responsible for a destination device
+         */
+        DeliveryShard& shardFor(DeviceHandle destination);
+        
+        /**
+         * @brief Next loss/delay draw from the sender's stream (lock-free)
+         */
+        CounterBlock drawLinkConditions(const Message& message);
+        
+        /**
+         * @brief Simulate packet loss for a draw
          * @return true if message should be delivered, false if dropped
          */
-        bool simulateNetworkConditions();
+        bool simulateNetworkConditions(const CounterBlock& draw) const;
+        
+        /**
+         * @brief Append to a shard's ingress ring and wake its worker if idle
+         *
+         * A full ring holds the sender back while a worker drains it;
+         * otherwise the entry is staged, so nothing is dropped.
+         */
+        void pushIngress(DeliveryShard& shard, IngressEntry&& entry);
+        
+        /**
+         * @brief Append a run of entries, claiming ring slots in bulk
+         */
+        void pushIngressBatch(DeliveryShard& shard, IngressEntry* entries, size_t count);
+        
+        /**
+         * @brief Move entries to the staging vector behind the ring
+         * @return false if a worker is draining the ring and nothing is staged (push there instead)
+         */
+        bool stageEntries(DeliveryShard& shard, IngressEntry* entries, size_t count);
+        
+        /**
+         * @brief Take the staged entries (worker thread only, or while stopped)
+         */
+        std::vector<IngressEntry> takeStaged(DeliveryShard& shard);
+        
+        /**
+         * @brief Wake a shard worker that has gone to sleep
+         */
+        void wakeWorker(DeliveryShard& shard);
+        
+        /**
+         * @brief Stamp a message with its due time and add it to the shard heap
+         * @note Worker thread only (or while stopped)
+         */
+        void enqueuePending(DeliveryShard& shard, IngressEntry&& entry,
+                            std::chrono::steady_clock::time_point dueTime);
+        
+        /**
+         * @brief Remove the earliest pending message from the shard heap
+         * @note Worker thread only (or while stopped)
+         */
+        IngressEntry popPending(DeliveryShard& shard);
+        
+        /**
+         * @brief Re-queue an entry after the shard count changed
+         *
+         * Fan-out lists are split again so each recipient lands on its new shard.
+         */
+        void requeueEntry(IngressEntry&& entry, std::chrono::steady_clock::time_point dueTime, bool pending);
+        
+        /**
+         * @brief Simulated network delay of an entry, from its send-time draw
+         */
+        std::chrono::steady_clock::duration drawNetworkDelay(const IngressEntry& entry) const;
+        
+        /**
+         * @brief Deliver an entry to its destination or every fan-out recipient
+         */
+        void deliverEntry(DeliveryShard& shard, const IngressEntry& entry);
         
         /**
          * @brief Deliver message to destination
+         * @param shard Shard that owns the destination
          * @param message Message to deliver
+         * @param destination Recipient device
+         * @return true if the device accepted the message
          */
-        void deliverMessage(const Message& message);
+        bool deliverMessage(DeliveryShard& shard, const Message& message, DeviceHandle destination);
     };
     
 } // namespace iot
@@ -0,0 +1,217 @@
+#ifndef IOT_SIMULATION_PARTITION_TRANSPORT_H
+#define IOT_SIMULATION_PARTITION_TRANSPORT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iot {
+
+    /**
+     * @brief Framed point-to-point links between the processes of a distributed run
+     *
+     * Every process is an endpoint; frames between two endpoints arrive
+     * whole and in order. Calls never block except wait(), which sleeps
+     * until a frame may have arrived or ring space may have been freed.
+     * Use the eventcount pattern: take a token with prepareWait(), check
+     * for work, and only then wait(token), so a wake-up between the check
+     * and the sleep is not lost.
+     */
+    class PartitionTransport {
+    public:
+        virtual ~PartitionTransport() = default;
+
+        virtual const char* getName() const = 0;
+        virtual size_t getEndpointCount() const = 0;
+        virtual size_t getSelf() const = 0;
+
+        /**
+         * @brief Largest frame that can ever be sent
+         */
+        virtual size_t getMaxFrameSize() const = 0;
+
+        /**
+         * @brief Queue a frame for an endpoint
+         * @return false if there is no room right now (retry after wait)
+         */
+        virtual bool trySend(size_t to, const uint8_t* data, size_t size) = 0;
+
+        /**
+         * @brief Take the next frame from an endpoint
+         * @return false if none has arrived
+         */
+        virtual bool tryReceive(size_t from, std::vector<uint8_t>& frame) = 0;
+
+        virtual uint64_t prepareWait() = 0;
+        virtual void wait(uint64_t token, std::chrono::milliseconds timeout) = 0;
+
+        /**
+         * @brief false once the link to an endpoint is known to be broken
+         */
+        virtual bool isConnected(size_t endpoint) const { (void)endpoint; return true; }
+
+        /**
+         * @brief Push out anything still buffered (before the process exits)
+         */
+        virtual bool flush(std::chrono::milliseconds timeout) { (void)timeout; return true; }
+    };
+
+    /**
+     * @brief Lock-free single-producer/single-consumer rings in one shared mapping
+     *
+     * The region holds a ring for every ordered pair of endpoints and one
+     * doorbell per endpoint. Create it before fork(); each process then
+     * opens its own ShmTransport on it. A ring is a byte stream of
+     * length-prefixed records, 8-byte aligned so a header never wraps;
+     * head and tail are monotonic 64-bit counters on separate cache lines.
+     * Producers ring the consumer's doorbell after publishing and
+     * consumers ring the producer's after freeing space; a process that
+     * runs out of work sleeps on its doorbell with a futex.
+     */
+    class SharedMemoryRegion {
+    public:
+        struct Ring {
+            alignas(64) std::atomic<uint64_t> head;  // consumer position
+            alignas(64) std::atomic<uint64_t> tail;  // producer position
+        };
+
+        struct Doorbell {
+            alignas(64) std::atomic<uint32_t> sequence;
+            std::atomic<uint32_t> sleepers;
+        };
+
+    private:
+        void* base;
+        size_t mappedSize;
+        size_t endpoints;
+        size_t ringCapacity;
+        size_t ringStride;
+        size_t ringsOffset;
+
+    public:
+        /**
+         * @param ringBytes Capacity of each ring (rounded up to a power of two)
+         */
+        SharedMemoryRegion(size_t endpointCount, size_t ringBytes);
+        ~SharedMemoryRegion();
+
+        SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+        SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+        bool isValid() const { return base != nullptr; }
+        size_t getEndpointCount() const { return endpoints; }
+        size_t getRingCapacity() const { return ringCapacity; }
+
+        Doorbell& doorbell(size_t endpoint) const;
+        Ring& ring(size_t from, size_t to) const;
+        uint8_t* ringData(size_t from, size_t to) const;
+    };
+
+    class ShmTransport : public PartitionTransport {
+    private:
+        std::shared_ptr<SharedMemoryRegion> region;
+        size_t self;
+
+        void ring(size_t endpoint);
+
+    public:
+        ShmTransport(std::shared_ptr<SharedMemoryRegion> region, size_t self);
+
+        const char* getName() const override { return "shared-memory rings"; }
+        size_t getEndpointCount() const override { return region->getEndpointCount(); }
+        size_t getSelf() const override { return self; }
+        size_t getMaxFrameSize() const override { return region->getRingCapacity() / 2; }
+
+        bool trySend(size_t to, const uint8_t* data, size_t size) override;
+        bool tryReceive(size_t from, std::vector<uint8_t>& frame) override;
+        uint64_t prepareWait() override;
+        void wait(uint64_t token, std::chrono::milliseconds timeout) override;
+    };
+
+    /**
+     * @brief TCP fallback for runs whose processes do not share memory
+     *
+     * A star: the coordinator listens and every worker connects to it, so
+     * frames between two workers are relayed by the coordinator. Sockets
+     * are non-blocking and outgoing frames are buffered without bound, so
+     * trySend always succeeds; the coordinator endpoint is the last one.
+     */
+    class TcpTransport : public PartitionTransport {
+    private:
+        struct Connection {
+            int socket = -1;
+            std::vector<uint8_t> input;
+            std::vector<uint8_t> output;
+            size_t outputSent = 0;
+            bool open = false;
+        };
+
+        size_t self;
+        size_t endpoints;
+        int listener;
+        uint16_t port;
+        std::vector<Connection> connections;  // coordinator: one per worker; worker: [0] to the coordinator
+        std::vector<std::deque<std::vector<uint8_t>>> inbox;  // per source endpoint
+
+        TcpTransport(size_t self, size_t endpoints);
+
+        size_t coordinator() const { return endpoints - 1; }
+        bool isCoordinator() const { return self == coordinator(); }
+        Connection* connectionTo(size_t endpoint);
+        void enqueue(Connection& connection, size_t to, size_t from, const uint8_t* data, size_t size);
+        void flushConnection(Connection& connection);
+        void readConnection(Connection& connection);
+
+        /**
+         * @brief Read, relay and write whatever the sockets allow without blocking
+         */
+        void service();
+
+    public:
+        ~TcpTransport() override;
+
+        /**
+         * @brief Coordinator side: listen on a port (0 picks a free one)
+         * @param workers Workers that will connect; the coordinator is endpoint `workers`
+         */
+        static std::unique_ptr<TcpTransport> listen(const std::string& address, uint16_t port, size_t workers);
+
+        /**
+         * @brief Coordinator side: wait until every worker has connected and said hello
+         */
+        bool acceptWorkers(std::chrono::milliseconds timeout);
+
+        /**
+         * @brief Worker side: connect to a coordinator as endpoint `worker`
+         */
+        static std::unique_ptr<TcpTransport> connect(const std::string& host, uint16_t port,
+                                                     size_t worker, size_t workers);
+
+        /**
+         * @brief Close the listening socket (a forked worker does not need it)
+         */
+        void closeListener();
+
+        uint16_t getPort() const { return port; }
+
+        const char* getName() const override { return "TCP"; }
+        size_t getEndpointCount() const override { return endpoints; }
+        size_t getSelf() const override { return self; }
+        size_t getMaxFrameSize() const override { return 64u << 20; }
+
+        bool trySend(size_t to, const uint8_t* data, size_t size) override;
+        bool tryReceive(size_t from, std::vector<uint8_t>& frame) override;
+        uint64_t prepareWait() override { return 0; }
+        void wait(uint64_t token, std::chrono::milliseconds timeout) override;
+        bool isConnected(size_t endpoint) const override;
+        bool flush(std::chrono::milliseconds timeout) override;
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_PARTITION_TRANSPORT_H
@@ -0,0 +1,57 @@
+#ifndef IOT_SIMULATION_RECEIVE_WAITER_H
+#define IOT_SIMULATION_RECEIVE_WAITER_H
+
+#include "../core/DeviceHandle.h"
+
+namespace iot {
+
+    class Message;
+    class NetworkManager;
+
+    /**
+     * @brief Entry in the network's receive table: someone waiting for the next message to a device
+     *
+     * The network only tracks which device is awaited and hands the message
+     * over through deliver(). The coroutine side (ReceiveAwaitable) lives in
+     * simulation/Behavior.h, so the network layer does not depend on the engine.
+     */
+    class ReceiveWaiter {
+    protected:
+        friend class NetworkManager;
+
+        NetworkManager* network;
+        DeviceHandle device;
+        bool registered;
+
+        ReceiveWaiter(NetworkManager* owner, DeviceHandle target)
+            : network(owner), device(target), registered(false) {}
+
+        // Not virtual: waiters are never destroyed through this base
+        ~ReceiveWaiter() = default;
+
+        ReceiveWaiter(const ReceiveWaiter&) = delete;
+        ReceiveWaiter& operator=(const ReceiveWaiter&) = delete;
+
+        /**
+         * @brief Join the network's table for device
+         * @return false if another waiter already holds the device
+         */
+        bool enlist();
+
+        /**
+         * @brief Leave the table if still waiting
+         *
+         * Derived classes call this from their own destructor, before the
+         * object they deliver into is torn down.
+         */
+        void withdraw();
+
+        /**
+         * @brief Take the message; called once, under the network's receive lock
+         */
+        virtual void deliver(const Message& delivered) = 0;
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_RECEIVE_WAITER_H
@@ -6,9 +6,13 @@
 #include <memory>
 #include <mutex>
 #include "../core/Message.h"
+#include "../utils/CounterRng.h"
 
 namespace iot {
     
+    class CheckpointWriter;
+    class CheckpointReader;
+    
     /**
      * @brief IPsec Security Association (simulated)
      */
@@ -69,6 +73,7 @@ namespace iot {
         EncryptionAlgorithm defaultEncryption;
         AuthenticationAlgorithm defaultAuthentication;
         bool isEnabled;
+        mutable RandomStream keyRng;  // SPIs and fallback keys (under ipsecMutex)
         
     public:
         /**
@@ -87,6 +92,14 @@ namespace iot {
         void setEnabled(bool enabled);
         bool isEnabledIPSec() const { return isEnabled; }
         
+        /**
+         * @brief Restart the stream generated SPIs and keys come from
+         *
+         * Defaults to one derived from the global seed, so SA names repeat
+         * across runs. Simulated keys are reproducible by design, not secret.
+         */
+        void setRandomSeed(uint64_t seed);
+        
         /**
          * @brief Create a security association
          */
@@ -167,6 +180,21 @@ namespace iot {
          */
         void cleanupExpiredSAs();
         
+        /**
+         * @brief Save settings, security associations and policies
+         *
+         * SA creation and expiry times are stored relative to now, so a
+         * restored SA has the same age and remaining lifetime. The key
+         * stream position is saved too, so later SPIs match the original run.
+         */
+        void writeCheckpoint(CheckpointWriter& out);
+        
+        /**
+         * @brief Replace settings, SAs and policies with a checkpoint's
+         * @return false if the data is malformed (nothing is changed then)
+         */
+        bool readCheckpoint(CheckpointReader& in);
+        
     private:
         /**
          * @brief Find existing SA for communication pair
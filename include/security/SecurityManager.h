@@ -5,6 +5,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include "../utils/CounterRng.h"
 namespace iot {
     
     /**
@@ -32,6 +33,7 @@ namespace iot {
         std::map<std::string, DeviceSecurityInfo> deviceSecurity;
         SecurityLevel defaultSecurityLevel;
         mutable std::mutex securityMutex;  // Protect shared state
+        RandomStream keyRng;               // tokens and keys (under securityMutex)
         
     public:
         /**
@@ -39,6 +41,15 @@ namespace iot {
          */
         SecurityManager(SecurityLevel defaultLevel = SecurityLevel::BASIC);
         std::string getDeviceToken(const std::string& deviceId) const;
+        
+        /**
+         * @brief Restart the stream token suffixes and keys are drawn from
+         *
+         * Defaults to one derived from the global seed. Simulated keys are
+         * reproducible by design, not secret.
+         */
+        void setRandomSeed(uint64_t seed);
+        
         /**
          * @brief Register a device for security
          * @return pair of success boolean and authentication token
@@ -0,0 +1,174 @@
+#ifndef IOT_SIMULATION_BEHAVIOR_H
+#define IOT_SIMULATION_BEHAVIOR_H
+
+#include "../core/DeviceHandle.h"
+#include "../core/Message.h"
+#include "../network/ReceiveWaiter.h"
+#include "../utils/FramePool.h"
+#include "../utils/InlineFunction.h"
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace iot {
+
+    class SimulationEngine;
+
+    /**
+     * @brief Device behaviour script written as a C++20 coroutine
+     *
+     * A function returning Behavior can suspend on the engine's awaitables:
+     *
+     *     Behavior meter(SimulationEngine& sim, NetworkManager& net) {
+     *         while (true) {
+     *             co_await sim.sleep(std::chrono::seconds(30));
+     *             auto reply = co_await net.receive();
+     *         }
+     *     }
+     *
+     * Calling the function only creates the frame (taken from FramePool);
+     * nothing runs until SimulationEngine::spawn hands it to an engine.
+     * Every resume is an ordinary queued event whose callback holds just
+     * the coroutine handle, so a suspended behaviour costs one frame and,
+     * while sleeping, one queue node. No thread is involved.
+     *
+     * The engine owns spawned behaviours: a finished one frees its frame,
+     * and the engine destroys any still suspended when it is destroyed.
+     */
+    class Behavior {
+    public:
+        struct promise_type {
+            SimulationEngine* engine = nullptr;
+            DeviceHandle device;  // device the behaviour acts for (may be invalid)
+
+            // Engine's list of live behaviours, guarded by the engine
+            promise_type* previous = nullptr;
+            promise_type* next = nullptr;
+
+            ~promise_type();
+
+            Behavior get_return_object() {
+                return Behavior(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception();
+
+            static void* operator new(size_t size) { return FramePool::allocate(size); }
+            static void operator delete(void* frame, size_t size) noexcept { FramePool::deallocate(frame, size); }
+        };
+
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Behavior(Behavior&& other) noexcept : coroutine(std::exchange(other.coroutine, nullptr)) {}
+
+        Behavior& operator=(Behavior&& other) noexcept {
+            if (this != &other) {
+                if (coroutine) {
+                    coroutine.destroy();
+                }
+                coroutine = std::exchange(other.coroutine, nullptr);
+            }
+            return *this;
+        }
+
+        Behavior(const Behavior&) = delete;
+        Behavior& operator=(const Behavior&) = delete;
+
+        // A behaviour that was never spawned is simply discarded
+        ~Behavior() {
+            if (coroutine) {
+                coroutine.destroy();
+            }
+        }
+
+        /**
+         * @brief Give up ownership of the frame (used by SimulationEngine::spawn)
+         */
+        Handle release() { return std::exchange(coroutine, nullptr); }
+
+        explicit operator bool() const { return static_cast<bool>(coroutine); }
+
+    private:
+        explicit Behavior(Handle handle) : coroutine(handle) {}
+
+        Handle coroutine;
+    };
+
+    /**
+     * @brief co_await sim.sleep(delay): resume after delay of simulated time
+     */
+    class SleepAwaitable {
+    private:
+        SimulationEngine* engine;
+        std::chrono::milliseconds delay;
+
+    public:
+        SleepAwaitable(SimulationEngine* owner, const std::chrono::milliseconds& sleepFor)
+            : engine(owner), delay(sleepFor) {}
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Behavior::Handle coroutine);
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief co_await sim.until(predicate): resume once predicate holds
+     *
+     * The predicate is checked immediately, then again after every event
+     * the engine executes; it runs on the simulation thread.
+     */
+    class UntilAwaitable {
+    private:
+        friend class SimulationEngine;
+
+        SimulationEngine* engine;
+        InlineFunction<bool(), 48> predicate;
+        Behavior::Handle coroutine;
+
+    public:
+        UntilAwaitable(SimulationEngine* owner, InlineFunction<bool(), 48> condition)
+            : engine(owner), predicate(std::move(condition)) {}
+
+        bool await_ready() { return !predicate || predicate(); }
+        void await_suspend(Behavior::Handle waiting);
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief co_await network.receive(): resume with the next message delivered to a device
+     *
+     * Waits for the behaviour's own device unless another is given. The
+     * device still gets the message through receiveData(); the behaviour
+     * receives a copy and resumes as an event on its engine. Only one
+     * behaviour may wait on a device at a time. The result is empty if
+     * there is no device to wait on or another behaviour is already waiting.
+     */
+    class ReceiveAwaitable : public ReceiveWaiter {
+    private:
+        Behavior::Handle coroutine;
+        std::optional<Message> message;
+
+        /**
+         * @brief Store the message and queue the resume on the behaviour's engine
+         */
+        void deliver(const Message& delivered) override;
+
+    public:
+        ReceiveAwaitable(NetworkManager* owner, DeviceHandle target) : ReceiveWaiter(owner, target) {}
+
+        // Leaves the network's waiter table if the behaviour is destroyed while waiting
+        ~ReceiveAwaitable() { withdraw(); }
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(Behavior::Handle waiting);
+        std::optional<Message> await_resume() { return std::move(message); }
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_BEHAVIOR_H
@@ -0,0 +1,134 @@
+#ifndef IOT_SIMULATION_BRANCH_RUNNER_H
+#define IOT_SIMULATION_BRANCH_RUNNER_H
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace iot {
+
+    /**
+     * @brief What a what-if branch sees: its name and a place to record results
+     */
+    class BranchContext {
+    private:
+        friend class BranchRunner;
+
+        std::string name;
+        size_t index;
+        std::map<std::string, double> metrics;
+
+        BranchContext(const std::string& name, size_t index) : name(name), index(index) {}
+
+    public:
+        const std::string& getName() const { return name; }
+        size_t getIndex() const { return index; }
+
+        /**
+         * @brief Record a result; names must not contain whitespace
+         */
+        void recordMetric(const std::string& metric, double value) { metrics[metric] = value; }
+    };
+
+    /**
+     * @brief Runs what-if variants of a warmed-up simulation in forked processes
+     *
+     * Build the expensive part of a scenario once (device registration,
+     * mesh construction, IPsec security associations), then add branches
+     * and call runAll. Each branch runs in a child process created with
+     * fork(), so it starts from a copy-on-write image of the warmed state in
+     * about the time it takes to copy the page tables. A branch can change
+     * anything (packet loss, failed gateways, new firmware) without
+     * affecting the parent or other branches, and can start its own
+     * SimulationEngine or network threads.
+     *
+     * Only the calling thread exists in a child, so fork while the warmed
+     * simulation is quiescent: engine stopped, network manager stopped and
+     * no worker pools active. runAll warns if other threads are alive.
+     *
+     * A branch's stdout and stderr go to <directory>/<name>.log and its
+     * metrics to <directory>/<name>.result, one "metric value" line each,
+     * which the parent reads back once the child exits.
+     */
+    class BranchRunner {
+    public:
+        /**
+         * @brief Body of a branch, run in the child process
+         * @return true if the branch succeeded
+         */
+        using BranchFunction = std::function<bool(BranchContext&)>;
+
+        struct BranchResult {
+            std::string name;
+            bool succeeded;       // exited with status 0
+            int exitCode;         // -1 if the child was killed by a signal
+            int signal;           // terminating signal, or 0
+            std::string resultFile;
+            std::string logFile;
+            std::map<std::string, double> metrics;
+            double startupMs;     // fork() to the branch body starting, measured in the child
+            std::chrono::steady_clock::duration wallTime;  // fork() to the child being reaped
+        };
+
+    private:
+        struct Branch {
+            std::string name;
+            BranchFunction body;
+        };
+
+        std::string directory;
+        std::vector<Branch> branches;
+        size_t maxConcurrent;
+        std::vector<BranchResult> results;
+
+    public:
+        /**
+         * @param resultDirectory Where branch logs and result files are written (created if missing)
+         */
+        explicit BranchRunner(const std::string& resultDirectory);
+
+        /**
+         * @brief Add a branch (names must be unique and usable as file names)
+         * @return false if the name is empty or already used
+         */
+        bool addBranch(const std::string& name, BranchFunction body);
+
+        size_t getBranchCount() const { return branches.size(); }
+
+        /**
+         * @brief Children alive at once (0 = hardware concurrency)
+         */
+        void setMaxConcurrent(size_t branchesAtOnce);
+
+        /**
+         * @brief Fork every branch, wait for all of them and collect their results
+         * @return true if every branch succeeded
+         */
+        bool runAll();
+
+        /**
+         * @brief Results of the last runAll, in the order branches were added
+         */
+        const std::vector<BranchResult>& getResults() const { return results; }
+
+        void printResults() const;
+
+    private:
+        /**
+         * @brief Child side: redirect output, run the body, write results and _exit
+         */
+        [[noreturn]] void runChild(size_t index, std::chrono::steady_clock::time_point forkTime) const;
+
+        static bool readResultFile(const std::string& path, std::map<std::string, double>& metrics);
+
+        /**
+         * @brief Threads alive in this process (1 if it cannot be determined)
+         */
+        static size_t countThreads();
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_BRANCH_RUNNER_H
@@ -0,0 +1,244 @@
+#ifndef IOT_SIMULATION_DISTRIBUTED_SIMULATION_H
+#define IOT_SIMULATION_DISTRIBUTED_SIMULATION_H
+
+#include "SimulationEngine.h"
+#include "../network/PartitionTransport.h"
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace iot {
+
+    class DistributedSimulation;
+
+    /**
+     * @brief One worker process of a distributed run: its devices, network and engine
+     *
+     * Handed to the scenario builder inside the worker. The builder adds
+     * only the devices this partition owns and schedules their work on
+     * getEngine(). Devices talk to each other through sendMessage, which
+     * routes to the owning process.
+     */
+    class DistributedPartition {
+        friend class DistributedSimulation;
+
+    public:
+        using PlacementFunction = std::function<size_t(const std::string& deviceId, size_t partitions)>;
+
+    private:
+        struct CrossMessage {
+            std::chrono::steady_clock::duration arrival;  // offset from the run origin
+            Message message;
+        };
+
+        size_t index;
+        size_t partitionCount;
+        PlacementFunction placement;
+        std::shared_ptr<DeviceManager> deviceManager;
+        std::shared_ptr<NetworkManager> networkManager;
+        std::unique_ptr<SimulationEngine> engine;
+        std::chrono::steady_clock::time_point origin;
+        std::vector<std::vector<CrossMessage>> outboxes;  // per destination partition
+        std::vector<std::optional<Message>> inbox;         // in-flight messages bound here
+        std::vector<uint32_t> freeInbox;
+        std::map<std::string, double> metrics;
+        size_t messagesSent;
+        size_t crossPartitionSent;
+
+        DistributedPartition(size_t index, size_t partitionCount, PlacementFunction placement);
+
+        /**
+         * @brief Schedule a delivery on this partition's engine
+         */
+        void postDelivery(std::chrono::steady_clock::duration arrival, Message&& message);
+
+    public:
+        size_t getIndex() const { return index; }
+        size_t getPartitionCount() const { return partitionCount; }
+
+        std::shared_ptr<DeviceManager> getDeviceManager() const { return deviceManager; }
+        std::shared_ptr<NetworkManager> getNetworkManager() const { return networkManager; }
+        SimulationEngine& getEngine() { return *engine; }
+
+        /**
+         * @brief Engine time of simulated offset zero
+         */
+        std::chrono::steady_clock::time_point getOrigin() const { return origin; }
+
+        size_t partitionOf(const std::string& deviceId) const;
+        bool owns(const std::string& deviceId) const { return partitionOf(deviceId) == index; }
+
+        /**
+         * @brief Register a device if this partition owns it
+         *
+         * The ID is interned either way. Builders that add every device of
+         * the scenario, in the same order, get the same handles in every
+         * process, so handle-keyed random streams do not depend on the
+         * number of processes.
+         * @param create Called only for owned devices
+         * @return true if the device now lives in this partition
+         */
+        bool addDevice(const std::string& deviceId, const std::function<std::shared_ptr<IoTDevice>()>& create);
+
+        /**
+         * @brief Send a message from one of this partition's devices
+         *
+         * It arrives after the source device's protocol latency. Messages
+         * to other partitions leave at the end of the current window.
+         * @return false if the source is not a device of this partition
+         */
+        bool sendMessage(Message message);
+
+        /**
+         * @brief Add to a named result; the coordinator sums it over partitions
+         */
+        void recordMetric(const std::string& name, double value) { metrics[name] += value; }
+    };
+
+    /**
+     * @brief Conservative simulation spread over worker processes
+     *
+     * The device population is partitioned across worker processes, each
+     * with its own DeviceManager, NetworkManager and virtual-time engine,
+     * built by the same scenario function. The calling process becomes
+     * the coordinator. It runs the window protocol of PartitionedSimulation
+     * across processes: workers report their earliest pending event, the
+     * coordinator broadcasts the end of the next window (LBTS + lookahead),
+     * workers run it, exchange cross-partition messages directly and
+     * report again. The lookahead is the smallest protocol latency of any
+     * device. At the end every worker sends its statistics and metrics,
+     * which the coordinator aggregates.
+     *
+     * Local runs fork their workers and connect them with lock-free
+     * shared-memory rings. The TCP transport relays through the coordinator
+     * instead and also accepts workers on other hosts (runWorker). Each
+     * worker writes its output to <logDirectory>/worker_<i>.log.
+     */
+    class DistributedSimulation {
+    public:
+        using ScenarioBuilder = std::function<void(DistributedPartition&)>;
+
+        enum class Transport {
+            SHARED_MEMORY,
+            TCP
+        };
+
+        struct PartitionStats {
+            size_t devices;
+            size_t eventsExecuted;
+            size_t messagesSent;          // sent by this partition's devices
+            size_t crossPartitionSent;    // of which left the partition
+            size_t crossPartitionReceived;
+            size_t lookaheadViolations;
+            std::chrono::steady_clock::duration busyTime;  // running events
+            std::chrono::steady_clock::duration syncTime;  // exchanging and waiting for windows
+        };
+
+    private:
+        size_t processes;
+        ScenarioBuilder builder;
+        std::string logDirectory;
+        DistributedPartition::PlacementFunction placement;
+        Transport transport;
+        std::string tcpAddress;
+        uint16_t tcpPort;
+        bool spawnWorkers;
+        size_t ringBytes;
+
+        std::vector<PartitionStats> stats;
+        std::map<std::string, double> metrics;
+        std::chrono::steady_clock::duration lookahead;
+        std::chrono::steady_clock::duration elapsed;
+        std::chrono::steady_clock::duration wallTime;
+        size_t windows;
+
+    public:
+        /**
+         * @param processCount Worker processes (partitions)
+         * @param scenario Builds one partition inside its worker
+         */
+        DistributedSimulation(size_t processCount, ScenarioBuilder scenario, const std::string& logDirectory);
+
+        size_t getProcessCount() const { return processes; }
+
+        /**
+         * @brief Choose which partition owns a device (default: hash of the ID)
+         */
+        void setPlacement(DistributedPartition::PlacementFunction function);
+
+        void useSharedMemory(size_t ringBytesPerLink = 1 << 20);
+
+        /**
+         * @brief Connect workers over TCP through the coordinator
+         * @param port 0 picks a free port (local workers only)
+         * @param spawnLocalWorkers false to wait for workers started elsewhere with runWorker
+         */
+        void useTcp(const std::string& address = "127.0.0.1", uint16_t port = 0, bool spawnLocalWorkers = true);
+
+        Transport getTransport() const { return transport; }
+
+        /**
+         * @brief Build the scenario in every worker and run it for duration of simulated time
+         * @return false if a worker failed or the run could not be coordinated
+         */
+        bool run(const std::chrono::milliseconds& duration);
+
+        /**
+         * @brief Serve as worker `index` of a coordinator on another host
+         *
+         * This process must have the same scenario and placement as the
+         * coordinator.
+         */
+        bool runWorker(const std::string& host, uint16_t port, size_t index);
+
+        const PartitionStats& getPartitionStats(size_t partition) const { return stats[partition]; }
+
+        /**
+         * @brief A metric recorded by the scenario, summed over partitions (0 if never recorded)
+         */
+        double getMetric(const std::string& name) const;
+        const std::map<std::string, double>& getMetrics() const { return metrics; }
+
+        std::chrono::steady_clock::duration getLookahead() const { return lookahead; }
+        std::chrono::steady_clock::duration getElapsed() const { return elapsed; }
+        size_t getWindowCount() const { return windows; }
+
+        /**
+         * @brief Wall-clock time of the last run, from fork to the last report
+         */
+        std::chrono::steady_clock::duration getWallTime() const { return wallTime; }
+
+        void printStats() const;
+
+        /**
+         * @brief Default placement: a stable hash of the device ID
+         */
+        static size_t hashPlacement(const std::string& deviceId, size_t partitions);
+
+    private:
+        /**
+         * @brief Build partition `index` and follow the coordinator's windows until told to stop
+         * @param alive Checked while waiting; false once the coordinator is gone
+         */
+        bool runPartition(PartitionTransport& link, size_t index, const std::function<bool()>& alive);
+
+        /**
+         * @brief Drive the window protocol and collect the workers' final reports
+         * @param alive Checked while waiting; false once a worker is gone
+         */
+        bool coordinate(PartitionTransport& link, std::chrono::steady_clock::duration duration,
+                        const std::function<bool()>& alive);
+
+        /**
+         * @brief Run a forked worker to completion and exit the process
+         */
+        [[noreturn]] void runChild(size_t index, const std::function<std::unique_ptr<PartitionTransport>()>& connect);
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_DISTRIBUTED_SIMULATION_H
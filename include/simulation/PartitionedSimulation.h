@@ -0,0 +1,189 @@
+#ifndef IOT_SIMULATION_PARTITIONED_SIMULATION_H
+#define IOT_SIMULATION_PARTITIONED_SIMULATION_H
+
+#include "SimulationEngine.h"
+#include "../network/MeshNetwork.h"
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace iot {
+
+    /**
+     * @brief Conservative parallel discrete-event simulation over device partitions
+     *
+     * Devices are split into logical processes (LPs). Each LP is a
+     * virtual-time SimulationEngine with its own event queue, run by its
+     * own thread. LPs advance in lockstep time windows. The lookahead is
+     * the smallest protocol latency of any partitioned device, taken from
+     * ProtocolCharacteristics::latencyMs. A message sent at time t arrives
+     * at t + latency, which is never earlier than t + lookahead.
+     *
+     * Each window starts at the lower bound on timestamps (LBTS), the
+     * earliest event pending in any LP. It ends just before
+     * LBTS + lookahead, so nothing sent during the window can land inside
+     * it. All LPs process the window independently. At the barrier,
+     * cross-partition messages are posted to their destination LP in
+     * source-partition order, and the next LBTS is computed. Idle stretches
+     * of simulated time are skipped, not stepped through.
+     *
+     * Device work is scheduled on the device's own engine (engineFor). It
+     * must only touch devices of the same partition and communicate through
+     * sendMessage. Messages are delivered with NetworkManager::deliverNow on
+     * the destination's LP thread.
+     */
+    class PartitionedSimulation {
+    public:
+        static constexpr uint32_t NO_PARTITION = 0xFFFFFFFF;
+
+        struct PartitionStats {
+            size_t devices;
+            size_t eventsExecuted;
+            size_t messagesSent;       // sent by this partition's devices
+            size_t crossPartitionSent; // of which left the partition
+        };
+
+    private:
+        struct CrossMessage {
+            std::chrono::steady_clock::duration arrival;  // offset from the run origin
+            uint32_t destinationPartition;
+            Message message;
+        };
+
+        /**
+         * @brief One logical process: engine, clock origin and message buffers
+         */
+        struct Partition {
+            std::unique_ptr<SimulationEngine> engine;
+            std::chrono::steady_clock::time_point origin;  // engine time of offset zero
+            std::vector<CrossMessage> outbox;              // owned by the partition thread
+            std::vector<std::optional<Message>> inbox;     // in-flight messages bound here
+            std::vector<uint32_t> freeInbox;
+            size_t devices = 0;
+            size_t eventsExecuted = 0;
+            size_t messagesSent = 0;
+            size_t crossPartitionSent = 0;
+        };
+
+        std::shared_ptr<DeviceManager> deviceManager;
+        std::shared_ptr<NetworkManager> networkManager;
+        std::vector<std::unique_ptr<Partition>> partitions;
+        std::vector<uint32_t> partitionOf;                     // indexed by device handle
+        std::vector<std::chrono::steady_clock::duration> deviceLatency;  // indexed by device handle
+        std::chrono::steady_clock::duration lookahead;
+        std::chrono::steady_clock::duration lookaheadOverride;
+        std::chrono::steady_clock::duration elapsed;           // simulated time run so far
+        size_t windows;
+        size_t lookaheadViolations;
+        std::chrono::steady_clock::duration wallTime;
+
+    public:
+        /**
+         * @param partitionCount Logical processes (and threads) to run
+         */
+        PartitionedSimulation(std::shared_ptr<DeviceManager> dm, std::shared_ptr<NetworkManager> nm,
+                              size_t partitionCount);
+
+        ~PartitionedSimulation();
+
+        PartitionedSimulation(const PartitionedSimulation&) = delete;
+        PartitionedSimulation& operator=(const PartitionedSimulation&) = delete;
+
+        size_t getPartitionCount() const { return partitions.size(); }
+
+        /**
+         * @brief Place a device in a partition (before running)
+         */
+        void assignPartition(DeviceHandle device, size_t partition);
+
+        /**
+         * @brief Place whole mesh regions in partitions, balancing device counts
+         *
+         * Regions go largest first to the least loaded partition, so a
+         * region is never split and mesh traffic stays inside one LP.
+         * @return Number of regions placed
+         */
+        size_t partitionByRegion(const MeshNetwork& mesh);
+
+        /**
+         * @brief Partition of a device (unassigned devices are spread by handle)
+         */
+        size_t getPartition(DeviceHandle device) const;
+
+        /**
+         * @brief Engine that runs a device's events
+         */
+        SimulationEngine& engineFor(DeviceHandle device);
+
+        SimulationEngine& getEngine(size_t partition) { return *partitions[partition]->engine; }
+
+        /**
+         * @brief Send a message from inside an event of the source device's partition
+         *
+         * It arrives after the source device's protocol latency, on the
+         * destination's LP. Same-partition messages are queued directly;
+         * others wait for the next window barrier.
+         * @return false if the source or destination device is unknown
+         */
+        bool sendMessage(Message message);
+
+        /**
+         * @brief Force the lookahead (zero = derive it from protocol latencies)
+         *
+         * A lookahead larger than an actual latency is unsafe; such
+         * messages are delayed to the next window and counted.
+         */
+        void setLookahead(const std::chrono::milliseconds& window);
+
+        std::chrono::steady_clock::duration getLookahead() const { return lookahead; }
+
+        /**
+         * @brief Advance every partition by duration of simulated time
+         * @return Number of events executed across all partitions
+         */
+        size_t runFor(const std::chrono::milliseconds& duration);
+
+        /**
+         * @brief Simulated time run so far
+         */
+        std::chrono::steady_clock::duration getElapsed() const { return elapsed; }
+
+        PartitionStats getPartitionStats(size_t partition) const;
+        size_t getWindowCount() const { return windows; }
+        size_t getLookaheadViolations() const { return lookaheadViolations; }
+
+        /**
+         * @brief Wall-clock time spent inside runFor
+         */
+        std::chrono::steady_clock::duration getWallTime() const { return wallTime; }
+
+        void printStats() const;
+
+    private:
+        /**
+         * @brief Recompute per-device latencies and the lookahead from current protocols
+         */
+        void refreshLatencies();
+
+        /**
+         * @brief Earliest pending event across partitions, as an offset
+         * @return false if every queue is empty
+         */
+        bool lowerBoundOnTimestamps(std::chrono::steady_clock::duration& bound);
+
+        /**
+         * @brief Post every buffered cross-partition message to its destination (at the barrier)
+         */
+        void exchangeMessages(std::chrono::steady_clock::duration windowEnd);
+
+        /**
+         * @brief Queue a message for delivery on a partition at an offset
+         */
+        void postDelivery(Partition& destination, std::chrono::steady_clock::duration arrival,
+                          Message&& message);
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_PARTITIONED_SIMULATION_H
@@ -0,0 +1,171 @@
+#ifndef IOT_SIMULATION_REPLICA_RUNNER_H
+#define IOT_SIMULATION_REPLICA_RUNNER_H
+
+#include "SimulationEngine.h"
+#include "../core/DeviceManager.h"
+#include "../network/NetworkManager.h"
+#include "../utils/CounterRng.h"
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace iot {
+
+    /**
+     * @brief One Monte Carlo replica: a private device/network/engine stack
+     *
+     * The engine runs in virtual time on the replica's thread. Messages
+     * sent with sendMessage pass the network's packet-loss draw, then
+     * arrive after the source device's protocol latency as an engine
+     * event, so a replica never starts network threads and its results
+     * depend only on its seed. The simulated day starts at midnight.
+     */
+    class Replica {
+    private:
+        size_t index;
+        uint64_t seed;
+        std::map<std::string, double> metrics;
+
+    public:
+        std::shared_ptr<DeviceManager> deviceManager;
+        std::shared_ptr<NetworkManager> networkManager;
+        std::unique_ptr<SimulationEngine> engine;
+
+        Replica(size_t index, uint64_t seed);
+
+        Replica(const Replica&) = delete;
+        Replica& operator=(const Replica&) = delete;
+
+        size_t getIndex() const { return index; }
+        uint64_t getSeed() const { return seed; }
+
+        /**
+         * @brief Seed of an independent random stream (for example one per device)
+         */
+        uint64_t streamSeed(uint64_t stream) const { return mixBits(seed ^ mixBits(stream)); }
+
+        /**
+         * @brief Send a message in simulated time (call from an engine event)
+         * @return false if the message was lost or a device is unknown
+         */
+        bool sendMessage(Message message);
+
+        /**
+         * @brief Record a scenario-specific result, summarised across replicas by name
+         */
+        void recordMetric(const std::string& name, double value) { metrics[name] = value; }
+
+        const std::map<std::string, double>& getMetrics() const { return metrics; }
+    };
+
+    /**
+     * @brief Runs N independent replicas of one scenario and summarises the results
+     *
+     * Every replica builds its own DeviceManager, NetworkManager and
+     * SimulationEngine from a shared, read-only scenario definition. Replica
+     * i gets the seed mixBits(baseSeed ^ mixBits(i)), which seeds the network
+     * loss draws, the engine's timer jitter and the device manager, whose
+     * devices draw from one stream per handle and purpose. Replicas run
+     * concurrently, one per task, on a WorkStealingPool.
+     *
+     * After each run the network statistics and the battery levels of all
+     * battery-powered devices are recorded as metrics next to the
+     * scenario's own, and every metric is summarised as mean, standard
+     * deviation, range and 95% confidence interval.
+     */
+    class ReplicaRunner {
+    public:
+        /**
+         * @brief Builds devices and schedules events on a fresh replica
+         *
+         * Called concurrently from several threads, so it must only read
+         * shared state.
+         */
+        using ScenarioBuilder = std::function<void(Replica&)>;
+
+        struct MetricSummary {
+            size_t count;
+            double mean;
+            double stddev;  // sample standard deviation
+            double min;
+            double max;
+            double ci95;    // half-width of the 95% confidence interval of the mean
+        };
+
+    private:
+        ScenarioBuilder scenario;
+        size_t replicaCount;
+        uint64_t baseSeed;
+        size_t threadCount;
+        std::vector<std::map<std::string, double>> results;  // indexed by replica
+        std::chrono::steady_clock::duration wallTime;
+
+    public:
+        /**
+         * @param scenario Shared scenario definition
+         * @param replicaCount Number of independent replicas to run
+         */
+        ReplicaRunner(ScenarioBuilder scenario, size_t replicaCount);
+
+        void setBaseSeed(uint64_t seed) { baseSeed = seed; }
+        uint64_t getBaseSeed() const { return baseSeed; }
+
+        /**
+         * @brief Threads running replicas, including the caller (0 = hardware concurrency)
+         */
+        void setThreadCount(size_t threads) { threadCount = threads; }
+
+        size_t getReplicaCount() const { return replicaCount; }
+
+        /**
+         * @brief Seed given to a replica
+         */
+        uint64_t replicaSeed(size_t replica) const { return mixBits(baseSeed ^ mixBits(replica)); }
+
+        /**
+         * @brief Build and run every replica for duration of simulated time
+         * @return Total events executed across replicas
+         */
+        size_t run(const std::chrono::milliseconds& duration);
+
+        /**
+         * @brief Metrics of each replica from the last run
+         */
+        const std::vector<std::map<std::string, double>>& getResults() const { return results; }
+
+        /**
+         * @brief Summary of every metric over the replicas that recorded it
+         */
+        std::map<std::string, MetricSummary> summarize() const;
+
+        /**
+         * @brief Summary statistics of a sample
+         */
+        static MetricSummary summarize(const std::vector<double>& values);
+
+        /**
+         * @brief Wall-clock time of the last run
+         */
+        std::chrono::steady_clock::duration getWallTime() const { return wallTime; }
+
+        void printSummary() const;
+
+    private:
+        /**
+         * @brief Build, run and measure one replica
+         */
+        size_t runReplica(size_t index, const std::chrono::milliseconds& duration,
+                          std::map<std::string, double>& metrics) const;
+
+        /**
+         * @brief Record network statistics and battery levels as metrics
+         */
+        static void recordStandardMetrics(Replica& replica, const std::chrono::milliseconds& duration);
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_REPLICA_RUNNER_H
@@ -0,0 +1,104 @@
+#ifndef IOT_SIMULATION_SIM_CLOCK_H
+#define IOT_SIMULATION_SIM_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace iot {
+
+    /**
+     * @brief Simulated time of day shared by every device
+     *
+     * SimulationEngine advances the clock with the simulated time elapsed
+     * (virtual time, or wall time scaled by the simulation speed). The hour
+     * and the diurnal factors sensors use are recomputed only when the hour
+     * changes, so a reading is a couple of relaxed atomic loads instead of
+     * a localtime call.
+     */
+    class SimClock {
+    private:
+        std::chrono::seconds originTimeOfDay;  // local time of day at elapsed == 0
+        std::atomic<int> hour;
+        std::atomic<double> temperatureFactor;
+        std::atomic<double> humidityFactor;
+        std::atomic<std::chrono::steady_clock::rep> elapsedTicks;
+        bool followsWallTime;
+        mutable std::atomic<std::chrono::steady_clock::rep> nextWallRefresh;
+
+        void setHour(int newHour);
+        void refreshFromWallTime() const;
+
+    public:
+        /**
+         * @brief Constructor; the simulated day starts at the current local time
+         */
+        SimClock();
+
+        /**
+         * @brief Start the simulated day at a fixed time (hours, 0-24)
+         */
+        void setTimeOfDay(double hours);
+        void setTimeOfDay(std::chrono::seconds timeOfDay);
+
+        /**
+         * @brief Time of day at which the simulated day started
+         */
+        std::chrono::seconds getStartTimeOfDay() const { return originTimeOfDay; }
+
+        /**
+         * @brief Move to a new simulated elapsed time (engine thread)
+         */
+        void advanceTo(std::chrono::steady_clock::duration simulatedElapsed);
+
+        /**
+         * @brief Simulated time since the clock was anchored
+         */
+        std::chrono::steady_clock::duration getElapsed() const {
+            return std::chrono::steady_clock::duration(elapsedTicks.load(std::memory_order_relaxed));
+        }
+
+        /**
+         * @brief Hour of the simulated day (0-23)
+         */
+        int getHour() const {
+            if (followsWallTime) refreshFromWallTime();
+            return hour.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Daily temperature swing: sin((hour - 6) * pi / 12) * 2
+         */
+        double getTemperatureFactor() const {
+            if (followsWallTime) refreshFromWallTime();
+            return temperatureFactor.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Daily humidity swing: cos((hour - 6) * pi / 12) * 5
+         */
+        double getHumidityFactor() const {
+            if (followsWallTime) refreshFromWallTime();
+            return humidityFactor.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Daytime hours (08:00-22:59) for activity patterns
+         */
+        bool isDaytime() const {
+            int current = getHour();
+            return current >= 8 && current <= 22;
+        }
+
+        /**
+         * @brief Process-wide clock that tracks local wall time
+         *
+         * Used by devices not attached to a SimulationEngine. It re-reads
+         * the wall clock at most once a second.
+         */
+        static std::shared_ptr<const SimClock> wallClock();
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_SIM_CLOCK_H
@@ -0,0 +1,217 @@
+#ifndef IOT_SIMULATION_SIMULATION_CHECKPOINT_H
+#define IOT_SIMULATION_SIMULATION_CHECKPOINT_H
+
+#include "SimulationEngine.h"
+#include "../network/MeshNetwork.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <typeindex>
+#include <vector>
+
+namespace iot {
+
+    /**
+     * @brief Saves and restores a whole simulation as a compact binary file
+     *
+     * A checkpoint holds the device ID table, every device whose kind is
+     * registered (identity plus its writeState record, which includes the
+     * positions of its random streams) with the device manager's seed, the
+     * network manager's conditions, link streams, protocols and statistics,
+     * the mesh topology, IPsec security associations and policies, and the
+     * engine clock with every pending event. Pending events must all have
+     * IDs: message deliveries in flight, behaviour resumes and running
+     * behaviours cannot be rebuilt, so capture refuses rather than
+     * silently losing them.
+     *
+     * Saving is split in two so the simulation only stops to encode: the
+     * image is built in memory on the simulation thread (capture, a full
+     * encode whose length getLastCapturePause reports), then a
+     * background thread writes it in chunks to a temporary file, syncs it
+     * and renames it over the target, so a crash mid-write leaves the
+     * previous checkpoint intact. scheduleCheckpoints does this
+     * periodically from an engine timer, capturing at a quiescent point.
+     *
+     * Restoring memory-maps the file, verifies its header and checksum,
+     * and rebuilds the device array in one bulk registration. Restore into
+     * freshly constructed components: the device manager must be empty.
+     * Event callbacks cannot be saved, so the caller rebinds them by ID.
+     *
+     * File layout: a 32-byte header (magic "IOTSNAP", format version,
+     * section count, payload length, payload checksum) followed by tagged,
+     * length-prefixed sections. Readers skip sections they do not know, so
+     * later versions can add sections without breaking older files.
+     */
+    class SimulationCheckpoint {
+    public:
+        /**
+         * @brief Creates an empty device of one kind, to be filled by readState
+         */
+        using DeviceFactory = std::function<std::shared_ptr<IoTDevice>(const std::string& id,
+                                                                      const std::string& name)>;
+
+        static constexpr uint32_t FORMAT_VERSION = 2;
+        static constexpr size_t HEADER_SIZE = 32;
+
+        /**
+         * @brief ID of the timer created by scheduleCheckpoints (never restored)
+         */
+        static constexpr const char* TIMER_ID = "CHECKPOINT";
+
+        struct RestoreReport {
+            size_t devices;          // devices rebuilt and registered
+            size_t skippedDevices;   // records of kinds not registered here
+            size_t events;           // pending events queued again
+            size_t droppedEvents;    // events the rebinder returned no callback for
+            std::chrono::steady_clock::duration loadTime;
+        };
+
+    private:
+        std::shared_ptr<DeviceManager> deviceManager;
+        std::shared_ptr<NetworkManager> networkManager;
+        SimulationEngine& engine;
+        std::shared_ptr<MeshNetwork> meshNetwork;
+
+        std::map<std::type_index, std::string> kindNames;
+        std::map<std::string, DeviceFactory> factories;
+
+        // Background writer: one file at a time
+        std::thread writer;
+        std::atomic<bool> writing;
+        std::atomic<bool> lastWriteSucceeded;
+        std::atomic<size_t> checkpointsWritten;
+
+        std::chrono::steady_clock::duration lastCapturePause;
+        size_t unsavedDevices;
+        size_t refusedCaptures;
+        RestoreReport lastRestore;
+
+    public:
+        /**
+         * @brief Built-in device kinds are registered already
+         */
+        SimulationCheckpoint(std::shared_ptr<DeviceManager> dm, std::shared_ptr<NetworkManager> nm,
+                             SimulationEngine& engine);
+
+        /**
+         * @brief Waits for a write still in progress
+         */
+        ~SimulationCheckpoint();
+
+        SimulationCheckpoint(const SimulationCheckpoint&) = delete;
+        SimulationCheckpoint& operator=(const SimulationCheckpoint&) = delete;
+
+        /**
+         * @brief Include a mesh topology in checkpoints (it must share the device ID table)
+         */
+        void setMeshNetwork(std::shared_ptr<MeshNetwork> mesh) { meshNetwork = std::move(mesh); }
+
+        /**
+         * @brief Let devices of a custom class be saved and rebuilt
+         * @param kind Name stored in the file; keep it stable across versions
+         */
+        void registerDeviceKind(const std::string& kind, std::type_index type, DeviceFactory factory);
+
+        /**
+         * @brief Register a device class constructible from (id, name)
+         */
+        template <typename Device>
+        void registerDeviceKind(const std::string& kind) {
+            registerDeviceKind(kind, typeid(Device), [](const std::string& id, const std::string& name) {
+                return std::make_shared<Device>(id, name);
+            });
+        }
+
+        /**
+         * @brief Encode the current state into a complete checkpoint image
+         *
+         * Call while the engine is stopped, or from the simulation thread at
+         * a quiescent point (SimulationEngine::atQuiescentPoint).
+         * @return The image, or an empty vector if pending events without an
+         *         ID, running behaviours or messages in flight would be lost
+         */
+        std::vector<uint8_t> capture();
+
+        /**
+         * @brief Capture and write synchronously
+         * @return false if the capture was refused or the write failed
+         */
+        bool save(const std::string& path);
+
+        /**
+         * @brief Capture now and write on a background thread
+         * @return false if the previous checkpoint is still being written or
+         *         the capture was refused (nothing is written)
+         */
+        bool saveAsync(const std::string& path);
+
+        /**
+         * @brief Wait for a background write
+         * @return true if the last write succeeded
+         */
+        bool waitForWrite();
+
+        bool isWriting() const { return writing.load(); }
+
+        /**
+         * @brief Checkpoint to path every interval of simulated time
+         *
+         * Each firing captures at the end of its timestamp and writes in the
+         * background; a firing that finds the previous write still running,
+         * or state that cannot be saved, is skipped.
+         */
+        EventHandle scheduleCheckpoints(const std::chrono::milliseconds& interval, const std::string& path);
+
+        /**
+         * @brief Rebuild the simulation from a checkpoint file
+         *
+         * The engine and network manager must be stopped and the device
+         * manager empty.
+         * @param rebinder Supplies callbacks for the saved events
+         * @return false if the file is missing, corrupt, of another format
+         *         version, or does not fit the target components
+         */
+        bool restore(const std::string& path, const EventRebinder& rebinder);
+
+        const RestoreReport& getLastRestore() const { return lastRestore; }
+
+        /**
+         * @brief How long the last capture held the simulation thread
+         */
+        std::chrono::steady_clock::duration getLastCapturePause() const { return lastCapturePause; }
+
+        /**
+         * @brief Devices of unregistered kinds the last capture left out
+         */
+        size_t getUnsavedDevices() const { return unsavedDevices; }
+
+        /**
+         * @brief Captures refused because unsaveable state was pending
+         */
+        size_t getRefusedCaptures() const { return refusedCaptures; }
+
+        size_t getCheckpointsWritten() const { return checkpointsWritten.load(); }
+
+    private:
+        void writeDevices(CheckpointWriter& out);
+        bool readDevices(CheckpointReader& in, size_t& skipped);
+
+        /**
+         * @brief Dispatch the payload's sections to their components
+         */
+        bool readSections(const uint8_t* payload, size_t size, uint32_t sectionCount, const EventRebinder& rebinder);
+
+        /**
+         * @brief Write an image to path through a synced temporary file
+         */
+        static bool writeFile(const std::string& path, const std::vector<uint8_t>& image);
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_SIMULATION_CHECKPOINT_H
@@ -4,6 +4,12 @@
 #include "../core/DeviceManager.h"
 #include "../network/NetworkManager.h"
 #include "../utils/ConfigManager.h"  
+#include "../utils/WorkStealingPool.h"
+#include "../utils/InlineFunction.h"
+#include "SimClock.h"
+#include "TimingWheel.h"
+#include "Behavior.h"
+#include <array>
 #include <chrono>
 #include <thread>
 #include <functional>
@@ -12,18 +18,42 @@
 #include <condition_variable>
 #include <memory>
 #include <vector>
+#include <atomic>
 
 namespace iot {
     
+    /**
+     * @brief Event and timer callback: move-only, captures up to 48 bytes stored inline
+     */
+    using EventCallback = InlineFunction<void(), 48>;
+    
     /**
      * @brief Event structure for scheduled simulation events
      */
     struct SimulationEvent {
         std::chrono::steady_clock::time_point scheduledTime;
         std::string eventId;
-        std::function<void()> callback;
+        EventCallback callback;
         int priority;
         
+        // Periodic timers re-arm in place: nominalTime advances by period
+        // and each firing lands at nominalTime plus a jitter draw
+        std::chrono::steady_clock::duration period{0};
+        std::chrono::steady_clock::duration jitter{0};
+        std::chrono::steady_clock::time_point nominalTime;
+        
+        // EventHandle slot of this event (NO_SLOT if it has no handle)
+        static constexpr uint32_t NO_SLOT = 0xFFFFFFFF;
+        uint32_t handleSlot = NO_SLOT;
+        uint32_t handleGeneration = 0;
+        
+        // Events due at the same instant with different keys may run in
+        // parallel; events sharing a key always run in queue order
+        static constexpr uint64_t NO_AFFINITY = ~0ULL;
+        uint64_t affinityKey = NO_AFFINITY;
+        
+        bool isPeriodic() const { return period > std::chrono::steady_clock::duration::zero(); }
+        
         // Comparison operator for priority queue (earliest time first)
         bool operator>(const SimulationEvent& other) const {
             if (scheduledTime == other.scheduledTime) {
@@ -33,6 +63,88 @@ namespace iot {
         }
     };
     
+    /**
+     * @brief A pending event as saved in a checkpoint
+     *
+     * Times are relative to the engine clock when the checkpoint was taken.
+     */
+    struct CheckpointEvent {
+        std::string eventId;
+        std::chrono::steady_clock::duration due;         // until the next firing
+        std::chrono::steady_clock::duration nominalDue;  // next firing before jitter (periodic events)
+        std::chrono::steady_clock::duration period;      // zero for one-shot events
+        std::chrono::steady_clock::duration jitter;
+        int priority;
+        uint64_t affinityKey;
+        
+        bool isPeriodic() const { return period > std::chrono::steady_clock::duration::zero(); }
+    };
+    
+    /**
+     * @brief Recreates the callback of a restored event, usually from its ID
+     *
+     * Callbacks cannot be saved, so a restore asks the scenario for each
+     * one. Returning an empty callback drops the event.
+     */
+    using EventRebinder = std::function<EventCallback(const CheckpointEvent&)>;
+    
+    class SimulationEngine;
+    class Sensor;
+    class CheckpointWriter;
+    class CheckpointReader;
+    
+    /**
+     * @brief Lightweight reference to a scheduled event
+     *
+     * Handles are generation-counted slot references: once the event has
+     * fired (one-shot) or been cancelled, the slot's generation moves on and
+     * the handle goes stale, so every call on it is a harmless no-op.
+     * Copyable; must not outlive the engine that issued it.
+     */
+    class EventHandle {
+    private:
+        friend class SimulationEngine;
+        
+        SimulationEngine* engine = nullptr;
+        uint32_t slot = SimulationEvent::NO_SLOT;
+        uint32_t generation = 0;
+        
+        EventHandle(SimulationEngine* owner, uint32_t slotIndex, uint32_t slotGeneration)
+            : engine(owner), slot(slotIndex), generation(slotGeneration) {}
+        
+    public:
+        EventHandle() = default;
+        
+        /**
+         * @brief Cancel the event (and all future firings if it repeats)
+         * @return true if the event was still pending
+         */
+        bool cancel();
+        
+        /**
+         * @brief Move the next firing to delay from now
+         *
+         * A repeating event keeps its interval, counted from the new time.
+         * @return true if the event was still pending
+         */
+        bool reschedule(const std::chrono::milliseconds& delay);
+        
+        /**
+         * @brief Check whether the event will still fire
+         */
+        bool isPending() const;
+        
+        /**
+         * @brief Check whether this handle was issued by an engine
+         */
+        bool isValid() const { return engine != nullptr; }
+    };
+    
+    /**
+     * @brief Batch callback of a cohort timer: a contiguous run of device handles
+     */
+    using CohortCallback = InlineFunction<void(const DeviceHandle* handles, size_t count), 48>;
+    
     /**
      * @brief Simulation configuration structure
      */
@@ -50,6 +162,13 @@ namespace iot {
      * @brief Main simulation engine
      */
     class SimulationEngine {
+        friend class EventHandle;
+        friend struct Behavior::promise_type;
+        friend class SleepAwaitable;
+        friend class UntilAwaitable;
+        friend class ReceiveAwaitable;
+        friend class EngineDriver;
+        
     public:
         enum class State {
             STOPPED,
@@ -57,6 +176,53 @@ namespace iot {
             PAUSED
         };
         
+        /**
+         * @brief How the simulation clock advances
+         *
+         * REAL_TIME paces the loop against the wall clock (scaled by the
+         * simulation speed). VIRTUAL_TIME never sleeps: the clock jumps
+         * straight to the next scheduled event.
+         */
+        enum class TimeMode {
+            REAL_TIME,
+            VIRTUAL_TIME
+        };
+        
+        /**
+         * @brief What the real-time loop does when a step overruns its deadline
+         *
+         * CATCH_UP keeps the deadline grid and runs the missed steps back to
+         * back, without sleeping, until the loop is on schedule again.
+         * SHED_LOAD drops the missed steps (and their device ticks) and
+         * resumes at the next deadline still ahead. Due events run either
+         * way, since the clock follows the wall clock.
+         */
+        enum class OverrunPolicy {
+            CATCH_UP,
+            SHED_LOAD
+        };
+        
+        /**
+         * @brief How closely the real-time loop kept to its deadlines
+         *
+         * Lag is how far past the next deadline a step finished. Jitter is
+         * how late the loop woke after sleeping to a deadline, counted in
+         * power-of-two buckets: bucket 0 is under 1 us, bucket i covers
+         * [2^(i-1), 2^i) us and the last bucket everything longer.
+         */
+        struct PacingStats {
+            static constexpr size_t JITTER_BUCKETS = 24;
+            
+            size_t steps;
+            size_t deadlineMisses;
+            size_t stepsShed;
+            std::chrono::nanoseconds currentLag;
+            std::chrono::nanoseconds maxLag;
+            std::chrono::nanoseconds totalLag;  // summed over missed deadlines
+            std::chrono::nanoseconds maxJitter;
+            std::array<size_t, JITTER_BUCKETS> jitterHistogram;
+        };
+        
     private:
         std::shared_ptr<DeviceManager> deviceManager;
         std::shared_ptr<NetworkManager> networkManager;
@@ -66,10 +232,40 @@ namespace iot {
         std::chrono::steady_clock::time_point currentTime;
         std::chrono::milliseconds simulationTimeStep;
         double simulationSpeed;
+        TimeMode timeMode;
         
-        // Event system
-        std::priority_queue<SimulationEvent, std::vector<SimulationEvent>, std::greater<SimulationEvent>> eventQueue;
+        // Real-time pacing against absolute deadlines
+        OverrunPolicy overrunPolicy;
+        PacingStats pacingStats;  // guarded by pacingMutex
+        mutable std::mutex pacingMutex;
+        
+        // Simulated time of day shared with every device
+        std::shared_ptr<SimClock> simClock;
+        std::chrono::steady_clock::duration simulatedElapsed;  // guarded by eventMutex
+        
+        // Event system: O(1) insert/expiry, events are moved rather than copied
+        TimingWheel<SimulationEvent> eventQueue;
         mutable std::mutex eventMutex;
+        
+        /**
+         * @brief Where an EventHandle's event currently lives
+         */
+        struct EventSlot {
+            uint32_t generation = 0;
+            TimingWheel<SimulationEvent>::Ticket ticket;
+            bool queued = false;       // false while a repeating event is executing
+            bool rescheduled = false;  // repeating event was rescheduled while executing
+            std::chrono::steady_clock::time_point nextTime;
+        };
+        std::vector<EventSlot> eventSlots;      // guarded by eventMutex
+        std::vector<uint32_t> freeEventSlots;
+        
+        // Parallel dispatch of same-timestamp events (null = serial)
+        std::unique_ptr<WorkStealingPool> eventPool;
+        std::vector<SimulationEvent> dueBatch;
+        std::vector<uint32_t> groupOrder;
+        std::vector<uint32_t> groupStart;
+        std::vector<std::vector<SimulationEvent>> groupDeferred;  // events scheduled by each group
         std::condition_variable eventCondition;
         
         // Threading
@@ -80,8 +276,34 @@ namespace iot {
         // Configuration
         SimulationConfig config;
         
+        // Periodic timer jitter (counter-based, reproducible)
+        uint64_t jitterSeed;
+        uint64_t jitterCounter;
+        
+        // Per-tick device pipeline (update -> sampling -> outbox flush)
+        bool deviceTickEnabled;  // real-time steps run the pipeline (opt-in)
+        std::unique_ptr<WorkStealingPool> tickPool;  // null = run on the simulation thread
+        size_t tickGrainSize;
+        std::vector<std::shared_ptr<IoTDevice>> tickDevices;  // cached, refreshed on registration changes
+        std::vector<Sensor*> tickSensors;
+        uint64_t tickDevicesVersion;
+        size_t deviceTicks;
+        std::chrono::steady_clock::duration deviceTickTime;
+        
+        // Coroutine behaviours: intrusive list of live frames and until() waiters
+        mutable std::mutex behaviorMutex;
+        Behavior::promise_type* behaviors;
+        size_t activeBehaviors;
+        std::vector<UntilAwaitable*> untilWaiters;  // guarded by behaviorMutex
+        std::vector<UntilAwaitable*> untilScratch;  // simulation thread only
+        std::atomic<size_t> untilWaiterCount;
+        
+        // Callbacks waiting for the end of the current timestamp (see atQuiescentPoint)
+        std::vector<EventCallback> quiescentCallbacks;  // guarded by eventMutex
+        std::atomic<size_t> quiescentCount;
+        
         // Statistics
-        size_t totalEventsProcessed;
+        std::atomic<size_t> totalEventsProcessed;
         size_t simulationSteps;
         
     public:
@@ -122,30 +344,242 @@ namespace iot {
         
         /**
          * @brief Schedule an event
+         * @param eventId Name for checkpoint rebinding; leave empty for an
+         *        event that is never checkpointed (the log shows EVENT_<n>)
+         * @param affinityKey Device or region the event touches (see setParallelEventWorkers)
+         * @return Handle for cancelling or rescheduling the event
          */
-        void scheduleEvent(const std::chrono::milliseconds& delay, 
-                          std::function<void()> callback,
+        EventHandle scheduleEvent(const std::chrono::milliseconds& delay, 
+                          EventCallback callback,
                           const std::string& eventId = "",
-                          int priority = 0);
+                          int priority = 0,
+                          uint64_t affinityKey = SimulationEvent::NO_AFFINITY);
         
         /**
          * @brief Schedule a repeating event
+         *
+         * The timer is stored once and re-armed in place after each firing,
+         * so steady-state firings do not allocate.
+         * @param eventId Name for checkpoint rebinding; leave empty for a
+         *        timer that is never checkpointed (the log shows REPEAT_<n>)
+         * @param jitter Each firing is delayed by a deterministic draw in [0, jitter]
+         * @return Handle for cancelling or rescheduling the timer (invalid on error)
          */
-        void scheduleRepeatingEvent(const std::chrono::milliseconds& interval,
-                                   std::function<void()> callback,
+        EventHandle scheduleRepeatingEvent(const std::chrono::milliseconds& interval,
+                                   EventCallback callback,
                                    const std::string& eventId = "",
-                                   int priority = 0);
+                                   int priority = 0,
+                                   const std::chrono::milliseconds& jitter = std::chrono::milliseconds(0),
+                                   uint64_t affinityKey = SimulationEvent::NO_AFFINITY);
+        
+        /**
+         * @brief Schedule one periodic timer for a whole cohort of devices
+         *
+         * Each device gets a deterministic phase inside the interval, hashed
+         * from its handle and rounded to phaseResolution. Devices sharing a
+         * phase bucket are stored contiguously and fired by a single wheel
+         * entry, which calls the batch callback once per bucket.
+         * @return One handle per wheel entry (non-empty phase bucket); cancel
+         *         them all to stop the cohort
+         */
+        std::vector<EventHandle> scheduleCohortTimer(const std::chrono::milliseconds& interval,
+                                   const std::vector<DeviceHandle>& devices,
+                                   CohortCallback callback,
+                                   const std::string& cohortId = "",
+                                   int priority = 0,
+                                   const std::chrono::milliseconds& phaseResolution = std::chrono::milliseconds(100));
+        
+        /**
+         * @brief Run same-timestamp events on a work-stealing pool (only while stopped)
+         *
+         * Events due at one instant are grouped by affinity key and the
+         * groups run in parallel, each in queue order. Events without a key,
+         * and priority boundaries, split the batch into serial points. Events
+         * scheduled from a group are queued after the barrier in key order,
+         * so runs stay deterministic. The clock advances only once the whole
+         * batch has finished.
+         * @param workers Threads including the simulation thread (0 or 1 = serial)
+         */
+        void setParallelEventWorkers(size_t workers);
+        
+        /**
+         * @brief Threads used for same-timestamp events (1 = serial)
+         */
+        size_t getParallelEventWorkers() const;
+        
+        /**
+         * @brief Threads for the per-tick device pipeline, including the caller (0 or 1 = serial)
+         *
+         * Also turns the per-step device tick on (see enableDeviceTick).
+         */
+        void setTickWorkers(size_t workers);
+        
+        /**
+         * @brief Run the device tick once per real-time simulation step
+         *
+         * Off by default, so a real-time run only executes scheduled events
+         * unless the scenario asks for the tick. Explicit runDeviceTick()
+         * calls work either way.
+         */
+        void enableDeviceTick(bool enabled = true);
+        
+        bool isDeviceTickEnabled() const { return deviceTickEnabled; }
+        
+        /**
+         * @brief Devices per work chunk in the tick pipeline
+         */
+        void setTickGrainSize(size_t devices);
+        
+        size_t getTickGrainSize() const { return tickGrainSize; }
+        
+        /**
+         * @brief Run one device tick over every registered device
+         *
+         * Three stages, each split into grain-sized chunks on the tick pool
+         * and finished before the next begins: update() on active devices,
+         * then sensor sampling, then a flush of every device outbox through
+         * NetworkManager::sendBatch (one batch per chunk). Sampling goes
+         * through Sensor::sample(), which charges no energy. With the tick
+         * enabled, real-time mode runs this once per simulation step; in
+         * virtual time schedule it as a repeating event at the desired rate.
+         * @return Number of messages handed to the network
+         */
+        size_t runDeviceTick();
+        
+        /**
+         * @brief Device ticks run so far and their average rate
+         */
+        size_t getDeviceTicks() const { return deviceTicks; }
+        double getDeviceTicksPerSecond() const;
+        
+        /**
+         * @brief Start a coroutine behaviour on this engine
+         *
+         * The behaviour first runs as an event at the current time. Its
+         * resumes are keyed by device, so behaviours of different devices
+         * may run in parallel (see setParallelEventWorkers).
+         * @param device Device the behaviour acts for; network receive() waits on it
+         */
+        void spawn(Behavior behavior, DeviceHandle device = DeviceHandle());
+        
+        /**
+         * @brief co_await sleep(delay) suspends a behaviour for delay of simulated time
+         */
+        SleepAwaitable sleep(const std::chrono::milliseconds& delay) { return SleepAwaitable(this, delay); }
+        
+        /**
+         * @brief co_await until(predicate) suspends a behaviour until predicate returns true
+         */
+        UntilAwaitable until(InlineFunction<bool(), 48> predicate) {
+            return UntilAwaitable(this, std::move(predicate));
+        }
+        
+        /**
+         * @brief Spawned behaviours that have not finished yet
+         */
+        size_t getActiveBehaviors() const;
         
         /**
          * @brief Set simulation speed
          */
         void setSimulationSpeed(double speed);
         
+        /**
+         * @brief Wall-clock period of a real-time step at speed 1.0 (only while stopped)
+         */
+        void setTimeStep(const std::chrono::milliseconds& step);
+        
+        std::chrono::milliseconds getTimeStep() const { return simulationTimeStep; }
+        
+        /**
+         * @brief Choose how the real-time loop recovers from an overrun
+         */
+        void setOverrunPolicy(OverrunPolicy policy);
+        
+        OverrunPolicy getOverrunPolicy() const;
+        
+        /**
+         * @brief Deadline misses, lag and wake-up jitter of the real-time loop
+         */
+        PacingStats getPacingStats() const;
+        
+        void resetPacingStats();
+        
+        /**
+         * @brief Select real-time or virtual-time clock (only while stopped)
+         */
+        void setTimeMode(TimeMode mode);
+        
+        /**
+         * @brief Get the active clock mode
+         */
+        TimeMode getTimeMode() const;
+        
+        /**
+         * @brief Reseed the periodic timer jitter draws (only while stopped)
+         */
+        void setRandomSeed(uint64_t seed);
+        
+        /**
+         * @brief Run the simulation synchronously in virtual time
+         * @param duration Amount of simulated time to advance
+         * @return Number of events executed
+         */
+        size_t runFor(const std::chrono::milliseconds& duration);
+        
         /**
          * @brief Get current simulation time
          */
         std::chrono::steady_clock::time_point getCurrentTime() const;
         
+        /**
+         * @brief Clock devices read their time of day from
+         */
+        std::shared_ptr<SimClock> getSimClock() const { return simClock; }
+        
+        /**
+         * @brief Run callback on the simulation thread once the current timestamp is done
+         *
+         * At that point no event callback is running and every periodic
+         * timer is back in the queue, so engine and device state can be
+         * captured consistently (see SimulationCheckpoint). Meant to be
+         * requested from an event; the callback runs after the timestamp
+         * being processed, or the next one if none is.
+         */
+        void atQuiescentPoint(EventCallback callback);
+        
+        /**
+         * @brief Pending events without an ID
+         *
+         * Events scheduled without an eventId, message deliveries and
+         * behaviour resumes. These cannot be rebound on restore, so a
+         * complete checkpoint is only possible while this is zero.
+         */
+        size_t getUnnamedPendingEvents() const;
+        
+        /**
+         * @brief Save the clock, the jitter stream and every pending event that has an ID
+         *
+         * Call while stopped or from atQuiescentPoint. Events without an ID
+         * cannot be rebound on restore and are left out; SimulationCheckpoint
+         * refuses to capture while there are any (getUnnamedPendingEvents).
+         * @return Number of pending events left out
+         */
+        size_t writeCheckpoint(CheckpointWriter& out) const;
+        
+        /**
+         * @brief Restore a checkpoint written by writeCheckpoint (only while stopped)
+         *
+         * The clock keeps its current reading and the simulated elapsed time
+         * is set to the saved one; restored events are due at the same
+         * distance from now as when they were saved, in the same order.
+         * @param rebinder Supplies each event's callback
+         * @param restored Receives the number of events queued
+         * @param dropped Receives the number of events the rebinder declined
+         * @return false if the data is malformed or the engine is running
+         */
+        bool readCheckpoint(CheckpointReader& in, const EventRebinder& rebinder, size_t& restored, size_t& dropped);
+        
         /**
          * @brief Load configuration from file
          */
@@ -162,15 +596,212 @@ namespace iot {
          */
         void runSimulation();
         
+        /**
+         * @brief Sleep until the next real-time deadline, applying the overrun policy
+         * @param deadline Deadline of the step just run; moved to the next one
+         */
+        void waitForNextDeadline(std::chrono::steady_clock::time_point& deadline);
+        
         /**
          * @brief Process pending events
          */
         void processEvents();
         
+        /**
+         * @brief Execute the next event, or every event of the next timestamp in parallel mode
+         * @param limit Events scheduled after this time are left pending
+         * @param moveClock Jump the virtual clock to the events' timestamp
+         * @param executed Receives the number of callbacks run
+         * @return false if nothing was due
+         */
+        bool processNextTimestamp(std::chrono::steady_clock::time_point limit, bool moveClock, size_t& executed);
+        
+        /**
+         * @brief Run dueBatch: serial points in order, keyed runs on the pool
+         * @return Number of callbacks run
+         */
+        size_t executeBatch();
+        
+        /**
+         * @brief Run dueBatch[begin, end) grouped by affinity key, then flush what they scheduled
+         */
+        size_t executeKeyedRun(size_t begin, size_t end);
+        
+        /**
+         * @brief Execute an event callback and update statistics
+         * @return true if a callback ran
+         */
+        bool executeEvent(SimulationEvent& event);
+        
+        /**
+         * @brief Queue a resume of a suspended behaviour after delay
+         *
+         * The event carries only the coroutine handle, so it never allocates.
+         */
+        void scheduleResume(const std::chrono::milliseconds& delay, Behavior::Handle coroutine);
+        
+        /**
+         * @brief Queue a callback at an absolute time without a handle or log line
+         */
+        void postAt(std::chrono::steady_clock::time_point time, EventCallback callback,
+                    uint64_t affinityKey = SimulationEvent::NO_AFFINITY);
+        
+        /**
+         * @brief Execute every event due up to endTime, then move the clock there (virtual time)
+         * @return Number of events executed
+         */
+        size_t runUntil(std::chrono::steady_clock::time_point endTime);
+        
+        /**
+         * @brief Time of the earliest pending event
+         * @return false if the queue is empty
+         */
+        bool nextEventTime(std::chrono::steady_clock::time_point& time);
+        
+        /**
+         * @brief Park a behaviour until its predicate holds
+         */
+        void addUntilWaiter(UntilAwaitable& waiter);
+        
+        /**
+         * @brief Re-check until() predicates and resume the satisfied behaviours
+         */
+        void checkUntilWaiters();
+        
+        /**
+         * @brief Run the callbacks queued by atQuiescentPoint
+         */
+        void runQuiescentCallbacks();
+        
+        /**
+         * @brief Remove a finished or destroyed behaviour from the live list
+         */
+        void unlinkBehavior(Behavior::promise_type& promise);
+        
+        /**
+         * @brief Put a periodic event back in the queue for its next firing
+         */
+        void rearm(SimulationEvent&& event);
+        
+        /**
+         * @brief Queue an event under a new handle slot (caller must hold eventMutex)
+         */
+        EventHandle pushWithHandle(SimulationEvent&& event);
+        
+        /**
+         * @brief Give an event a handle slot without queueing it (caller must hold eventMutex)
+         */
+        EventHandle acquireSlot(SimulationEvent& event);
+        
+        /**
+         * @brief Push an event and record its ticket in its slot (caller must hold eventMutex)
+         */
+        void enqueue(SimulationEvent&& event);
+        
+        /**
+         * @brief Remove the earliest event from the queue (caller must hold eventMutex)
+         */
+        SimulationEvent popEvent();
+        
+        /**
+         * @brief Decide whether a taken event still runs (caller must hold eventMutex)
+         *
+         * Retires the slot of a one-shot event; an event cancelled or
+         * rescheduled after it left the queue is dropped or queued again.
+         */
+        bool claimForExecution(SimulationEvent& event);
+        
+        /**
+         * @brief Buffer for events scheduled from a parallel group on this thread, if any
+         */
+        std::vector<SimulationEvent>* deferralTarget() const;
+        
+        /**
+         * @brief Queue events scheduled during a parallel run (caller must hold eventMutex)
+         */
+        void flushDeferred(std::vector<SimulationEvent>& deferred);
+        
+        /**
+         * @brief Retire a handle slot (caller must hold eventMutex)
+         */
+        void releaseSlot(uint32_t slot);
+        
+        bool slotMatches(uint32_t slot, uint32_t generation) const {
+            return slot < eventSlots.size() && eventSlots[slot].generation == generation;
+        }
+        
+        bool cancelEvent(uint32_t slot, uint32_t generation);
+        bool rescheduleEvent(uint32_t slot, uint32_t generation, const std::chrono::milliseconds& delay);
+        bool isEventPending(uint32_t slot, uint32_t generation) const;
+        
+        /**
+         * @brief Jitter offset for the next periodic firing (caller must hold eventMutex)
+         */
+        std::chrono::steady_clock::duration drawJitter(std::chrono::steady_clock::duration jitter);
+        
+        /**
+         * @brief Current clock reading (caller must hold eventMutex)
+         */
+        std::chrono::steady_clock::time_point clockNow() const;
+        
+        /**
+         * @brief Move the engine clock and the shared SimClock (caller must hold eventMutex)
+         */
+        void advanceClock(std::chrono::steady_clock::time_point time);
+        
         /**
          * @brief Execute a single simulation step
          */
         void simulationStep();
+        
+        /**
+         * @brief Rebuild the cached device and sensor lists if registrations changed
+         */
+        void refreshTickDevices();
+        
+        /**
+         * @brief Run task over [0, count) in grain-sized chunks on the tick pool
+         */
+        void forEachTickChunk(size_t count, const WorkStealingPool::RangeTask& task);
+    };
+    
+    /**
+     * @brief Steps a virtual-time engine on behalf of a coordinator
+     *
+     * PartitionedSimulation, DistributedSimulation and Replica own the
+     * clock of the engines they drive: they advance it window by window,
+     * ask for the next pending timestamp to agree on a safe bound, and
+     * inject deliveries at exact times. This is the whole of what they may
+     * touch; the rest of the engine's internals stay private.
+     */
+    class EngineDriver {
+    private:
+        SimulationEngine& engine;
+        
+    public:
+        explicit EngineDriver(SimulationEngine& driven) : engine(driven) {}
+        
+        /**
+         * @brief Execute every event due up to endTime, then move the clock there
+         * @return Number of events executed
+         */
+        size_t runUntil(std::chrono::steady_clock::time_point endTime) { return engine.runUntil(endTime); }
+        
+        /**
+         * @brief Time of the earliest pending event
+         * @return false if the queue is empty
+         */
+        bool nextEventTime(std::chrono::steady_clock::time_point& time) { return engine.nextEventTime(time); }
+        
+        /**
+         * @brief Queue a callback at an absolute time, without a handle or ID
+         *
+         * Such events cannot be checkpointed (see SimulationCheckpoint::capture).
+         */
+        void postAt(std::chrono::steady_clock::time_point time, EventCallback callback,
+                    uint64_t affinityKey = SimulationEvent::NO_AFFINITY) {
+            engine.postAt(time, std::move(callback), affinityKey);
+        }
     };
     
 } // namespace iot
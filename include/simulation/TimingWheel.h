@@ -0,0 +1,362 @@
+#ifndef IOT_SIMULATION_TIMING_WHEEL_H
+#define IOT_SIMULATION_TIMING_WHEEL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace iot {
+
+    /**
+     * @brief Hierarchical timing wheel ordered like a priority queue
+     *
+     * Four levels of 256 slots cover 2^32 ticks (about 49 days at the
+     * default 1 ms tick). Items further out wait in an overflow heap until
+     * they come within range. Inserting an item and expiring a slot are
+     * O(1). Items whose tick has been reached move to a small "ready" heap,
+     * which orders them exactly. T must have a steady_clock scheduledTime
+     * member and an operator> meaning "runs later than". Items with equal
+     * keys come out in insertion order.
+     *
+     * Items live in a slab of nodes and only their indices are linked into
+     * slots, so items are moved once in and once out and never copied.
+     * The cursor may run ahead of the caller's clock while looking for the
+     * next item. Anything pushed behind the cursor goes straight to the
+     * ready heap, so ordering is always exact.
+     *
+     * push() returns a Ticket naming the node and its generation. take()
+     * cancels in O(1): the item is moved out and the node stays behind as a
+     * tombstone until its slot is reached, so the queue is never scanned.
+     * A tombstone is still ordered by the moved-from item, so T's ordering
+     * fields must survive a move (plain members such as scheduledTime do).
+     *
+     * Not thread-safe; SimulationEngine guards it with eventMutex.
+     */
+    template <typename T>
+    class TimingWheel {
+    public:
+        using TimePoint = std::chrono::steady_clock::time_point;
+        using Duration = std::chrono::steady_clock::duration;
+
+    private:
+        static constexpr int LEVELS = 4;
+        static constexpr int SLOT_BITS = 8;
+        static constexpr int SLOTS = 1 << SLOT_BITS;
+        static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+        struct Node {
+            std::optional<T> item;
+            int64_t tick = 0;
+            uint64_t sequence = 0;
+            uint32_t next = NONE;
+            uint32_t generation = 0;  // bumped whenever the node is freed
+            bool cancelled = false;
+        };
+
+        struct Level {
+            uint32_t heads[SLOTS];
+            uint64_t occupied[SLOTS / 64];
+        };
+
+    public:
+        /**
+         * @brief Identifies one pushed item; stale once it is popped or taken
+         */
+        struct Ticket {
+            uint32_t index = NONE;
+            uint32_t generation = 0;
+        };
+
+    private:
+        TimePoint origin;
+        Duration tickDuration;
+        int64_t cursor;  // every tick before this has been expired
+        uint64_t nextSequence;
+        size_t count;
+
+        std::vector<Node> nodes;
+        std::vector<uint32_t> freeNodes;
+        Level levels[LEVELS];
+        std::vector<uint32_t> ready;     // heap: exact order of reached items
+        std::vector<uint32_t> overflow;  // heap by tick: beyond the top level
+
+        // Heap comparators (std heaps keep the "largest" on top)
+        struct ReadyLater {
+            const std::vector<Node>* nodes;
+            bool operator()(uint32_t a, uint32_t b) const {
+                const Node& x = (*nodes)[a];
+                const Node& y = (*nodes)[b];
+                if (*x.item > *y.item) return true;
+                if (*y.item > *x.item) return false;
+                return x.sequence > y.sequence;
+            }
+        };
+
+        struct OverflowLater {
+            const std::vector<Node>* nodes;
+            bool operator()(uint32_t a, uint32_t b) const {
+                const Node& x = (*nodes)[a];
+                const Node& y = (*nodes)[b];
+                if (x.tick != y.tick) return x.tick > y.tick;
+                return x.sequence > y.sequence;
+            }
+        };
+
+        int64_t tickOf(TimePoint time) const {
+            auto offset = time - origin;
+            if (offset <= Duration::zero()) return 0;
+            return static_cast<int64_t>(offset / tickDuration);
+        }
+
+        static int levelShift(int level) { return level * SLOT_BITS; }
+
+        static int findSetBit(const uint64_t* words, int from) {
+            for (int word = from / 64; word < SLOTS / 64; ++word) {
+                uint64_t bits = words[word];
+                if (word == from / 64) bits &= ~uint64_t(0) << (from % 64);
+                if (bits) return word * 64 + __builtin_ctzll(bits);
+            }
+            return -1;
+        }
+
+        void link(int level, int slot, uint32_t index) {
+            Level& l = levels[level];
+            nodes[index].next = l.heads[slot];
+            l.heads[slot] = index;
+            l.occupied[slot / 64] |= uint64_t(1) << (slot % 64);
+        }
+
+        uint32_t unlinkSlot(int level, int slot) {
+            Level& l = levels[level];
+            uint32_t head = l.heads[slot];
+            l.heads[slot] = NONE;
+            l.occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+            return head;
+        }
+
+        void release(uint32_t index) {
+            Node& node = nodes[index];
+            node.item.reset();
+            node.cancelled = false;
+            node.generation++;
+            freeNodes.push_back(index);
+        }
+
+        void pushReady(uint32_t index) {
+            ready.push_back(index);
+            std::push_heap(ready.begin(), ready.end(), ReadyLater{&nodes});
+        }
+
+        void place(uint32_t index) {
+            if (nodes[index].cancelled) {
+                release(index);  // lazy reclamation of a taken item
+                return;
+            }
+
+            int64_t tick = nodes[index].tick;
+            if (tick <= cursor) {
+                pushReady(index);
+                return;
+            }
+
+            uint64_t delta = static_cast<uint64_t>(tick - cursor);
+            for (int level = 0; level < LEVELS; ++level) {
+                if (delta < (uint64_t(1) << levelShift(level + 1))) {
+                    int slot = static_cast<int>((static_cast<uint64_t>(tick) >> levelShift(level)) & (SLOTS - 1));
+                    link(level, slot, index);
+                    return;
+                }
+            }
+
+            overflow.push_back(index);
+            std::push_heap(overflow.begin(), overflow.end(), OverflowLater{&nodes});
+        }
+
+        /**
+         * @brief Earliest tick at which some non-empty slot must be expanded
+         */
+        int64_t nextBucketStart() const {
+            int64_t best = INT64_MAX;
+            for (int level = 0; level < LEVELS; ++level) {
+                int shift = levelShift(level);
+                int current = static_cast<int>((static_cast<uint64_t>(cursor) >> shift) & (SLOTS - 1));
+                int64_t rotationStart = (cursor >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+                int64_t rotationLength = int64_t(1) << (shift + SLOT_BITS);
+
+                int slot = current + 1 < SLOTS ? findSetBit(levels[level].occupied, current + 1) : -1;
+                int64_t start;
+                if (slot >= 0) {
+                    start = rotationStart + (int64_t(slot) << shift);
+                } else {
+                    // Slots at or before the current index belong to the next rotation
+                    slot = findSetBit(levels[level].occupied, 0);
+                    if (slot < 0) continue;
+                    start = rotationStart + rotationLength + (int64_t(slot) << shift);
+                }
+                best = std::min(best, start);
+            }
+            return best;
+        }
+
+        /**
+         * @brief Jump the cursor to the next non-empty bucket and expand it
+         */
+        void advance() {
+            int64_t target = nextBucketStart();
+            if (!overflow.empty()) {
+                // Far-future items enter the wheel once they are within range
+                int64_t overflowStart = nodes[overflow.front()].tick - ((int64_t(1) << levelShift(LEVELS)) - 1);
+                target = std::min(target, std::max(overflowStart, cursor + 1));
+            }
+            if (target == INT64_MAX) return;
+
+            cursor = target;
+            while (!overflow.empty() &&
+                   static_cast<uint64_t>(nodes[overflow.front()].tick - cursor) < (uint64_t(1) << levelShift(LEVELS))) {
+                std::pop_heap(overflow.begin(), overflow.end(), OverflowLater{&nodes});
+                uint32_t index = overflow.back();
+                overflow.pop_back();
+                place(index);
+            }
+
+            // Cascade from the top so re-placed items are expanded in turn
+            for (int level = LEVELS - 1; level >= 0; --level) {
+                int shift = levelShift(level);
+                if (cursor & ((int64_t(1) << shift) - 1)) continue;
+                int slot = static_cast<int>((static_cast<uint64_t>(cursor) >> shift) & (SLOTS - 1));
+                if (levels[level].heads[slot] == NONE) continue;
+
+                uint32_t index = unlinkSlot(level, slot);
+                while (index != NONE) {
+                    uint32_t next = nodes[index].next;
+                    place(index);
+                    index = next;
+                }
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructor
+         * @param wheelOrigin Time of tick 0
+         * @param resolution Width of one tick
+         */
+        explicit TimingWheel(TimePoint wheelOrigin = std::chrono::steady_clock::now(),
+                             Duration resolution = std::chrono::milliseconds(1))
+            : origin(wheelOrigin)
+            , tickDuration(resolution)
+            , cursor(0)
+            , nextSequence(0)
+            , count(0) {
+            for (auto& level : levels) {
+                std::fill(std::begin(level.heads), std::end(level.heads), NONE);
+                std::fill(std::begin(level.occupied), std::end(level.occupied), 0);
+            }
+        }
+
+        TimingWheel(const TimingWheel&) = delete;
+        TimingWheel& operator=(const TimingWheel&) = delete;
+
+        bool empty() const { return count == 0; }
+        size_t size() const { return count; }
+
+        /**
+         * @brief Insert an item (moved, never copied)
+         */
+        Ticket push(T&& item) {
+            uint32_t index;
+            if (freeNodes.empty()) {
+                index = static_cast<uint32_t>(nodes.size());
+                nodes.emplace_back();
+            } else {
+                index = freeNodes.back();
+                freeNodes.pop_back();
+            }
+
+            Node& node = nodes[index];
+            node.tick = tickOf(item.scheduledTime);
+            node.sequence = nextSequence++;
+            node.next = NONE;
+            node.item.emplace(std::move(item));
+            count++;
+            place(index);
+            return Ticket{index, node.generation};
+        }
+
+        /**
+         * @brief Remove a pending item without searching for it
+         * @return The item, or nothing if the ticket is stale
+         */
+        std::optional<T> take(Ticket ticket) {
+            if (ticket.index >= nodes.size()) return std::nullopt;
+            Node& node = nodes[ticket.index];
+            if (node.generation != ticket.generation || node.cancelled || !node.item) {
+                return std::nullopt;
+            }
+
+            std::optional<T> item(std::move(*node.item));
+            node.cancelled = true;
+            count--;
+            return item;
+        }
+
+        /**
+         * @brief Check whether a ticket still names a pending item
+         */
+        bool contains(Ticket ticket) const {
+            return ticket.index < nodes.size() && nodes[ticket.index].generation == ticket.generation &&
+                   !nodes[ticket.index].cancelled && nodes[ticket.index].item.has_value();
+        }
+
+        /**
+         * @brief Visit every pending item, in no particular order
+         *
+         * visit(item, sequence) gets the insertion sequence, which orders
+         * items with equal keys.
+         */
+        template <typename Visitor>
+        void forEach(Visitor&& visit) const {
+            for (const Node& node : nodes) {
+                if (node.item && !node.cancelled) visit(*node.item, node.sequence);
+            }
+        }
+
+        /**
+         * @brief Earliest item, or nullptr if empty
+         */
+        const T* peek() {
+            while (true) {
+                while (!ready.empty() && nodes[ready.front()].cancelled) {
+                    std::pop_heap(ready.begin(), ready.end(), ReadyLater{&nodes});
+                    release(ready.back());
+                    ready.pop_back();
+                }
+                if (!ready.empty() || count == 0) break;
+                advance();
+            }
+            return ready.empty() ? nullptr : &*nodes[ready.front()].item;
+        }
+
+        /**
+         * @brief Remove and return the earliest item (wheel must not be empty)
+         */
+        T pop() {
+            peek();
+            std::pop_heap(ready.begin(), ready.end(), ReadyLater{&nodes});
+            uint32_t index = ready.back();
+            ready.pop_back();
+
+            T item = std::move(*nodes[index].item);
+            release(index);
+            count--;
+            return item;
+        }
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_TIMING_WHEEL_H
@@ -0,0 +1,245 @@
+#ifndef IOT_SIMULATION_CHECKPOINT_STREAM_H
+#define IOT_SIMULATION_CHECKPOINT_STREAM_H
+
+#include "CounterRng.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace iot {
+
+    /**
+     * @brief Append-only binary encoder for simulation checkpoints
+     *
+     * Integers are LEB128 varints (signed ones zigzag-encoded first), so
+     * handles, counters and small enums take one or two bytes. Doubles are
+     * stored as their 8 raw bytes in host order; checkpoints are meant to be
+     * restored on the machine type that wrote them. A block is a 4-byte
+     * length followed by its bytes, which lets a reader skip records it does
+     * not understand.
+     */
+    class CheckpointWriter {
+    private:
+        std::vector<uint8_t> bytes;
+
+    public:
+        void writeU8(uint8_t value) { bytes.push_back(value); }
+
+        void writeU32(uint32_t value) {
+            size_t at = bytes.size();
+            bytes.resize(at + sizeof(value));
+            std::memcpy(bytes.data() + at, &value, sizeof(value));
+        }
+
+        void writeU64(uint64_t value) {
+            size_t at = bytes.size();
+            bytes.resize(at + sizeof(value));
+            std::memcpy(bytes.data() + at, &value, sizeof(value));
+        }
+
+        void writeVarint(uint64_t value) {
+            while (value >= 0x80) {
+                bytes.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            bytes.push_back(static_cast<uint8_t>(value));
+        }
+
+        void writeSigned(int64_t value) {
+            writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        void writeBool(bool value) { bytes.push_back(value ? 1 : 0); }
+
+        void writeDouble(double value) {
+            uint64_t raw;
+            std::memcpy(&raw, &value, sizeof(raw));
+            writeU64(raw);
+        }
+
+        void writeString(const std::string& value) {
+            writeVarint(value.size());
+            bytes.insert(bytes.end(), value.begin(), value.end());
+        }
+
+        void writeDuration(std::chrono::steady_clock::duration value) { writeSigned(value.count()); }
+
+        void writeBytes(const void* data, size_t size) {
+            const uint8_t* begin = static_cast<const uint8_t*>(data);
+            bytes.insert(bytes.end(), begin, begin + size);
+        }
+
+        /**
+         * @brief Start a length-prefixed block
+         * @return Position to pass to endBlock
+         */
+        size_t beginBlock() {
+            size_t at = bytes.size();
+            writeU32(0);
+            return at;
+        }
+
+        /**
+         * @brief Patch the length of the block started at position
+         */
+        void endBlock(size_t position) {
+            uint32_t length = static_cast<uint32_t>(bytes.size() - position - sizeof(uint32_t));
+            std::memcpy(bytes.data() + position, &length, sizeof(length));
+        }
+
+        void reserve(size_t size) { bytes.reserve(size); }
+        size_t size() const { return bytes.size(); }
+        uint8_t* data() { return bytes.data(); }
+        const uint8_t* data() const { return bytes.data(); }
+
+        /**
+         * @brief Hand over the encoded bytes, leaving the writer empty
+         */
+        std::vector<uint8_t> release() { return std::move(bytes); }
+    };
+
+    /**
+     * @brief Bounds-checked decoder over a CheckpointWriter image
+     *
+     * The reader never throws: reading past the end or a malformed varint
+     * sets the failed flag and returns zeros from then on, so a caller can
+     * decode a whole record and check ok() once.
+     */
+    class CheckpointReader {
+    private:
+        const uint8_t* cursor;
+        const uint8_t* end;
+        bool failed;
+
+        bool need(size_t size) {
+            if (failed || static_cast<size_t>(end - cursor) < size) {
+                failed = true;
+                return false;
+            }
+            return true;
+        }
+
+    public:
+        CheckpointReader(const uint8_t* data, size_t size) : cursor(data), end(data + size), failed(false) {}
+
+        bool ok() const { return !failed; }
+        bool atEnd() const { return cursor == end; }
+        size_t remaining() const { return static_cast<size_t>(end - cursor); }
+
+        /**
+         * @brief Mark the data as invalid (for semantic checks by the caller)
+         */
+        void fail() { failed = true; }
+
+        uint8_t readU8() {
+            if (!need(1)) return 0;
+            return *cursor++;
+        }
+
+        uint32_t readU32() {
+            uint32_t value = 0;
+            if (need(sizeof(value))) {
+                std::memcpy(&value, cursor, sizeof(value));
+                cursor += sizeof(value);
+            }
+            return value;
+        }
+
+        uint64_t readU64() {
+            uint64_t value = 0;
+            if (need(sizeof(value))) {
+                std::memcpy(&value, cursor, sizeof(value));
+                cursor += sizeof(value);
+            }
+            return value;
+        }
+
+        uint64_t readVarint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (!need(1)) return 0;
+                uint8_t byte = *cursor++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) return value;
+            }
+            failed = true;
+            return 0;
+        }
+
+        int64_t readSigned() {
+            uint64_t value = readVarint();
+            return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+        }
+
+        bool readBool() { return readU8() != 0; }
+
+        double readDouble() {
+            uint64_t raw = readU64();
+            double value;
+            std::memcpy(&value, &raw, sizeof(value));
+            return value;
+        }
+
+        std::string readString() {
+            uint64_t size = readVarint();
+            if (!need(size)) return std::string();
+            std::string value(reinterpret_cast<const char*>(cursor), size);
+            cursor += size;
+            return value;
+        }
+
+        std::chrono::steady_clock::duration readDuration() {
+            return std::chrono::steady_clock::duration(readSigned());
+        }
+
+        /**
+         * @brief Read a length-prefixed block as its own reader and move past it
+         */
+        CheckpointReader readBlock() {
+            uint32_t length = readU32();
+            if (!need(length)) {
+                CheckpointReader empty(end, 0);
+                empty.failed = true;
+                return empty;
+            }
+            CheckpointReader block(cursor, length);
+            cursor += length;
+            return block;
+        }
+
+        /**
+         * @brief Element count that cannot exceed the bytes left (one byte per element at least)
+         */
+        size_t readCount() {
+            uint64_t count = readVarint();
+            if (count > remaining()) {
+                failed = true;
+                return 0;
+            }
+            return static_cast<size_t>(count);
+        }
+    };
+
+    /**
+     * @brief Checksum of a checkpoint payload, hashed a 64-bit word at a time
+     */
+    inline uint64_t checkpointChecksum(const uint8_t* data, size_t size) {
+        uint64_t hash = mixBits(size);
+        size_t words = size / sizeof(uint64_t);
+        for (size_t i = 0; i < words; ++i) {
+            uint64_t word;
+            std::memcpy(&word, data + i * sizeof(uint64_t), sizeof(word));
+            hash = mixBits(hash ^ word);
+        }
+        uint64_t tail = 0;
+        if (size % sizeof(uint64_t) != 0) {
+            std::memcpy(&tail, data + words * sizeof(uint64_t), size % sizeof(uint64_t));
+        }
+        return mixBits(hash ^ tail);
+    }
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_CHECKPOINT_STREAM_H
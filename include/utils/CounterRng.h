@@ -0,0 +1,167 @@
+#ifndef IOT_SIMULATION_COUNTER_RNG_H
+#define IOT_SIMULATION_COUNTER_RNG_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace iot {
+
+    /**
+     * @brief SplitMix64 finalizer: a cheap, well-mixed 64-bit hash
+     */
+    inline uint64_t mixBits(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * @brief Map 64 random bits to a double in [0, 1)
+     */
+    inline double unitInterval(uint64_t bits) {
+        return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /**
+     * @brief Stateless draw in [0, 1) determined only by (key, counter)
+     *
+     * Threads can share a key and claim counters from an atomic, which
+     * makes the draw lock-free and independent of call order.
+     */
+    inline double counterUniform(uint64_t key, uint64_t counter) {
+        return unitInterval(mixBits(key ^ mixBits(counter)));
+    }
+
+    /**
+     * @brief Output of one Philox block: two independent 64-bit words
+     */
+    struct CounterBlock {
+        uint64_t first;
+        uint64_t second;
+    };
+
+    /**
+     * @brief Full 64x64 -> 128-bit product, returned as (high, low) halves
+     */
+    inline CounterBlock multiplyWide(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+        // __extension__ keeps -pedantic quiet about the non-ISO type
+        __extension__ typedef unsigned __int128 uint128;
+        uint128 product = static_cast<uint128>(a) * b;
+        return CounterBlock{static_cast<uint64_t>(product >> 64), static_cast<uint64_t>(product)};
+#else
+        uint64_t aLow = a & 0xFFFFFFFFULL, aHigh = a >> 32;
+        uint64_t bLow = b & 0xFFFFFFFFULL, bHigh = b >> 32;
+        uint64_t lowLow = aLow * bLow;
+        uint64_t highLow = aHigh * bLow;
+        uint64_t lowHigh = aLow * bHigh;
+        uint64_t middle = (lowLow >> 32) + (highLow & 0xFFFFFFFFULL) + lowHigh;
+        return CounterBlock{aHigh * bHigh + (highLow >> 32) + (middle >> 32), (middle << 32) | (lowLow & 0xFFFFFFFFULL)};
+#endif
+    }
+
+    /**
+     * @brief Philox2x64-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+     *
+     * A keyed bijection of a 128-bit counter. Every key gives an
+     * independent stream, so the key can name the stream (seed, purpose,
+     * device) and the counter its position within it.
+     */
+    inline CounterBlock philox2x64(uint64_t counterLow, uint64_t counterHigh, uint64_t key) {
+        constexpr uint64_t MULTIPLIER = 0xD2B74407B1CE6E93ULL;
+        constexpr uint64_t KEY_STEP = 0x9E3779B97F4A7C15ULL;
+        for (int round = 0; round < 10; ++round) {
+            CounterBlock product = multiplyWide(MULTIPLIER, counterLow);
+            counterLow = product.first ^ key ^ counterHigh;
+            counterHigh = product.second;
+            key += KEY_STEP;
+        }
+        return CounterBlock{counterLow, counterHigh};
+    }
+
+    /**
+     * @brief What a random stream is used for; part of every stream key
+     *
+     * Values are stored implicitly in checkpoints and seeds, so never
+     * renumber them.
+     */
+    enum class StreamPurpose : uint32_t {
+        SENSOR_NOISE = 1,
+        NETWORK_LINK = 2,     // packet loss and delay, per sending device
+        TIMER_JITTER = 3,
+        ACTUATOR_FAULT = 4,
+        SECURITY_KEYS = 5,    // SecurityManager tokens and keys
+        IPSEC_KEYS = 6,       // IPsec SPIs and fallback keys
+        SENSOR_BANK = 7
+    };
+
+    /**
+     * @brief Key of the stream for (seed, purpose, subject)
+     *
+     * The subject is usually a device handle; 0 names a component-wide
+     * stream.
+     */
+    inline uint64_t streamKey(uint64_t seed, StreamPurpose purpose, uint64_t subject) {
+        return mixBits(seed ^ mixBits((static_cast<uint64_t>(purpose) << 32) ^ subject));
+    }
+
+    namespace detail {
+        inline std::atomic<uint64_t>& globalSeedSlot() {
+            static std::atomic<uint64_t> seed{0x5EEDULL};
+            return seed;
+        }
+    }
+
+    /**
+     * @brief Seed components derive their default streams from at construction
+     *
+     * Set it before building a simulation to make the whole run
+     * reproducible; components built earlier keep their streams.
+     */
+    inline uint64_t getGlobalSeed() { return detail::globalSeedSlot().load(std::memory_order_relaxed); }
+    inline void setGlobalSeed(uint64_t seed) { detail::globalSeedSlot().store(seed, std::memory_order_relaxed); }
+
+    /**
+     * @brief A Philox stream: 16 bytes of state instead of a 5 KB mt19937
+     *
+     * Draw n is philox2x64(n, 0, key), so a stream can be positioned or
+     * checkpointed by its counter alone. A stream is not synchronised;
+     * give each thread or device its own, or claim counters from an
+     * atomic and call philox2x64 directly.
+     */
+    class RandomStream {
+    private:
+        uint64_t key;
+        uint64_t counter;
+
+    public:
+        explicit RandomStream(uint64_t streamKey = 0, uint64_t position = 0) : key(streamKey), counter(position) {}
+
+        uint64_t nextBits() { return philox2x64(counter++, 0, key).first; }
+
+        /**
+         * @brief Uniform double in [0, 1)
+         */
+        double uniform() { return unitInterval(nextBits()); }
+
+        /**
+         * @brief Uniform double in [low, high)
+         */
+        double uniform(double low, double high) { return low + (high - low) * uniform(); }
+
+        /**
+         * @brief Uniform integer in [0, bound) (Lemire's multiply-shift; bound > 0)
+         */
+        uint64_t below(uint64_t bound) {
+            return multiplyWide(nextBits(), bound).first;
+        }
+
+        uint64_t getKey() const { return key; }
+        uint64_t getCounter() const { return counter; }
+        void setCounter(uint64_t position) { counter = position; }
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_COUNTER_RNG_H
@@ -0,0 +1,40 @@
+#ifndef IOT_SIMULATION_FRAME_POOL_H
+#define IOT_SIMULATION_FRAME_POOL_H
+
+#include <cstddef>
+
+namespace iot {
+
+    /**
+     * @brief Size-class free lists for coroutine frames
+     *
+     * Frames are rounded up to a 64-byte class and carved from slabs, so a
+     * million behaviours of one coroutine type share a handful of classes
+     * and a finished frame is reused by the next spawn without touching
+     * the global heap. Frames larger than MAX_POOLED_SIZE go to the heap.
+     * Slab memory is kept for reuse for the life of the process.
+     *
+     * Thread-safe: each class has its own lock, so frames may be freed on
+     * a different thread from the one that allocated them.
+     */
+    class FramePool {
+    public:
+        static constexpr size_t CLASS_SIZE = 64;
+        static constexpr size_t MAX_POOLED_SIZE = 1024;
+
+        struct Stats {
+            size_t liveFrames;      // allocated and not yet freed
+            size_t reservedBytes;   // slab memory owned by the pool
+            size_t slabAllocations;
+            size_t heapFallbacks;   // frames too large to pool
+        };
+
+        static void* allocate(size_t size);
+        static void deallocate(void* frame, size_t size) noexcept;
+
+        static Stats getStats();
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_FRAME_POOL_H
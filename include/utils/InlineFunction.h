@@ -0,0 +1,173 @@
+#ifndef IOT_SIMULATION_INLINE_FUNCTION_H
+#define IOT_SIMULATION_INLINE_FUNCTION_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace iot {
+
+    template <typename Signature, size_t InlineSize = 48>
+    class InlineFunction;
+
+    /**
+     * @brief Move-only callable with inline storage for small captures
+     *
+     * Unlike std::function it never copies the target. Any callable of up
+     * to InlineSize bytes with a non-throwing move is stored in place.
+     * Larger ones fall back to the heap, and each fallback is counted in
+     * heapFallbacks(). Code that must not allocate can check
+     * `static_assert(InlineFunction<...>::fitsInline<F>())`.
+     */
+    template <typename R, typename... Args, size_t InlineSize>
+    class InlineFunction<R(Args...), InlineSize> {
+    private:
+        struct Ops {
+            R (*invoke)(void* storage, Args&&... args);
+            void (*relocate)(void* destination, void* source) noexcept;  // move, then destroy the source
+            void (*destroy)(void* storage) noexcept;
+            bool onHeap;
+        };
+
+        template <typename F>
+        struct InlineOps {
+            static R invoke(void* storage, Args&&... args) {
+                return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
+            }
+            static void relocate(void* destination, void* source) noexcept {
+                new (destination) F(std::move(*static_cast<F*>(source)));
+                static_cast<F*>(source)->~F();
+            }
+            static void destroy(void* storage) noexcept {
+                static_cast<F*>(storage)->~F();
+            }
+            static constexpr Ops table{&invoke, &relocate, &destroy, false};
+        };
+
+        template <typename F>
+        struct HeapOps {
+            static F*& target(void* storage) { return *static_cast<F**>(storage); }
+            static R invoke(void* storage, Args&&... args) {
+                return (*target(storage))(std::forward<Args>(args)...);
+            }
+            static void relocate(void* destination, void* source) noexcept {
+                new (destination) F*(target(source));
+            }
+            static void destroy(void* storage) noexcept {
+                delete target(storage);
+            }
+            static constexpr Ops table{&invoke, &relocate, &destroy, true};
+        };
+
+        alignas(std::max_align_t) unsigned char storage[InlineSize];
+        const Ops* ops;
+
+        static std::atomic<size_t>& fallbackCounter() {
+            static std::atomic<size_t> counter{0};
+            return counter;
+        }
+
+        template <typename F>
+        struct IsStdFunction : std::false_type {};
+        template <typename Signature>
+        struct IsStdFunction<std::function<Signature>> : std::true_type {};
+
+        // Empty std::functions and null pointers become an empty InlineFunction
+        template <typename F>
+        static bool isNullTarget(const F& callable) {
+            if constexpr (IsStdFunction<F>::value || std::is_pointer<F>::value || std::is_member_pointer<F>::value) {
+                return !callable;
+            } else {
+                return false;
+            }
+        }
+
+        void reset() noexcept {
+            if (ops) {
+                ops->destroy(storage);
+                ops = nullptr;
+            }
+        }
+
+    public:
+        /**
+         * @brief Whether a callable of type F is stored without allocating
+         */
+        template <typename F>
+        static constexpr bool fitsInline() {
+            return sizeof(F) <= InlineSize && alignof(F) <= alignof(std::max_align_t) &&
+                   std::is_nothrow_move_constructible<F>::value;
+        }
+
+        /**
+         * @brief Number of callables (of this signature and size) that spilled to the heap
+         */
+        static size_t heapFallbacks() { return fallbackCounter().load(std::memory_order_relaxed); }
+
+        InlineFunction() noexcept : ops(nullptr) {}
+        InlineFunction(std::nullptr_t) noexcept : ops(nullptr) {}
+
+        template <typename F,
+                  typename Target = typename std::decay<F>::type,
+                  typename = typename std::enable_if<!std::is_same<Target, InlineFunction>::value>::type>
+        InlineFunction(F&& callable) : ops(nullptr) {
+            if (isNullTarget<Target>(callable)) {
+                return;
+            }
+            if constexpr (fitsInline<Target>()) {
+                new (storage) Target(std::forward<F>(callable));
+                ops = &InlineOps<Target>::table;
+            } else {
+                new (storage) Target*(new Target(std::forward<F>(callable)));
+                ops = &HeapOps<Target>::table;
+                fallbackCounter().fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        InlineFunction(InlineFunction&& other) noexcept : ops(other.ops) {
+            if (ops) {
+                ops->relocate(storage, other.storage);
+                other.ops = nullptr;
+            }
+        }
+
+        InlineFunction& operator=(InlineFunction&& other) noexcept {
+            if (this != &other) {
+                reset();
+                if (other.ops) {
+                    other.ops->relocate(storage, other.storage);
+                    ops = other.ops;
+                    other.ops = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        InlineFunction& operator=(std::nullptr_t) noexcept {
+            reset();
+            return *this;
+        }
+
+        InlineFunction(const InlineFunction&) = delete;
+        InlineFunction& operator=(const InlineFunction&) = delete;
+
+        ~InlineFunction() { reset(); }
+
+        R operator()(Args... args) {
+            return ops->invoke(storage, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const noexcept { return ops != nullptr; }
+
+        /**
+         * @brief Check whether the current target lives in the inline buffer
+         */
+        bool isInline() const noexcept { return ops && !ops->onHeap; }
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_INLINE_FUNCTION_H
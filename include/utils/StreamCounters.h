@@ -0,0 +1,84 @@
+#ifndef IOT_SIMULATION_STREAM_COUNTERS_H
+#define IOT_SIMULATION_STREAM_COUNTERS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace iot {
+
+    /**
+     * @brief Per-device draw counters that grow without locks
+     *
+     * Indexed by device handle. Counters live in fixed chunks allocated on
+     * first use and published with a compare-and-swap, so concurrent
+     * senders never block each other and a counter never moves. Handles
+     * past capacity() have no counter; callers fall back to a shared one.
+     */
+    class StreamCounters {
+    public:
+        static constexpr size_t CHUNK_SIZE = 4096;
+        static constexpr size_t MAX_CHUNKS = 4096;
+
+    private:
+        using Chunk = std::array<std::atomic<uint64_t>, CHUNK_SIZE>;
+        std::array<std::atomic<Chunk*>, MAX_CHUNKS> chunks{};
+
+        Chunk* chunkFor(size_t index, bool create) {
+            std::atomic<Chunk*>& slot = chunks[index / CHUNK_SIZE];
+            Chunk* chunk = slot.load(std::memory_order_acquire);
+            if (chunk || !create) return chunk;
+
+            Chunk* fresh = new Chunk();
+            for (auto& counter : *fresh) counter.store(0, std::memory_order_relaxed);
+            if (slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel)) {
+                return fresh;
+            }
+            delete fresh;  // another thread published first
+            return chunk;
+        }
+
+    public:
+        StreamCounters() = default;
+        ~StreamCounters() {
+            for (auto& slot : chunks) delete slot.load(std::memory_order_relaxed);
+        }
+
+        StreamCounters(const StreamCounters&) = delete;
+        StreamCounters& operator=(const StreamCounters&) = delete;
+
+        static constexpr size_t capacity() { return CHUNK_SIZE * MAX_CHUNKS; }
+
+        /**
+         * @brief Claim the next position of a device's stream
+         */
+        uint64_t next(size_t index) {
+            return (*chunkFor(index, true))[index % CHUNK_SIZE].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint64_t get(size_t index) const {
+            Chunk* chunk = chunks[index / CHUNK_SIZE].load(std::memory_order_acquire);
+            return chunk ? (*chunk)[index % CHUNK_SIZE].load(std::memory_order_relaxed) : 0;
+        }
+
+        void set(size_t index, uint64_t value) {
+            if (value == 0 && !chunks[index / CHUNK_SIZE].load(std::memory_order_acquire)) return;
+            (*chunkFor(index, true))[index % CHUNK_SIZE].store(value, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Zero every counter (not concurrently with next())
+         */
+        void clear() {
+            for (auto& slot : chunks) {
+                if (Chunk* chunk = slot.load(std::memory_order_acquire)) {
+                    for (auto& counter : *chunk) counter.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_STREAM_COUNTERS_H
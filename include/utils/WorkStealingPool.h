@@ -0,0 +1,96 @@
+#ifndef IOT_SIMULATION_WORK_STEALING_POOL_H
+#define IOT_SIMULATION_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iot {
+
+    /**
+     * @brief Fixed thread pool that runs chunked loops with range stealing
+     *
+     * parallelFor splits [0, count) into chunks of `grain` items and deals
+     * each participant (the calling thread plus the workers) an equal run of
+     * chunks. A participant takes chunks from the front of its own run; when
+     * it runs dry it steals the back half of another participant's run.
+     * parallelFor returns only after every chunk has finished, so it doubles
+     * as a barrier.
+     *
+     * One loop runs at a time; tasks must not throw or call parallelFor on
+     * the same pool.
+     */
+    class WorkStealingPool {
+    public:
+        using RangeTask = std::function<void(size_t begin, size_t end)>;
+
+    private:
+        struct alignas(64) ChunkQueue {
+            std::mutex mutex;
+            size_t next = 0;
+            size_t end = 0;
+        };
+
+        std::vector<std::thread> workers;
+        std::unique_ptr<ChunkQueue[]> queues;  // [0] belongs to the calling thread
+        size_t participantCount;
+
+        std::mutex callMutex;  // serialises parallelFor calls
+        std::mutex jobMutex;
+        std::condition_variable jobReady;
+        std::condition_variable jobDone;
+        uint64_t jobGeneration;
+        size_t activeWorkers;
+        bool stopping;
+
+        // Current job, published under jobMutex
+        const RangeTask* currentTask;
+        size_t currentCount;
+        size_t currentGrain;
+
+        std::atomic<size_t> steals;
+
+        void workerLoop(size_t index);
+        void runChunks(size_t index);
+        bool takeChunk(size_t index, size_t& chunk);
+        bool stealChunks(size_t thief);
+
+    public:
+        /**
+         * @brief Constructor
+         * @param threadCount Participants including the caller (0 = hardware concurrency)
+         */
+        explicit WorkStealingPool(size_t threadCount = 0);
+
+        /**
+         * @brief Destructor
+         */
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        /**
+         * @brief Run task over [0, count) in chunks of grain items and wait for all of them
+         */
+        void parallelFor(size_t count, size_t grain, const RangeTask& task);
+
+        /**
+         * @brief Number of threads that execute chunks, including the caller
+         */
+        size_t getThreadCount() const { return participantCount; }
+
+        /**
+         * @brief Number of successful steals since construction
+         */
+        size_t getStealCount() const { return steals.load(std::memory_order_relaxed); }
+    };
+
+} // namespace iot
+
+#endif // IOT_SIMULATION_WORK_STEALING_POOL_H
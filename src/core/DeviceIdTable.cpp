@@ -0,0 +1,79 @@
+#include "../../include/core/DeviceIdTable.h"
+#include "../../include/utils/CheckpointStream.h"
+#include <mutex>
+
+namespace iot {
+
+    DeviceHandle DeviceIdTable::intern(const std::string& deviceId) {
+        {
+            std::shared_lock<std::shared_mutex> lock(tableMutex);
+            auto it = handles.find(deviceId);
+            if (it != handles.end()) {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(tableMutex);
+        auto it = handles.find(deviceId);
+        if (it != handles.end()) {
+            return it->second;  // interned by another thread meanwhile
+        }
+
+        DeviceHandle handle(static_cast<uint32_t>(ids.size()));
+        ids.push_back(deviceId);
+        handles.emplace(deviceId, handle);
+        return handle;
+    }
+
+    DeviceHandle DeviceIdTable::find(const std::string& deviceId) const {
+        std::shared_lock<std::shared_mutex> lock(tableMutex);
+        auto it = handles.find(deviceId);
+        if (it != handles.end()) {
+            return it->second;
+        }
+        return DeviceHandle();
+    }
+
+    const std::string& DeviceIdTable::name(DeviceHandle handle) const {
+        static const std::string unknown;
+
+        std::shared_lock<std::shared_mutex> lock(tableMutex);
+        if (!handle.isValid() || handle.index() >= ids.size()) {
+            return unknown;
+        }
+        return ids[handle.index()];
+    }
+
+    size_t DeviceIdTable::size() const {
+        std::shared_lock<std::shared_mutex> lock(tableMutex);
+        return ids.size();
+    }
+
+    void DeviceIdTable::writeCheckpoint(CheckpointWriter& out) const {
+        std::shared_lock<std::shared_mutex> lock(tableMutex);
+        out.writeVarint(ids.size());
+        for (const auto& id : ids) {
+            out.writeString(id);
+        }
+    }
+
+    bool DeviceIdTable::readCheckpoint(CheckpointReader& in) {
+        size_t count = in.readCount();
+        std::unique_lock<std::shared_mutex> lock(tableMutex);
+        handles.reserve(count);
+        for (size_t i = 0; i < count && in.ok(); ++i) {
+            std::string id = in.readString();
+            if (i < ids.size()) {
+                if (ids[i] != id) in.fail();
+                continue;
+            }
+            if (!handles.emplace(id, DeviceHandle(static_cast<uint32_t>(i))).second) {
+                in.fail();  // duplicate ID
+                break;
+            }
+            ids.push_back(std::move(id));
+        }
+        return in.ok();
+    }
+
+} // namespace iot
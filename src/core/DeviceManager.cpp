@@ -7,7 +7,10 @@
 namespace iot
 {
     DeviceManager::DeviceManager()
-        : nextId(1){}
+        : idTable(std::make_shared<DeviceIdTable>())
+        , randomSeed(getGlobalSeed())
+        , registrationVersion(0)
+        , nextId(1){}
 
     bool DeviceManager::registerDevice(std::shared_ptr<IoTDevice> device){
         if(!device){
@@ -17,77 +20,150 @@ namespace iot
 
         std::lock_guard<std::mutex> lock(devicesMutex);
         std::string deviceId = device->getDeviceId();
+        DeviceHandle handle = idTable->intern(deviceId);
 
-        if(devices.find(deviceId) != devices.end()){
+        if(handle.index() < devices.size() && devices[handle.index()]){
             std::cerr << "Error : Device With ID" << deviceId << "already exists" << std::endl;
             return false;
         }
 
-        devices[deviceId] = device;
-        deviceIds.push_back(deviceId);
+        if(handle.index() >= devices.size()){
+            devices.resize(handle.index() + 1);
+        }
+        devices[handle.index()] = device;
+        device->setHandle(handle);
+        device->setRandomSeed(randomSeed);
+        if (simClock) {
+            device->setSimClock(simClock);
+        }
+        registeredHandles.push_back(handle);
+        registrationVersion.fetch_add(1, std::memory_order_release);
         std::cout << "Device registred: " << deviceId << std::endl;
         return true;
     }
 
+    size_t DeviceManager::registerDevices(const std::vector<std::shared_ptr<IoTDevice>>& newDevices){
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        registeredHandles.reserve(registeredHandles.size() + newDevices.size());
+        devices.reserve(std::max(devices.size(), idTable->size() + newDevices.size()));
+
+        size_t registered = 0;
+        for (const auto& device : newDevices){
+            if (!device) continue;
+            DeviceHandle handle = idTable->intern(device->getDeviceId());
+            if (handle.index() >= devices.size()){
+                devices.resize(handle.index() + 1);
+            } else if (devices[handle.index()]){
+                std::cerr << "Error : Device With ID" << device->getDeviceId() << "already exists" << std::endl;
+                continue;
+            }
+            devices[handle.index()] = device;
+            device->setHandle(handle);
+            device->setRandomSeed(randomSeed);
+            if (simClock) {
+                device->setSimClock(simClock);
+            }
+            registeredHandles.push_back(handle);
+            registered++;
+        }
+        registrationVersion.fetch_add(1, std::memory_order_release);
+        std::cout << "Devices registred: " << registered << std::endl;
+        return registered;
+    }
+
     bool DeviceManager::unregisterDevice(const std::string& deviceId){
-        auto it = devices.find(deviceId);
-        if(it == devices.end()){
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        DeviceHandle handle = idTable->find(deviceId);
+        if(!handle.isValid() || handle.index() >= devices.size() || !devices[handle.index()]){
             std::cerr << "Error: Device" << deviceId << "not found" << std::endl;
             return false;
         }
 
-        devices.erase(it);
-        deviceIds.erase(std::remove(deviceIds.begin(), deviceIds.end(), deviceId), deviceIds.end());
+        devices[handle.index()].reset();
+        registeredHandles.erase(std::remove(registeredHandles.begin(), registeredHandles.end(), handle),
+                                registeredHandles.end());
+        registrationVersion.fetch_add(1, std::memory_order_release);
         std::cout << "Device unregistred: " << deviceId << std::endl;
         return true;
     }
 
     std::shared_ptr<IoTDevice> DeviceManager::getDevice(const std::string& deviceId) const{
+        return getDevice(idTable->find(deviceId));
+    }
+
+    std::shared_ptr<IoTDevice> DeviceManager::getDevice(DeviceHandle handle) const{
         std::lock_guard<std::mutex> lock(devicesMutex);
 
-        auto it = devices.find(deviceId);
-        if (it != devices.end()){
-            return it->second;
+        if (handle.isValid() && handle.index() < devices.size()){
+            return devices[handle.index()];
         }
         return nullptr;
     }
 
+    DeviceHandle DeviceManager::getHandle(const std::string& deviceId) const {
+        return idTable->find(deviceId);
+    }
+
+    DeviceHandle DeviceManager::internDeviceId(const std::string& deviceId) {
+        return idTable->intern(deviceId);
+    }
+
+    const std::string& DeviceManager::getDeviceId(DeviceHandle handle) const {
+        return idTable->name(handle);
+    }
+
     std::vector<std::shared_ptr<IoTDevice>> DeviceManager::getAllDevices() const{
         std::lock_guard<std::mutex> lock(devicesMutex);
         std::vector<std::shared_ptr<IoTDevice>> result;
+        result.reserve(registeredHandles.size());
 
-        for (const auto& pair : devices){
-            result.push_back(pair.second);
+        for (DeviceHandle handle : registeredHandles){
+            result.push_back(devices[handle.index()]);
         }
         return result;
     }
 
     std::vector<std::string> DeviceManager::getDeviceIds() const {
         std::lock_guard<std::mutex> lock(devicesMutex);
-        return deviceIds;
+        std::vector<std::string> result;
+        result.reserve(registeredHandles.size());
+
+        for (DeviceHandle handle : registeredHandles){
+            result.push_back(devices[handle.index()]->getDeviceId());
+        }
+        return result;
+    }
+
+    std::vector<DeviceHandle> DeviceManager::getDeviceHandles() const {
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        return registeredHandles;
     }
     
     bool DeviceManager::deviceExists(const std::string& deviceId) const {
+        return deviceExists(idTable->find(deviceId));
+    }
+
+    bool DeviceManager::deviceExists(DeviceHandle handle) const {
         std::lock_guard<std::mutex> lock(devicesMutex);
-        return devices.find(deviceId) != devices.end();
+        return handle.isValid() && handle.index() < devices.size() && devices[handle.index()] != nullptr;
     }
     
     size_t DeviceManager::getDeviceCount() const {
         std::lock_guard<std::mutex> lock(devicesMutex);
-        return devices.size();
+        return registeredHandles.size();
     }
     void DeviceManager::printStats() const {
     std::lock_guard<std::mutex> lock(devicesMutex);
     
     std::cout << "\n=== Device Manager Statistics ===" << std::endl;
-    std::cout << "Total Devices Registered: " << devices.size() << std::endl;
-    std::cout << "Active Devices: " << std::count_if(devices.begin(), devices.end(),
-        [](const auto& pair) { return pair.second->isActiveDevice(); }) << std::endl;
+    std::cout << "Total Devices Registered: " << registeredHandles.size() << std::endl;
+    std::cout << "Active Devices: " << std::count_if(registeredHandles.begin(), registeredHandles.end(),
+        [this](DeviceHandle handle) { return devices[handle.index()]->isActiveDevice(); }) << std::endl;
     std::cout << "Device Types:";
     
     std::map<std::string, int> deviceTypeCount;
-    for (const auto& pair : devices) {
-        deviceTypeCount[pair.second->getDeviceType()]++;
+    for (DeviceHandle handle : registeredHandles) {
+        deviceTypeCount[devices[handle.index()]->getDeviceType()]++;
     }
     
     for (const auto& typePair : deviceTypeCount) {
@@ -102,8 +178,16 @@ namespace iot
     }
 
     bool DeviceManager::sendMessageToDevice(const Message& message){
-        std::string destID = message.getDestinationDeviceId();
-        auto device = getDevice(destID);
+        DeviceHandle handle = message.getDestinationHandle();
+        if(!handle.isValid()){
+            handle = idTable->find(message.getDestinationDeviceId());
+        }
+        return sendMessageToDevice(handle, message);
+    }
+
+    bool DeviceManager::sendMessageToDevice(DeviceHandle handle, const Message& message){
+        auto device = getDevice(handle);
+        const std::string& destID = message.getDestinationDeviceId();
 
         if(!device){
             std::cerr << "Error: Destionation Deive: " << destID << "not found" << std::endl;
@@ -119,26 +203,52 @@ namespace iot
         }
     }
     void DeviceManager::broadcastMessage(const Message& message) {
-        std::lock_guard<std::mutex> lock(devicesMutex);
+        DeviceHandle source = message.getSourceHandle();
+        if (!source.isValid()) {
+            source = idTable->find(message.getSourceDeviceId());
+        }
         
-        for (const auto& pair : devices) {
+        // Snapshot under the lock, deliver outside it so slow devices do not
+        // block registration or lookups
+        for (const auto& device : getAllDevices()) {
             try {
                 // Don't send message back to source device
-                if (pair.first != message.getSourceDeviceId()) {
-                    pair.second->receiveData(message);
+                if (device->getHandle() != source) {
+                    device->receiveData(message);
                 }
             } catch (const std::exception& e) {
-                std::cerr << "Error broadcasting to " << pair.first << ": " << e.what() << std::endl;
+                std::cerr << "Error broadcasting to " << device->getDeviceId() << ": " << e.what() << std::endl;
             }
         }
     }
     
+    void DeviceManager::setSimClock(std::shared_ptr<const SimClock> clock) {
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        simClock = clock;
+        for (DeviceHandle handle : registeredHandles) {
+            devices[handle.index()]->setSimClock(simClock);
+        }
+    }
+    
+    void DeviceManager::setRandomSeed(uint64_t seed) {
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        randomSeed = seed;
+        for (DeviceHandle handle : registeredHandles) {
+            devices[handle.index()]->setRandomSeed(randomSeed);
+        }
+    }
+    
+    uint64_t DeviceManager::getRandomSeed() const {
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        return randomSeed;
+    }
+    
     void DeviceManager::listDevices() const {
         std::lock_guard<std::mutex> lock(devicesMutex);
-        std::cout << "\n=== Registered Devices (" << devices.size() << ") ===" << std::endl;
+        std::cout << "\n=== Registered Devices (" << registeredHandles.size() << ") ===" << std::endl;
         
-        for (const auto& pair : devices) {
-            std::cout << pair.second->getStatus() << std::endl;
+        for (DeviceHandle handle : registeredHandles) {
+            std::cout << devices[handle.index()]->getStatus() << std::endl;
         }
         std::cout << "=========================" << std::endl;
     }
@@ -1,8 +1,11 @@
 #include "../../include/core/IoTDevice.h"
 #include "../../include/core/Message.h"
+#include "../../include/simulation/SimClock.h"
+#include "../../include/utils/CheckpointStream.h"
 #include <sstream>
 #include <iomanip>
 #include <iostream>
+#include <functional>
 
 namespace iot{
     IoTDevice::IoTDevice(const std::string& id, const std::string& type, const std::string& name)
@@ -10,7 +13,18 @@ namespace iot{
         , deviceType(type)
         , deviceName(name)
         , isActive(true)
-        , lastUpdate(std::chrono::steady_clock::now()){}
+        , lastUpdate(std::chrono::steady_clock::now())
+        , simClock(SimClock::wallClock()){}
+
+    uint64_t IoTDevice::randomStreamKey(uint64_t seed, StreamPurpose purpose) const{
+        uint64_t subject = handle.isValid() ? handle.value
+                                            : (std::hash<std::string>{}(deviceId) | (uint64_t(1) << 63));
+        return streamKey(seed, purpose, subject);
+    }
+
+    void IoTDevice::setSimClock(std::shared_ptr<const SimClock> clock){
+        simClock = clock ? std::move(clock) : SimClock::wallClock();
+    }
 
 
     std::string IoTDevice::getStatus() const{
@@ -25,4 +39,22 @@ namespace iot{
     void IoTDevice::update(){
         lastUpdate = std::chrono::steady_clock::now();
     }
+
+    size_t IoTDevice::takeOutbox(std::vector<Message>& out){
+        size_t count = outbox.size();
+        for (auto& message : outbox) {
+            out.push_back(std::move(message));
+        }
+        outbox.clear();
+        return count;
+    }
+
+    void IoTDevice::writeState(CheckpointWriter& out) const{
+        out.writeBool(isActive);
+    }
+
+    bool IoTDevice::readState(CheckpointReader& in){
+        isActive = in.readBool();
+        return in.ok();
+    }
     }
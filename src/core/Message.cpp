@@ -1,33 +1,127 @@
 #include "../../include/core/Message.h"
 #include <sstream>
 #include <iomanip>
-#include <random>
+#include <atomic>
 #include <algorithm>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace iot
 {
+    namespace {
+        constexpr int SEQUENCE_BITS = 40;
+        constexpr int THREAD_BITS = 16;
+        constexpr uint64_t SEQUENCE_MASK = (uint64_t(1) << SEQUENCE_BITS) - 1;
+        constexpr uint64_t THREAD_MASK = (uint64_t(1) << THREAD_BITS) - 1;
+
+        // The last slot is shared by threads that find every other slot taken
+        constexpr uint64_t SHARED_SLOT = THREAD_MASK;
+
+        std::atomic<uint8_t> currentNodeId{0};
+        std::atomic<uint64_t> sharedSequence{0};
+
+        /**
+         * @brief Thread slots released by exited threads, with the sequence they reached
+         *
+         * A new thread takes a released slot before an unused one and
+         * continues its sequence, so IDs are never issued twice however many
+         * threads come and go. Never destroyed: threads may exit during
+         * static destruction.
+         */
+        struct SlotPool {
+            std::mutex mutex;
+            std::vector<std::pair<uint64_t, uint64_t>> released;  // (slot, last sequence)
+            uint64_t nextUnused = 0;
+        };
+
+        SlotPool& slotPool() {
+            static SlotPool* pool = new SlotPool();
+            return *pool;
+        }
+
+        struct ThreadSlot {
+            uint64_t slot = SHARED_SLOT;
+            uint64_t sequence = 0;
+
+            ThreadSlot() {
+                SlotPool& pool = slotPool();
+                std::lock_guard<std::mutex> lock(pool.mutex);
+                if (!pool.released.empty()) {
+                    std::tie(slot, sequence) = pool.released.back();
+                    pool.released.pop_back();
+                } else if (pool.nextUnused < SHARED_SLOT) {
+                    slot = pool.nextUnused++;
+                }
+            }
+
+            ~ThreadSlot() {
+                if (slot == SHARED_SLOT) return;
+                SlotPool& pool = slotPool();
+                std::lock_guard<std::mutex> lock(pool.mutex);
+                pool.released.emplace_back(slot, sequence);
+            }
+        };
+    }
+
+    uint64_t Message::nextMessageId() {
+        // Each thread holds a slot for its lifetime; after that an ID is a local increment
+        thread_local ThreadSlot thread;
+
+        uint64_t sequence = thread.slot == SHARED_SLOT
+            ? sharedSequence.fetch_add(1, std::memory_order_relaxed) + 1
+            : ++thread.sequence;
+        uint64_t node = currentNodeId.load(std::memory_order_relaxed);
+        return (node << (THREAD_BITS + SEQUENCE_BITS))
+             | (thread.slot << SEQUENCE_BITS)
+             | (sequence & SEQUENCE_MASK);
+    }
+
+    void Message::setNodeId(uint8_t nodeId) {
+        currentNodeId.store(nodeId, std::memory_order_relaxed);
+    }
+
+    std::string Message::formatMessageId(uint64_t id) {
+        return "MSG_" + std::to_string(id >> (THREAD_BITS + SEQUENCE_BITS))
+             + "-" + std::to_string((id >> SEQUENCE_BITS) & THREAD_MASK)
+             + "-" + std::to_string(id & SEQUENCE_MASK);
+    }
+
     Message::Message(const std::string& sourceId, 
                 const std::string& destId,
                 const std::string& data,
                 MessageType msgType)
-        : sourceDeviceId(sourceId),
+        : Message(sourceId, destId, std::make_shared<const std::string>(data), msgType){}
+
+    Message::Message(const std::string& sourceId, 
+                const std::string& destId,
+                std::shared_ptr<const std::string> sharedPayload,
+                MessageType msgType)
+        : messageId(nextMessageId()),
+        sourceDeviceId(sourceId),
         destinationDeviceId(destId),
-        payload(data),
+        payload(sharedPayload ? std::move(sharedPayload) : std::make_shared<const std::string>()),
         type(msgType),
-        timestamp(std::chrono::steady_clock::now()){
-        
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<> dis(100000,999999);
-        messageId = "MSG_" + std::to_string(dis(gen));
+        timestamp(std::chrono::steady_clock::now()){}
+
+     void Message::setPayload(std::shared_ptr<const std::string> data){
+        payload = data ? std::move(data) : std::make_shared<const std::string>();
      }
 
      void Message::addHeader(const std::string& key, const std::string& value){
-        headers[key] = value;
+        auto it = std::find_if(headers.begin(), headers.end(),
+            [&key](const auto& header){ return header.first == key; });
+        if(it != headers.end()){
+            it->second = value;
+        } else {
+            headers.emplace_back(key, value);
+        }
      }
 
      std::string Message::getHeader(const std::string& key) const {
-        auto it = headers.find(key);
+        auto it = std::find_if(headers.begin(), headers.end(),
+            [&key](const auto& header){ return header.first == key; });
         if(it != headers.end()){
             return it->second;
         }
@@ -35,15 +129,16 @@ namespace iot
      }
 
      bool Message::hasHeader(const std::string& key) const{
-        return headers.find(key) != headers.end();
+        return std::find_if(headers.begin(), headers.end(),
+            [&key](const auto& header){ return header.first == key; }) != headers.end();
      }
      std::string Message::toString() const {
         std::ostringstream oss;
-        oss << "Message[ID: " << messageId 
+        oss << "Message[ID: " << formatMessageId(messageId) 
             << ", From: " << sourceDeviceId 
             << ", To: " << destinationDeviceId 
             << ", Type: " << static_cast<int>(type)
-            << ", Payload: " << payload << "]";
+            << ", Payload: " << getPayload() << "]";
         return oss.str();
     }
   } // namespace iot
@@ -1,5 +1,6 @@
 #include "../../include/devices/Actuator.h"
 #include "../../include/core/Message.h"
+#include "../../include/utils/CheckpointStream.h"
 #include <iostream>
 #include <algorithm>
 
@@ -73,4 +74,15 @@ namespace iot {
                  << (state ? "ON" : "OFF") << std::endl;
     }
     
+    void Actuator::writeState(CheckpointWriter& out) const {
+        IoTDevice::writeState(out);
+        out.writeBool(state);
+    }
+    
+    bool Actuator::readState(CheckpointReader& in) {
+        IoTDevice::readState(in);
+        state = in.readBool();  // restored silently, unlike setState
+        return in.ok();
+    }
+    
 } // namespace iot
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "../../include/devices/BatteryManager.h"
+#include "../../include/utils/CheckpointStream.h"
 #include <algorithm>
 #include <iostream>
 
@@ -49,4 +50,17 @@ namespace iot {
         }
     }
     
+    void BatteryManager::writeState(CheckpointWriter& out) const {
+        out.writeDouble(batteryLevel);
+        out.writeDouble(powerConsumption);
+        out.writeBool(lowPowerMode);
+    }
+    
+    bool BatteryManager::readState(CheckpointReader& in) {
+        batteryLevel = in.readDouble();
+        powerConsumption = in.readDouble();
+        lowPowerMode = in.readBool();
+        return in.ok();
+    }
+    
 } // namespace iot
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "../../include/devices/BatterySensors.h"
+#include "../../include/simulation/SimClock.h"
+#include "../../include/utils/CheckpointStream.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -9,26 +11,24 @@ namespace iot {
     BatteryTemperatureSensor::BatteryTemperatureSensor(const std::string& id, const std::string& name)
         :Sensor(id, name, -40.0, 85.0)
         , battery()
-        , baselineTemp(22.0)
-        , rng(std::random_device{}())
-        , noiseDistribution(-0.1, 0.1) {
+        , baselineTemp(22.0) {
         battery.setPowerConsumption(0.05);  // Low power consumption for temperature sensor
     }
     
-    double BatteryTemperatureSensor::readValue() {
-        // Simulate realistic temperature variations
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        std::tm* tm = std::localtime(&time_t);
-        
+    double BatteryTemperatureSensor::measure() {
         // Daily temperature cycle (cooler at night, warmer at day)
-        double hourFactor = std::sin((tm->tm_hour - 6) * M_PI / 12.0) * 2.0;
+        double hourFactor = simClock->getTemperatureFactor();
         
         // Random noise
-        double noise = noiseDistribution(rng) * 3.0;
+        double noise = rng.uniform(-0.1, 0.1) * 3.0;
         
         currentValue = baselineTemp + hourFactor + noise;
         currentValue = std::max(minValue, std::min(maxValue, currentValue));
+        return currentValue;
+    }
+    
+    double BatteryTemperatureSensor::readValue() {
+        measure();
         
         // Consume battery power for reading
         battery.consumePower(battery.getPowerConsumption() * 0.1);  // Very low power for reading
@@ -65,8 +65,6 @@ namespace iot {
         : Sensor(id, name, 0.0, 1.0)
         , battery()
         , lastMotionState(false)
-        , motionProbability(0.0, 1.0)
-        , rng(std::random_device{}())
         , sleepInterval(30)   // 30 seconds sleep
         , activeDuration(5)   // 5 seconds active
     {
@@ -80,19 +78,26 @@ namespace iot {
             return 0.0;
         }
         
+        double motion = measure();
+        
         // Consume battery power for active sensing
         battery.consumePower(battery.getPowerConsumption() * 0.1);
         
-        // Motion sensors return binary values (0 = no motion, 1 = motion detected)
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        std::tm* tm = std::localtime(&time_t);
+        return motion;
+    }
+    
+    double BatteryMotionSensor::measure() {
+        // A flat battery detects nothing (readValue reports it)
+        if (battery.getBatteryLevel() < 5.0) {
+            return 0.0;
+        }
         
+        // Motion sensors return binary values (0 = no motion, 1 = motion detected)
         // Higher probability of motion during day hours
-        double baseProbability = (tm->tm_hour >= 8 && tm->tm_hour <= 22) ? 0.15 : 0.05;
+        double baseProbability = simClock->isDaytime() ? 0.15 : 0.05;
         
         // Add some randomness
-        double randomValue = motionProbability(rng);
+        double randomValue = rng.uniform();
         
         currentValue = (randomValue < baseProbability) ? 1.0 : 0.0;
         
@@ -130,4 +135,31 @@ namespace iot {
                  << "s sleep, " << activeDuration << "s active" << std::endl;
     }
     
+    void BatteryTemperatureSensor::writeState(CheckpointWriter& out) const {
+        Sensor::writeState(out);
+        battery.writeState(out);
+    }
+    
+    bool BatteryTemperatureSensor::readState(CheckpointReader& in) {
+        Sensor::readState(in);
+        return battery.readState(in);
+    }
+    
+    void BatteryMotionSensor::writeState(CheckpointWriter& out) const {
+        Sensor::writeState(out);
+        battery.writeState(out);
+        out.writeBool(lastMotionState);
+        out.writeSigned(sleepInterval);
+        out.writeSigned(activeDuration);
+    }
+    
+    bool BatteryMotionSensor::readState(CheckpointReader& in) {
+        Sensor::readState(in);
+        battery.readState(in);
+        lastMotionState = in.readBool();
+        sleepInterval = static_cast<int>(in.readSigned());
+        activeDuration = static_cast<int>(in.readSigned());
+        return in.ok();
+    }
+    
 } // namespace iot
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "../../include/devices/ConcreteActuators.h"
+#include "../../include/utils/CheckpointStream.h"
 #include <iostream>
 #include <algorithm>
-#include <random>
 namespace iot {
     
     // LED Implementation
@@ -67,7 +67,8 @@ namespace iot {
         : Actuator(id, name)
         , current(0.0)
         , maxCurrent(maxCurr)
-        , overloadProtection(true) {
+        , overloadProtection(true)
+        , overloadRng(randomStreamKey(getGlobalSeed(), StreamPurpose::ACTUATOR_FAULT)) {
     }
     
     void Relay::setState(bool newState) {
@@ -85,11 +86,54 @@ namespace iot {
     
     bool Relay::isOverloaded() const {
         // Simulate random overload conditions
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_real_distribution<> dis(0.0, 1.0);
-        
-        return (dis(gen) < 0.05);  // 5% chance of overload
+        return (overloadRng.uniform() < 0.05);  // 5% chance of overload
+    }
+    
+    void Relay::setRandomSeed(uint64_t seed) {
+        overloadRng = RandomStream(randomStreamKey(seed, StreamPurpose::ACTUATOR_FAULT));
+    }
+    
+    void LED::writeState(CheckpointWriter& out) const {
+        Actuator::writeState(out);
+        out.writeSigned(brightness);
+        out.writeString(color);
+    }
+    
+    bool LED::readState(CheckpointReader& in) {
+        Actuator::readState(in);
+        brightness = static_cast<int>(in.readSigned());
+        color = in.readString();
+        return in.ok();
+    }
+    
+    void Motor::writeState(CheckpointWriter& out) const {
+        Actuator::writeState(out);
+        out.writeSigned(speed);
+        out.writeSigned(maxSpeed);
+    }
+    
+    bool Motor::readState(CheckpointReader& in) {
+        Actuator::readState(in);
+        speed = static_cast<int>(in.readSigned());
+        maxSpeed = static_cast<int>(in.readSigned());
+        return in.ok();
+    }
+    
+    void Relay::writeState(CheckpointWriter& out) const {
+        Actuator::writeState(out);
+        out.writeDouble(current);
+        out.writeDouble(maxCurrent);
+        out.writeBool(overloadProtection);
+        out.writeVarint(overloadRng.getCounter());
+    }
+    
+    bool Relay::readState(CheckpointReader& in) {
+        Actuator::readState(in);
+        current = in.readDouble();
+        maxCurrent = in.readDouble();
+        overloadProtection = in.readBool();
+        overloadRng.setCounter(in.readVarint());
+        return in.ok();
     }
     
 } // namespace iot
\ No newline at end of file
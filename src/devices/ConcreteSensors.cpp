@@ -1,7 +1,7 @@
 #include "../../include/devices/ConcreteSensors.h"
+#include "../../include/simulation/SimClock.h"
 #include <iostream>
 #include <cmath>
-#include <ctime>
 
 namespace iot {
     
@@ -12,16 +12,11 @@ namespace iot {
     }
     
     double TemperatureSensor::readValue() {
-        // Simulate realistic temperature variations
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        std::tm* tm = std::localtime(&time_t);
-        
         // Daily temperature cycle (cooler at night, warmer at day)
-        double hourFactor = std::sin((tm->tm_hour - 6) * M_PI / 12.0) * 2.0;
+        double hourFactor = simClock->getTemperatureFactor();
         
         // Random noise
-        double noise = noiseDistribution(rng) * 3.0;
+        double noise = rng.uniform(-0.1, 0.1) * 3.0;
         
         currentValue = baselineTemp + hourFactor + noise;
         
@@ -38,16 +33,11 @@ namespace iot {
     }
     
     double HumiditySensor::readValue() {
-        // Simulate humidity variations
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        std::tm* tm = std::localtime(&time_t);
-        
         // Inverse relationship with temperature
-        double timeFactor = std::cos((tm->tm_hour - 6) * M_PI / 12.0) * 5.0;
+        double timeFactor = simClock->getHumidityFactor();
         
         // Random noise
-        double noise = noiseDistribution(rng) * 8.0;
+        double noise = rng.uniform(-0.1, 0.1) * 8.0;
         
         currentValue = baselineHumidity + timeFactor + noise;
         
@@ -60,21 +50,16 @@ namespace iot {
     // Motion Sensor Implementation
     MotionSensor::MotionSensor(const std::string& id, const std::string& name)
         : Sensor(id, name, 0.0, 1.0)  // Properly initialize Sensor base class
-        , lastMotionState(false)
-        , motionProbability(0.0, 1.0) {
+        , lastMotionState(false) {
     }
     
     double MotionSensor::readValue() {
         // Motion sensors return binary values (0 = no motion, 1 = motion detected)
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        std::tm* tm = std::localtime(&time_t);
-        
         // Higher probability of motion during day hours
-        double baseProbability = (tm->tm_hour >= 8 && tm->tm_hour <= 22) ? 0.15 : 0.05;
+        double baseProbability = simClock->isDaytime() ? 0.15 : 0.05;
         
         // Add some randomness
-        double randomValue = motionProbability(rng);
+        double randomValue = rng.uniform();
         
         currentValue = (randomValue < baseProbability) ? 1.0 : 0.0;
         
@@ -1,5 +1,7 @@
 #include "../../include/devices/Sensor.h"
 #include "../../include/core/Message.h"
+#include "../../include/utils/CounterRng.h"
+#include "../../include/utils/CheckpointStream.h"
 #include <iostream>
 #include <sstream>
 
@@ -13,8 +15,7 @@ namespace iot {
         , currentValue(0.0)
         , minValue(minVal)
         , maxValue(maxVal)
-        , rng(std::random_device{}())
-        , noiseDistribution(-0.1, 0.1) {
+        , rng(randomStreamKey(getGlobalSeed(), StreamPurpose::SENSOR_NOISE)) {
     }
     
     void Sensor::sendData() {
@@ -28,6 +29,30 @@ namespace iot {
         std::cout << "Sensor " << getDeviceId() << " sending data: " << currentValue << std::endl;
     }
     
+    double Sensor::sample() {
+        if (isActive) {
+            currentValue = measure();
+        }
+        return currentValue;
+    }
+    
+    void Sensor::setRandomSeed(uint64_t seed) {
+        rng = RandomStream(randomStreamKey(seed, StreamPurpose::SENSOR_NOISE));
+    }
+    
+    void Sensor::writeState(CheckpointWriter& out) const {
+        IoTDevice::writeState(out);
+        out.writeDouble(currentValue);
+        out.writeVarint(rng.getCounter());
+    }
+    
+    bool Sensor::readState(CheckpointReader& in) {
+        IoTDevice::readState(in);
+        currentValue = in.readDouble();
+        rng.setCounter(in.readVarint());
+        return in.ok();
+    }
+    
     void Sensor::receiveData(const Message& message) {
         switch (message.getMessageType()) {
             case Message::MessageType::COMMAND:
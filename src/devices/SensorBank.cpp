@@ -0,0 +1,125 @@
+#include "../../include/devices/SensorBank.h"
+#include "../../include/utils/CounterRng.h"
+#include <algorithm>
+#include <cmath>
+
+namespace iot {
+
+    SensorBank::SensorBank(uint64_t bankSeed)
+        : seed(bankSeed)
+        , hourOfDay(12) {
+        if (seed == 0) {
+            seed = streamKey(getGlobalSeed(), StreamPurpose::SENSOR_BANK, 0);
+        }
+    }
+
+    SensorBank::Slot SensorBank::addSensor(Kind kind, const std::string& deviceId) {
+        Columns& c = columnsFor(kind);
+
+        // Same defaults as TemperatureSensor, HumiditySensor and MotionSensor
+        double baseline = 0.0, minValue = 0.0, maxValue = 1.0;
+        switch (kind) {
+            case Kind::TEMPERATURE: baseline = 22.0; minValue = -40.0; maxValue = 125.0; break;
+            case Kind::HUMIDITY:    baseline = 45.0; minValue = 0.0;   maxValue = 100.0; break;
+            case Kind::MOTION:      baseline = 0.0;  minValue = 0.0;   maxValue = 1.0;   break;
+        }
+
+        c.baseline.push_back(baseline);
+        c.minValue.push_back(minValue);
+        c.maxValue.push_back(maxValue);
+        c.currentValue.push_back(0.0);
+        c.rngCounter.push_back(0);
+        c.deviceIds.push_back(deviceId);
+        return Slot{kind, static_cast<uint32_t>(c.currentValue.size() - 1)};
+    }
+
+    void SensorBank::reserve(Kind kind, size_t count) {
+        Columns& c = columnsFor(kind);
+        c.baseline.reserve(count);
+        c.minValue.reserve(count);
+        c.maxValue.reserve(count);
+        c.currentValue.reserve(count);
+        c.rngCounter.reserve(count);
+        c.deviceIds.reserve(count);
+    }
+
+    size_t SensorBank::size() const {
+        size_t total = 0;
+        for (const auto& c : columns) total += c.currentValue.size();
+        return total;
+    }
+
+    void SensorBank::update(int hour) {
+        hourOfDay = hour;
+
+        // Diurnal terms are shared by every sensor, so they are computed once
+        updateTemperature(std::sin((hour - 6) * M_PI / 12.0) * 2.0);
+        updateHumidity(std::cos((hour - 6) * M_PI / 12.0) * 5.0);
+        updateMotion((hour >= 8 && hour <= 22) ? 0.15 : 0.05);
+    }
+
+    // Each sensor's noise key is mixBits(seed ^ kind << 32 ^ index): derived,
+    // not stored, so the only per-sensor RNG state is its counter
+
+    void SensorBank::updateTemperature(double hourFactor) {
+        Columns& c = columnsFor(Kind::TEMPERATURE);
+        const size_t n = c.currentValue.size();
+        const double* baseline = c.baseline.data();
+        const double* minValue = c.minValue.data();
+        const double* maxValue = c.maxValue.data();
+        double* value = c.currentValue.data();
+        uint64_t* counter = c.rngCounter.data();
+        const uint64_t kindKey = seed ^ (static_cast<uint64_t>(Kind::TEMPERATURE) << 32);
+
+        for (size_t i = 0; i < n; ++i) {
+            double noise = (counterUniform(mixBits(kindKey ^ i), counter[i]++) * 0.2 - 0.1) * 3.0;
+            value[i] = std::max(minValue[i], std::min(maxValue[i], baseline[i] + hourFactor + noise));
+        }
+    }
+
+    void SensorBank::updateHumidity(double timeFactor) {
+        Columns& c = columnsFor(Kind::HUMIDITY);
+        const size_t n = c.currentValue.size();
+        const double* baseline = c.baseline.data();
+        double* value = c.currentValue.data();
+        uint64_t* counter = c.rngCounter.data();
+        const uint64_t kindKey = seed ^ (static_cast<uint64_t>(Kind::HUMIDITY) << 32);
+
+        for (size_t i = 0; i < n; ++i) {
+            double noise = (counterUniform(mixBits(kindKey ^ i), counter[i]++) * 0.2 - 0.1) * 8.0;
+            value[i] = std::max(0.0, std::min(100.0, baseline[i] + timeFactor + noise));
+        }
+    }
+
+    void SensorBank::updateMotion(double probability) {
+        Columns& c = columnsFor(Kind::MOTION);
+        const size_t n = c.currentValue.size();
+        double* value = c.currentValue.data();
+        uint64_t* counter = c.rngCounter.data();
+        const uint64_t kindKey = seed ^ (static_cast<uint64_t>(Kind::MOTION) << 32);
+
+        for (size_t i = 0; i < n; ++i) {
+            value[i] = counterUniform(mixBits(kindKey ^ i), counter[i]++) < probability ? 1.0 : 0.0;
+        }
+    }
+
+    std::shared_ptr<Sensor> SensorBank::exposeSensor(std::shared_ptr<SensorBank> bank, Slot slot,
+                                                     const std::string& name) {
+        return std::make_shared<BankedSensor>(std::move(bank), slot, name);
+    }
+
+    BankedSensor::BankedSensor(std::shared_ptr<SensorBank> sensorBank, SensorBank::Slot bankSlot,
+                               const std::string& name)
+        : Sensor(sensorBank->getDeviceId(bankSlot), name,
+                 sensorBank->getMinValue(bankSlot), sensorBank->getMaxValue(bankSlot))
+        , bank(std::move(sensorBank))
+        , slot(bankSlot) {
+        currentValue = bank->getValue(slot);
+    }
+
+    double BankedSensor::readValue() {
+        currentValue = bank->getValue(slot);
+        return currentValue;
+    }
+
+} // namespace iot
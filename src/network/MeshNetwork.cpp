@@ -1,32 +1,54 @@
 #include "../../include/network/MeshNetwork.h"
+#include "../../include/utils/CheckpointStream.h"
 #include <iostream>
 #include <queue>
 #include <algorithm>
 
 namespace iot {
     
-    MeshNetwork::MeshNetwork(int maxHopCount)
-        : maxHops(maxHopCount)
-        , gatewayId("") {
+    MeshNetwork::MeshNetwork(int maxHopCount, std::shared_ptr<DeviceIdTable> table)
+        : idTable(table ? table : std::make_shared<DeviceIdTable>())
+        , nodeCount(0)
+        , maxHops(maxHopCount) {
+    }
+    
+    MeshNetwork::MeshNode* MeshNetwork::findNode(DeviceHandle handle) {
+        if (!handle.isValid() || handle.index() >= nodes.size() || !nodes[handle.index()].present) {
+            return nullptr;
+        }
+        return &nodes[handle.index()];
+    }
+    
+    const MeshNetwork::MeshNode* MeshNetwork::findNode(DeviceHandle handle) const {
+        if (!handle.isValid() || handle.index() >= nodes.size() || !nodes[handle.index()].present) {
+            return nullptr;
+        }
+        return &nodes[handle.index()];
     }
     
     bool MeshNetwork::addDevice(const std::string& deviceId, bool isGatewayNode) {
-        if (nodes.find(deviceId) != nodes.end()) {
+        DeviceHandle handle = idTable->intern(deviceId);
+        if (findNode(handle)) {
             std::cout << "Device " << deviceId << " already exists in mesh network" << std::endl;
             return false;
         }
         
-        MeshNode node;
-        node.deviceId = deviceId;
+        if (handle.index() >= nodes.size()) {
+            nodes.resize(handle.index() + 1);
+        }
+        
+        MeshNode& node = nodes[handle.index()];
+        node.handle = handle;
+        node.neighbors.clear();
         node.hopCountToGateway = maxHops;  // Initialize to max (unreachable)
         node.isGateway = isGatewayNode;
+        node.present = true;
         node.signalStrength = 100.0;  // Default signal strength
-        
-        nodes[deviceId] = node;
+        nodeCount++;
         
         if (isGatewayNode) {
-            gatewayId = deviceId;
-            nodes[deviceId].hopCountToGateway = 0;  // Gateway has 0 hops to itself
+            gateway = handle;
+            node.hopCountToGateway = 0;  // Gateway has 0 hops to itself
         }
         
         std::cout << "Device " << deviceId << " added to mesh network" 
@@ -34,24 +56,57 @@ namespace iot {
         return true;
     }
     
+    std::vector<std::vector<DeviceHandle>> MeshNetwork::getRegions() const {
+        std::vector<std::vector<DeviceHandle>> regions;
+        std::vector<bool> visited(nodes.size(), false);
+        std::vector<DeviceHandle> frontier;
+        
+        for (const auto& node : nodes) {
+            if (!node.present || visited[node.handle.index()]) continue;
+            
+            // Flood-fill one region
+            std::vector<DeviceHandle> region;
+            visited[node.handle.index()] = true;
+            frontier.push_back(node.handle);
+            while (!frontier.empty()) {
+                DeviceHandle current = frontier.back();
+                frontier.pop_back();
+                region.push_back(current);
+                for (DeviceHandle neighbor : nodes[current.index()].neighbors) {
+                    if (findNode(neighbor) && !visited[neighbor.index()]) {
+                        visited[neighbor.index()] = true;
+                        frontier.push_back(neighbor);
+                    }
+                }
+            }
+            std::sort(region.begin(), region.end());
+            regions.push_back(std::move(region));
+        }
+        
+        std::stable_sort(regions.begin(), regions.end(), [](const auto& a, const auto& b) {
+            return a.size() > b.size();
+        });
+        return regions;
+    }
+    
     bool MeshNetwork::addNeighbor(const std::string& deviceId, const std::string& neighborId) {
-        auto deviceIt = nodes.find(deviceId);
-        auto neighborIt = nodes.find(neighborId);
+        MeshNode* device = findNode(idTable->find(deviceId));
+        MeshNode* neighbor = findNode(idTable->find(neighborId));
         
-        if (deviceIt == nodes.end() || neighborIt == nodes.end()) {
+        if (!device || !neighbor) {
             std::cout << "Cannot add neighbor relationship - device not found" << std::endl;
             return false;
         }
         
         // Add bidirectional relationship
-        if (std::find(deviceIt->second.neighbors.begin(), 
-                     deviceIt->second.neighbors.end(), neighborId) == deviceIt->second.neighbors.end()) {
-            deviceIt->second.neighbors.push_back(neighborId);
+        if (std::find(device->neighbors.begin(), 
+                     device->neighbors.end(), neighbor->handle) == device->neighbors.end()) {
+            device->neighbors.push_back(neighbor->handle);
         }
         
-        if (std::find(neighborIt->second.neighbors.begin(), 
-                     neighborIt->second.neighbors.end(), deviceId) == neighborIt->second.neighbors.end()) {
-            neighborIt->second.neighbors.push_back(deviceId);
+        if (std::find(neighbor->neighbors.begin(), 
+                     neighbor->neighbors.end(), device->handle) == neighbor->neighbors.end()) {
+            neighbor->neighbors.push_back(device->handle);
         }
         
         // Update routing table
@@ -63,27 +118,29 @@ namespace iot {
     }
     
     bool MeshNetwork::removeDevice(const std::string& deviceId) {
-        auto it = nodes.find(deviceId);
-        if (it == nodes.end()) {
+        MeshNode* node = findNode(idTable->find(deviceId));
+        if (!node) {
             std::cout << "Device " << deviceId << " not found in mesh network" << std::endl;
             return false;
         }
         
         // Remove this device from all neighbors' lists
-        for (const std::string& neighborId : it->second.neighbors) {
-            auto neighborIt = nodes.find(neighborId);
-            if (neighborIt != nodes.end()) {
-                auto& neighbors = neighborIt->second.neighbors;
-                neighbors.erase(std::remove(neighbors.begin(), neighbors.end(), deviceId), neighbors.end());
+        for (DeviceHandle neighborHandle : node->neighbors) {
+            MeshNode* neighbor = findNode(neighborHandle);
+            if (neighbor) {
+                auto& neighbors = neighbor->neighbors;
+                neighbors.erase(std::remove(neighbors.begin(), neighbors.end(), node->handle), neighbors.end());
             }
         }
         
         // If this was the gateway, clear gateway ID
-        if (deviceId == gatewayId) {
-            gatewayId = "";
+        if (node->handle == gateway) {
+            gateway = DeviceHandle();
         }
         
-        nodes.erase(it);
+        node->present = false;
+        node->neighbors.clear();
+        nodeCount--;
         
         // Update routing table
         updateRoutingTable();
@@ -93,12 +150,16 @@ namespace iot {
     }
     
     std::vector<std::string> MeshNetwork::findOptimalPath(const std::string& sourceDevice) {
-        if (gatewayId.empty()) {
+        if (!gateway.isValid()) {
             std::cout << "No gateway configured in mesh network" << std::endl;
             return {};
         }
         
-        return bfsShortestPath(sourceDevice, gatewayId);
+        std::vector<std::string> path;
+        for (DeviceHandle hop : bfsShortestPath(idTable->find(sourceDevice), gateway)) {
+            path.push_back(idTable->name(hop));
+        }
+        return path;
     }
     
     void MeshNetwork::updateRoutingTable() {
@@ -107,9 +168,9 @@ namespace iot {
     }
     
     int MeshNetwork::getHopCount(const std::string& deviceId) const {
-        auto it = nodes.find(deviceId);
-        if (it != nodes.end()) {
-            return it->second.hopCountToGateway;
+        const MeshNode* node = findNode(idTable->find(deviceId));
+        if (node) {
+            return node->hopCountToGateway;
         }
         return maxHops;  // Unreachable
     }
@@ -119,28 +180,29 @@ namespace iot {
     }
     
     std::vector<std::string> MeshNetwork::getNeighbors(const std::string& deviceId) const {
-        auto it = nodes.find(deviceId);
-        if (it != nodes.end()) {
-            return it->second.neighbors;
+        std::vector<std::string> result;
+        const MeshNode* node = findNode(idTable->find(deviceId));
+        if (node) {
+            for (DeviceHandle neighbor : node->neighbors) {
+                result.push_back(idTable->name(neighbor));
+            }
         }
-        return {};
+        return result;
     }
     
     void MeshNetwork::setGateway(const std::string& deviceId) {
-        auto it = nodes.find(deviceId);
-        if (it != nodes.end()) {
+        MeshNode* node = findNode(idTable->find(deviceId));
+        if (node) {
             // Clear previous gateway
-            if (!gatewayId.empty()) {
-                auto gatewayIt = nodes.find(gatewayId);
-                if (gatewayIt != nodes.end()) {
-                    gatewayIt->second.isGateway = false;
-                }
+            MeshNode* previous = findNode(gateway);
+            if (previous) {
+                previous->isGateway = false;
             }
             
             // Set new gateway
-            it->second.isGateway = true;
-            it->second.hopCountToGateway = 0;
-            gatewayId = deviceId;
+            node->isGateway = true;
+            node->hopCountToGateway = 0;
+            gateway = node->handle;
             
             // Update hop counts
             updateHopCounts();
@@ -153,12 +215,12 @@ namespace iot {
     
     void MeshNetwork::printTopology() const {
         std::cout << "\n=== MESH NETWORK TOPOLOGY ===" << std::endl;
-        std::cout << "Gateway: " << (gatewayId.empty() ? "None" : gatewayId) << std::endl;
-        std::cout << "Total Devices: " << nodes.size() << std::endl;
+        std::cout << "Gateway: " << (gateway.isValid() ? idTable->name(gateway) : "None") << std::endl;
+        std::cout << "Total Devices: " << nodeCount << std::endl;
         
-        for (const auto& pair : nodes) {
-            const MeshNode& node = pair.second;
-            std::cout << "  " << node.deviceId 
+        for (const MeshNode& node : nodes) {
+            if (!node.present) continue;
+            std::cout << "  " << idTable->name(node.handle) 
                      << " (Hops: " << node.hopCountToGateway
                      << ", Neighbors: " << node.neighbors.size()
                      << (node.isGateway ? ", GATEWAY" : "") << ")" << std::endl;
@@ -166,7 +228,7 @@ namespace iot {
             if (!node.neighbors.empty()) {
                 std::cout << "    Neighbors: ";
                 for (size_t i = 0; i < node.neighbors.size(); ++i) {
-                    std::cout << node.neighbors[i];
+                    std::cout << idTable->name(node.neighbors[i]);
                     if (i < node.neighbors.size() - 1) std::cout << ", ";
                 }
                 std::cout << std::endl;
@@ -178,14 +240,14 @@ namespace iot {
     void MeshNetwork::printStatistics() const {
         std::cout << "\n=== MESH NETWORK STATISTICS ===" << std::endl;
         
-        int totalDevices = nodes.size();
+        int totalDevices = nodeCount;
         int reachableDevices = 0;
         int unreachableDevices = 0;
         int gatewayDevices = 0;
         double averageHops = 0.0;
         
-        for (const auto& pair : nodes) {
-            const MeshNode& node = pair.second;
+        for (const MeshNode& node : nodes) {
+            if (!node.present) continue;
             if (node.isGateway) {
                 gatewayDevices++;
             }
@@ -211,8 +273,8 @@ namespace iot {
         std::cout << "===============================" << std::endl;
     }
     
-    std::vector<std::string> MeshNetwork::bfsShortestPath(const std::string& start, const std::string& target) {
-        if (nodes.find(start) == nodes.end() || nodes.find(target) == nodes.end()) {
+    std::vector<DeviceHandle> MeshNetwork::bfsShortestPath(DeviceHandle start, DeviceHandle target) const {
+        if (!findNode(start) || !findNode(target)) {
             return {};
         }
         
@@ -220,31 +282,30 @@ namespace iot {
             return {start};
         }
         
-        std::map<std::string, bool> visited;
-        std::map<std::string, std::string> parent;
-        std::queue<std::string> queue;
+        std::vector<bool> visited(nodes.size(), false);
+        std::vector<DeviceHandle> parent(nodes.size());
+        std::queue<DeviceHandle> queue;
         
-        visited[start] = true;
+        visited[start.index()] = true;
         queue.push(start);
         
         while (!queue.empty()) {
-            std::string current = queue.front();
+            DeviceHandle current = queue.front();
             queue.pop();
             
-            const auto& currentNode = nodes.at(current);
-            for (const std::string& neighborId : currentNode.neighbors) {
-                if (visited.find(neighborId) == visited.end()) {
-                    visited[neighborId] = true;
-                    parent[neighborId] = current;
-                    queue.push(neighborId);
+            for (DeviceHandle neighbor : nodes[current.index()].neighbors) {
+                if (!visited[neighbor.index()]) {
+                    visited[neighbor.index()] = true;
+                    parent[neighbor.index()] = current;
+                    queue.push(neighbor);
                     
-                    if (neighborId == target) {
+                    if (neighbor == target) {
                         // Reconstruct path
-                        std::vector<std::string> path;
-                        std::string node = target;
+                        std::vector<DeviceHandle> path;
+                        DeviceHandle node = target;
                         while (node != start) {
                             path.push_back(node);
-                            node = parent[node];
+                            node = parent[node.index()];
                         }
                         path.push_back(start);
                         std::reverse(path.begin(), path.end());
@@ -258,44 +319,105 @@ namespace iot {
     }
     
     void MeshNetwork::updateHopCounts() {
-        if (gatewayId.empty()) return;
+        if (!findNode(gateway)) return;
         
         // Initialize all hop counts to max
-        for (auto& pair : nodes) {
-            if (pair.first != gatewayId) {
-                pair.second.hopCountToGateway = maxHops;
-            } else {
-                pair.second.hopCountToGateway = 0;  // Gateway has 0 hops to itself
-            }
+        for (MeshNode& node : nodes) {
+            node.hopCountToGateway = (node.handle == gateway) ? 0 : maxHops;  // Gateway has 0 hops to itself
         }
         
         // BFS from gateway to calculate hop counts
-        std::map<std::string, bool> visited;
-        std::queue<std::pair<std::string, int>> queue;  // {deviceId, hopCount}
+        std::vector<bool> visited(nodes.size(), false);
+        std::queue<std::pair<DeviceHandle, int>> queue;  // {device, hopCount}
         
-        visited[gatewayId] = true;
-        queue.push({gatewayId, 0});
+        visited[gateway.index()] = true;
+        queue.push({gateway, 0});
         
         while (!queue.empty()) {
             auto [currentDevice, currentHops] = queue.front();
             queue.pop();
             
-            const auto& currentNode = nodes.at(currentDevice);
             int nextHops = currentHops + 1;
             
-            for (const std::string& neighborId : currentNode.neighbors) {
-                if (visited.find(neighborId) == visited.end() || 
-                    nodes[neighborId].hopCountToGateway > nextHops) {
+            for (DeviceHandle neighbor : nodes[currentDevice.index()].neighbors) {
+                MeshNode& neighborNode = nodes[neighbor.index()];
+                if (!visited[neighbor.index()] || neighborNode.hopCountToGateway > nextHops) {
                     
-                    nodes[neighborId].hopCountToGateway = nextHops;
-                    visited[neighborId] = true;
+                    neighborNode.hopCountToGateway = nextHops;
+                    visited[neighbor.index()] = true;
                     
                     if (nextHops < maxHops) {
-                        queue.push({neighborId, nextHops});
+                        queue.push({neighbor, nextHops});
                     }
                 }
             }
         }
     }
     
+    void MeshNetwork::writeCheckpoint(CheckpointWriter& out) const {
+        out.writeSigned(maxHops);
+        out.writeVarint(gateway.isValid() ? gateway.value + 1 : 0);
+        out.writeVarint(nodeCount);
+        for (const MeshNode& node : nodes) {
+            if (!node.present) continue;
+            out.writeVarint(node.handle.value);
+            out.writeSigned(node.hopCountToGateway);
+            out.writeBool(node.isGateway);
+            out.writeDouble(node.signalStrength);
+            out.writeVarint(node.neighbors.size());
+            for (DeviceHandle neighbor : node.neighbors) {
+                out.writeVarint(neighbor.value);
+            }
+        }
+    }
+    
+    bool MeshNetwork::readCheckpoint(CheckpointReader& in) {
+        if (nodeCount != 0) {
+            std::cerr << "Mesh network must be empty to restore a checkpoint" << std::endl;
+            return false;
+        }
+        
+        int hops = static_cast<int>(in.readSigned());
+        uint64_t gatewayValue = in.readVarint();
+        size_t count = in.readCount();
+        const size_t handleLimit = idTable->size();
+        std::vector<MeshNode> restored;
+        for (size_t i = 0; i < count && in.ok(); ++i) {
+            uint64_t value = in.readVarint();
+            if (value >= handleLimit) {
+                in.fail();
+                break;
+            }
+            if (value >= restored.size()) {
+                restored.resize(value + 1);
+            }
+            MeshNode& node = restored[value];
+            if (node.present) {
+                in.fail();  // listed twice
+                break;
+            }
+            node.handle = DeviceHandle(static_cast<uint32_t>(value));
+            node.hopCountToGateway = static_cast<int>(in.readSigned());
+            node.isGateway = in.readBool();
+            node.signalStrength = in.readDouble();
+            node.present = true;
+            size_t neighborCount = in.readCount();
+            node.neighbors.reserve(neighborCount);
+            for (size_t n = 0; n < neighborCount; ++n) {
+                uint64_t neighbor = in.readVarint();
+                if (neighbor >= handleLimit) in.fail();
+                node.neighbors.push_back(DeviceHandle(static_cast<uint32_t>(neighbor)));
+            }
+        }
+        if (!in.ok() || gatewayValue > restored.size()) {
+            return false;
+        }
+        
+        nodes = std::move(restored);
+        nodeCount = count;
+        maxHops = hops;
+        gateway = gatewayValue == 0 ? DeviceHandle() : DeviceHandle(static_cast<uint32_t>(gatewayValue - 1));
+        return true;
+    }
+    
 } // namespace iot
\ No newline at end of file
@@ -1,8 +1,11 @@
 #include "../../include/network/NetworkManager.h"
 #include "../../include/network/ProtocolCharacteristics.h"
+#include "../../include/utils/CounterRng.h"
+#include "../../include/utils/CheckpointStream.h"
 
 #include <iostream>
 #include <algorithm>
+#include <iterator>
 #include <thread>
 #include <chrono>
 #include <iomanip> 
@@ -11,17 +14,17 @@ namespace iot {
     
     NetworkManager::NetworkManager(std::shared_ptr<DeviceManager> dm)
         : deviceManager(dm)
+        , ipsecManager(nullptr)
         , running(false)
-        , stats{0, 0, 0, 0, std::chrono::steady_clock::now()}
+        , statsStartTicks(std::chrono::steady_clock::now().time_since_epoch().count())
+        , idTable(dm ? dm->getIdTable() : std::make_shared<DeviceIdTable>())
+        , receiveWaiterCount(0)
         , packetLossRate(0.0)
         , networkDelayMin(0.0)
         , networkDelayMax(0.0)
-        , rng(std::random_device{}())
-        , ipsecManager(nullptr)
-        , failureDistribution(0.0, 1.0) {
-            for (int i = 0; i <= static_cast<int>(Protocol::SIGFOX); i++) {
-    Protocol protocol = static_cast<Protocol>(i);
-            }
+        , lossSeed(streamKey(getGlobalSeed(), StreamPurpose::NETWORK_LINK, 0))
+        , lossCounter(0) {
+        setDeliveryWorkers(std::max(1u, std::thread::hardware_concurrency()));
     }
     
     NetworkManager::~NetworkManager() {
@@ -32,61 +35,315 @@ namespace iot {
         if (running) return;
         
         running = true;
-        processingThread = std::thread(&NetworkManager::processMessages, this);
-        std::cout << "Network manager started" << std::endl;
+        for (auto& shard : shards) {
+            shard->worker = std::thread(&NetworkManager::processMessages, this, std::ref(*shard));
+        }
+        std::cout << "Network manager started (" << shards.size() << " delivery workers)" << std::endl;
     }
     
     void NetworkManager::stop() {
         if (!running) return;
         
         running = false;
-        queueCondition.notify_all();
+        for (auto& shard : shards) {
+            {
+                // Taking the lock orders the flag change before the wait predicate
+                std::lock_guard<std::mutex> lock(shard->wakeMutex);
+            }
+            shard->wakeCondition.notify_all();
+        }
         
-        if (processingThread.joinable()) {
-            processingThread.join();
+        for (auto& shard : shards) {
+            if (shard->worker.joinable()) {
+                shard->worker.join();
+            }
         }
         
         std::cout << "Network manager stopped" << std::endl;
     }
     
+    void NetworkManager::setRandomSeed(uint64_t seed) {
+        if (running) {
+            std::cout << "Random seed can only be changed while the network manager is stopped" << std::endl;
+            return;
+        }
+        
+        lossSeed = seed;
+        lossCounter = 0;
+        linkCounters.clear();
+    }
+    
+    void NetworkManager::setDeliveryWorkers(size_t workers) {
+        if (running) {
+            std::cout << "Delivery workers can only be changed while the network manager is stopped" << std::endl;
+            return;
+        }
+        
+        workers = std::max<size_t>(1, workers);
+        
+        // Carry over anything queued before start() and keep the counters
+        std::vector<std::pair<std::chrono::steady_clock::time_point, IngressEntry>> pending;
+        std::vector<IngressEntry> ingress;
+        size_t sent = 0, received = 0, dropped = 0, errors = 0;
+        for (auto& shard : shards) {
+            while (!shard->pending.empty()) {
+                auto dueTime = shard->pending.front().dueTime;
+                pending.emplace_back(dueTime, popPending(*shard));
+            }
+            shard->ingress.drain([&ingress](IngressEntry&& entry) {
+                ingress.push_back(std::move(entry));
+            });
+            for (auto& entry : takeStaged(*shard)) {
+                ingress.push_back(std::move(entry));
+            }
+            sent += shard->messagesSent;
+            received += shard->messagesReceived;
+            dropped += shard->messagesDropped;
+            errors += shard->errors;
+        }
+        
+        shards.clear();
+        for (size_t i = 0; i < workers; ++i) {
+            shards.push_back(std::make_unique<DeliveryShard>());
+        }
+        
+        shards[0]->messagesSent = sent;
+        shards[0]->messagesReceived = received;
+        shards[0]->messagesDropped = dropped;
+        shards[0]->errors = errors;
+        for (auto& delivery : pending) {
+            requeueEntry(std::move(delivery.second), delivery.first, true);
+        }
+        for (auto& entry : ingress) {
+            requeueEntry(std::move(entry), entry.sentTime, false);
+        }
+    }
+    
+    void NetworkManager::requeueEntry(IngressEntry&& entry, std::chrono::steady_clock::time_point dueTime,
+                                      bool pending) {
+        auto place = [this, dueTime, pending](DeliveryShard& shard, IngressEntry&& placed) {
+            if (pending) {
+                shard.queuedEntries++;
+                enqueuePending(shard, std::move(placed), dueTime);
+            } else {
+                pushIngress(shard, std::move(placed));
+            }
+        };
+        
+        if (!entry.fanOut) {
+            DeliveryShard& shard = shardFor(entry.message.getDestinationHandle());
+            place(shard, std::move(entry));
+            return;
+        }
+        
+        std::vector<std::vector<DeviceHandle>> recipients(shards.size());
+        for (DeviceHandle handle : *entry.fanOut) {
+            recipients[handle.index() % shards.size()].push_back(handle);
+        }
+        for (size_t i = 0; i < shards.size(); ++i) {
+            if (!recipients[i].empty()) {
+                place(*shards[i], IngressEntry{entry.message, entry.sentTime,
+                    std::make_shared<const std::vector<DeviceHandle>>(std::move(recipients[i])), entry.delayDraw});
+            }
+        }
+    }
+    
+    NetworkManager::DeliveryShard& NetworkManager::shardFor(DeviceHandle destination) {
+        // Unknown destinations all land on shard 0, where delivery reports them
+        return *shards[destination.isValid() ? destination.index() % shards.size() : 0];
+    }
+    
     bool NetworkManager::sendMessage(const Message& message) {
+        return sendMessage(Message(message));
+    }
+    
+    bool NetworkManager::sendMessage(Message&& message) {
+        // Resolve the destination once; everything past here indexes by handle
+        DeviceHandle destination = message.getDestinationHandle();
+        if (!destination.isValid()) {
+            destination = idTable->find(message.getDestinationDeviceId());
+        }
+        DeliveryShard& shard = shardFor(destination);
+        
         // Simulate network conditions
-        if (!simulateNetworkConditions()) {
-            std::lock_guard<std::mutex> lock(statsMutex);
-            stats.messagesDropped++;
+        CounterBlock draw = drawLinkConditions(message);
+        if (!simulateNetworkConditions(draw)) {
+            shard.messagesDropped++;
             return false;  // Message dropped due to network conditions
         }
         
-        {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            messageQueue.push(message);
+        message.setDestinationHandle(destination);
+        pushIngress(shard, IngressEntry{std::move(message), std::chrono::steady_clock::now(), nullptr,
+                                        unitInterval(draw.second)});
+        
+        shard.messagesSent++;
+        return true;
+    }
+    
+    void NetworkManager::pushIngress(DeliveryShard& shard, IngressEntry&& entry) {
+        // Counted before the push so the worker never sees it go negative
+        shard.queuedEntries++;
+        while (shard.staged.load(std::memory_order_acquire) || !shard.ingress.tryPush(std::move(entry))) {
+            if (stageEntries(shard, &entry, 1)) {
+                break;
+            }
+            // Back-pressure: let the worker catch up rather than dropping
+            wakeWorker(shard);
+            std::this_thread::yield();
+        }
+        
+        wakeWorker(shard);
+    }
+    
+    size_t NetworkManager::sendBatch(std::span<Message> messages) {
+        const size_t count = messages.size();
+        const size_t shardCount = shards.size();
+        if (count == 0) return 0;
+        
+        // Bucket messages by destination shard (counting sort)
+        constexpr uint32_t LOST = 0xFFFFFFFF;
+        std::vector<uint32_t> shardOf(count);
+        std::vector<double> delayDraws(count);
+        std::vector<size_t> offsets(shardCount + 1, 0);
+        std::vector<size_t> lost(shardCount, 0);
+        for (size_t i = 0; i < count; ++i) {
+            Message& message = messages[i];
+            DeviceHandle destination = message.getDestinationHandle();
+            if (!destination.isValid()) {
+                destination = idTable->find(message.getDestinationDeviceId());
+                message.setDestinationHandle(destination);
+            }
+            uint32_t shard = destination.isValid() ? static_cast<uint32_t>(destination.index() % shardCount) : 0;
+            
+            CounterBlock draw = drawLinkConditions(message);
+            delayDraws[i] = unitInterval(draw.second);
+            if (!simulateNetworkConditions(draw)) {
+                lost[shard]++;
+                shardOf[i] = LOST;
+            } else {
+                shardOf[i] = shard;
+                offsets[shard + 1]++;
+            }
+        }
+        for (size_t s = 0; s < shardCount; ++s) {
+            offsets[s + 1] += offsets[s];
+        }
+        
+        std::vector<uint32_t> order(offsets[shardCount]);
+        std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < count; ++i) {
+            if (shardOf[i] != LOST) {
+                order[cursor[shardOf[i]]++] = static_cast<uint32_t>(i);
+            }
         }
         
-        queueCondition.notify_one();
+        auto now = std::chrono::steady_clock::now();
+        std::vector<IngressEntry> grouped;
+        grouped.reserve(order.size());
+        for (uint32_t index : order) {
+            grouped.push_back(IngressEntry{std::move(messages[index]), now, nullptr, delayDraws[index]});
+        }
         
-        {
-            std::lock_guard<std::mutex> lock(statsMutex);
-            stats.messagesSent++;
+        for (size_t s = 0; s < shardCount; ++s) {
+            DeliveryShard& shard = *shards[s];
+            size_t runLength = offsets[s + 1] - offsets[s];
+            if (runLength > 0) {
+                pushIngressBatch(shard, grouped.data() + offsets[s], runLength);
+            }
+            
+            shard.messagesSent += runLength;
+            shard.messagesDropped += lost[s];
+        }
+        return grouped.size();
+    }
+    
+    void NetworkManager::pushIngressBatch(DeliveryShard& shard, IngressEntry* entries, size_t count) {
+        shard.queuedEntries += count;
+        size_t pushed = 0;
+        while (pushed < count) {
+            size_t claimed = shard.staged.load(std::memory_order_acquire)
+                ? 0 : shard.ingress.tryPushBatch(entries + pushed, count - pushed);
+            if (claimed == 0) {
+                if (stageEntries(shard, entries + pushed, count - pushed)) {
+                    break;
+                }
+                // Back-pressure: let the worker catch up rather than dropping
+                wakeWorker(shard);
+                std::this_thread::yield();
+            }
+            pushed += claimed;
         }
         
+        wakeWorker(shard);
+    }
+    
+    bool NetworkManager::stageEntries(DeliveryShard& shard, IngressEntry* entries, size_t count) {
+        std::lock_guard<std::mutex> lock(shard.stagingMutex);
+        if (running && shard.staging.empty()) {
+            return false;
+        }
+        shard.staging.insert(shard.staging.end(), std::make_move_iterator(entries),
+                             std::make_move_iterator(entries + count));
+        shard.staged.store(true, std::memory_order_release);
         return true;
     }
     
+    std::vector<NetworkManager::IngressEntry> NetworkManager::takeStaged(DeliveryShard& shard) {
+        std::vector<IngressEntry> taken;
+        std::lock_guard<std::mutex> lock(shard.stagingMutex);
+        taken.swap(shard.staging);
+        shard.staged.store(false, std::memory_order_release);
+        return taken;
+    }
+    
+    void NetworkManager::wakeWorker(DeliveryShard& shard) {
+        // Pairs with the fence in processMessages: either the worker sees the
+        // new entry before sleeping, or we see it asleep and wake it. Only the
+        // first sender after the worker goes idle pays for the notify.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (shard.sleeping.load(std::memory_order_relaxed) && shard.sleeping.exchange(false)) {
+            std::lock_guard<std::mutex> lock(shard.wakeMutex);
+            shard.wakeCondition.notify_one();
+        }
+    }
+    
     void NetworkManager::broadcastMessage(const Message& message) {
-        // For broadcast, we send to device manager which handles distribution
-        if (deviceManager) {
-            deviceManager->broadcastMessage(message);
-            
-            {
-                std::lock_guard<std::mutex> lock(statsMutex);
-                stats.messagesSent += deviceManager->getDeviceCount();
+        if (!deviceManager) return;
+        
+        DeviceHandle source = message.getSourceHandle();
+        if (!source.isValid()) {
+            source = idTable->find(message.getSourceDeviceId());
+        }
+        
+        // Split the recipients by owning shard; every shard shares the payload
+        std::vector<std::vector<DeviceHandle>> recipients(shards.size());
+        for (DeviceHandle handle : deviceManager->getDeviceHandles()) {
+            if (handle != source) {
+                recipients[handle.index() % shards.size()].push_back(handle);
             }
         }
+        
+        // Every copy shares one delay draw; broadcasts are not subject to loss
+        const double delayDraw = unitInterval(drawLinkConditions(message).second);
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < shards.size(); ++i) {
+            if (recipients[i].empty()) continue;
+            
+            DeliveryShard& shard = *shards[i];
+            size_t fanOut = recipients[i].size();
+            pushIngress(shard, IngressEntry{message, now,
+                std::make_shared<const std::vector<DeviceHandle>>(std::move(recipients[i])), delayDraw});
+            shard.messagesSent += fanOut;
+        }
     }
     
     void NetworkManager::setDeviceProtocol(const std::string& deviceId, Protocol protocol) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        deviceProtocols[deviceId] = protocol;
+        DeviceHandle handle = idTable->intern(deviceId);
+        std::lock_guard<std::mutex> lock(protocolMutex);
+        if (handle.index() >= deviceProtocols.size()) {
+            deviceProtocols.resize(handle.index() + 1, Protocol::CUSTOM);
+        }
+        deviceProtocols[handle.index()] = protocol;
         std::cout << "Device " << deviceId << " set to protocol " 
         << getProtocolCharacteristics(protocol).name << std::endl;
 
@@ -96,14 +353,45 @@ namespace iot {
     }
     
     NetworkManager::Protocol NetworkManager::getDeviceProtocol(const std::string& deviceId) const {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        auto it = deviceProtocols.find(deviceId);
-        if (it != deviceProtocols.end()) {
-            return it->second;
+        DeviceHandle handle = idTable->find(deviceId);
+        std::lock_guard<std::mutex> lock(protocolMutex);
+        if (handle.isValid() && handle.index() < deviceProtocols.size()) {
+            return deviceProtocols[handle.index()];
         }
         return Protocol::CUSTOM;  // Default protocol
     }
     
+    NetworkManager::Protocol NetworkManager::getDeviceProtocol(DeviceHandle device) const {
+        std::lock_guard<std::mutex> lock(protocolMutex);
+        if (device.isValid() && device.index() < deviceProtocols.size()) {
+            return deviceProtocols[device.index()];
+        }
+        return Protocol::CUSTOM;  // Default protocol
+    }
+    
+    bool NetworkManager::deliverNow(const Message& message) {
+        DeviceHandle destination = message.getDestinationHandle();
+        if (!destination.isValid()) {
+            destination = idTable->find(message.getDestinationDeviceId());
+        }
+        DeliveryShard& shard = shardFor(destination);
+        shard.messagesSent++;
+        
+        return deliverMessage(shard, message, destination);
+    }
+    
+    bool NetworkManager::admitMessage(const Message& message) {
+        if (simulateNetworkConditions(drawLinkConditions(message))) {
+            return true;
+        }
+        DeviceHandle destination = message.getDestinationHandle();
+        if (!destination.isValid()) {
+            destination = idTable->find(message.getDestinationDeviceId());
+        }
+        shardFor(destination).messagesDropped++;
+        return false;
+    }
+    
     void NetworkManager::setNetworkConditions(double packetLoss, double delayMin, double delayMax) {
         packetLossRate = std::max(0.0, std::min(1.0, packetLoss));
         networkDelayMin = std::max(0.0, delayMin);
@@ -111,17 +399,106 @@ namespace iot {
     }
     
     NetworkManager::NetworkStats NetworkManager::getStats() const {
-        std::lock_guard<std::mutex> lock(statsMutex);
-        return stats;
+        NetworkStats total{0, 0, 0, 0, std::chrono::steady_clock::time_point(
+            std::chrono::steady_clock::duration(statsStartTicks.load()))};
+        for (const auto& shard : shards) {
+            total.messagesSent += shard->messagesSent;
+            total.messagesReceived += shard->messagesReceived;
+            total.messagesDropped += shard->messagesDropped;
+            total.errors += shard->errors;
+        }
+        return total;
+    }
+    
+    size_t NetworkManager::getInFlightMessages() const {
+        size_t queued = 0;
+        for (const auto& shard : shards) {
+            queued += shard->queuedEntries.load();
+        }
+        return queued;
     }
     
     void NetworkManager::resetStats() {
-        std::lock_guard<std::mutex> lock(statsMutex);
-        stats.messagesSent = 0;
-        stats.messagesReceived = 0;
-        stats.messagesDropped = 0;
-        stats.errors = 0;
-        stats.startTime = std::chrono::steady_clock::now();
+        for (auto& shard : shards) {
+            shard->messagesSent = 0;
+            shard->messagesReceived = 0;
+            shard->messagesDropped = 0;
+            shard->errors = 0;
+        }
+        statsStartTicks = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+    
+    void NetworkManager::writeCheckpoint(CheckpointWriter& out) const {
+        out.writeDouble(packetLossRate);
+        out.writeDouble(networkDelayMin);
+        out.writeDouble(networkDelayMax);
+        out.writeU64(lossSeed);
+        out.writeVarint(lossCounter.load());
+        size_t streams = std::min(idTable->size(), StreamCounters::capacity());
+        out.writeVarint(streams);
+        for (size_t i = 0; i < streams; ++i) {
+            out.writeVarint(linkCounters.get(i));
+        }
+        
+        auto stats = getStats();
+        out.writeVarint(stats.messagesSent);
+        out.writeVarint(stats.messagesReceived);
+        out.writeVarint(stats.messagesDropped);
+        out.writeVarint(stats.errors);
+        
+        std::lock_guard<std::mutex> lock(protocolMutex);
+        out.writeVarint(deviceProtocols.size());
+        for (Protocol protocol : deviceProtocols) {
+            out.writeU8(static_cast<uint8_t>(protocol));
+        }
+    }
+    
+    bool NetworkManager::readCheckpoint(CheckpointReader& in) {
+        if (running) {
+            std::cerr << "Network state can only be restored while the network manager is stopped" << std::endl;
+            return false;
+        }
+        
+        double packetLoss = in.readDouble();
+        double delayMin = in.readDouble();
+        double delayMax = in.readDouble();
+        uint64_t seed = in.readU64();
+        uint64_t counter = in.readVarint();
+        size_t streams = in.readCount();
+        std::vector<uint64_t> streamCounters(streams);
+        for (size_t i = 0; i < streams; ++i) {
+            streamCounters[i] = in.readVarint();
+        }
+        size_t sent = in.readVarint();
+        size_t received = in.readVarint();
+        size_t dropped = in.readVarint();
+        size_t errors = in.readVarint();
+        size_t protocolCount = in.readCount();
+        std::vector<Protocol> protocols(protocolCount);
+        for (size_t i = 0; i < protocolCount; ++i) {
+            uint8_t value = in.readU8();
+            if (value > static_cast<uint8_t>(Protocol::SIGFOX)) in.fail();
+            protocols[i] = static_cast<Protocol>(value);
+        }
+        if (!in.ok()) {
+            return false;
+        }
+        
+        setNetworkConditions(packetLoss, delayMin, delayMax);
+        setRandomSeed(seed);
+        lossCounter = counter;
+        for (size_t i = 0; i < streams; ++i) {
+            linkCounters.set(i, streamCounters[i]);
+        }
+        resetStats();
+        shards.front()->messagesSent = sent;
+        shards.front()->messagesReceived = received;
+        shards.front()->messagesDropped = dropped;
+        shards.front()->errors = errors;
+        
+        std::lock_guard<std::mutex> lock(protocolMutex);
+        deviceProtocols = std::move(protocols);
+        return true;
     }
     
     void NetworkManager::printStats() const {
@@ -143,53 +520,167 @@ namespace iot {
         std::cout << "=========================" << std::endl;
     }
     
-    void NetworkManager::processMessages() {
+    void NetworkManager::processMessages(DeliveryShard& shard) {
+        std::vector<IngressEntry> due;
+        auto now = std::chrono::steady_clock::now();
+        auto stampDueTime = [this, &shard, &due, &now](IngressEntry&& entry) {
+            auto dueTime = entry.sentTime + drawNetworkDelay(entry);
+            if (shard.pending.empty() && dueTime <= now) {
+                // Nothing in flight can be overtaken: skip the heap entirely
+                due.push_back(std::move(entry));
+            } else {
+                enqueuePending(shard, std::move(entry), dueTime);
+            }
+        };
+        
         while (true) {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            queueCondition.wait(lock, [this] { return !messageQueue.empty() || !running; });
+            now = std::chrono::steady_clock::now();
+            shard.ingress.drain(stampDueTime);
+            if (shard.staged.load(std::memory_order_acquire)) {
+                // Staged entries were queued behind everything in the ring
+                for (auto& entry : takeStaged(shard)) {
+                    stampDueTime(std::move(entry));
+                }
+            }
 
-            // If we've been asked to stop, exit quickly. Drain any remaining
-            // queued messages without delivering to avoid blocking during shutdown.
+            // If we've been asked to stop, exit quickly. Drop any remaining
+            // in-flight messages without delivering to avoid blocking during shutdown.
             if (!running) {
-                if (!messageQueue.empty()) {
-                    // Count them as dropped to keep stats consistent
-                    const size_t dropped = messageQueue.size();
-                    messageQueue = std::queue<Message>();
-                    lock.unlock();
-                    {
-                        std::lock_guard<std::mutex> statsLock(statsMutex);
-                        stats.messagesDropped += dropped;
+                // Count them as dropped to keep stats consistent
+                size_t abandoned = 0;
+                size_t abandonedEntries = due.size();
+                for (const auto& entry : due) abandoned += entry.recipientCount();
+                for (const auto& entry : shard.inFlight) {
+                    if (entry) {
+                        abandoned += entry->recipientCount();
+                        abandonedEntries++;
                     }
                 }
+                shard.messagesDropped += abandoned;
+                shard.queuedEntries -= abandonedEntries;
+                shard.pending.clear();
+                shard.inFlight.clear();
+                shard.freeSlots.clear();
+                shard.lastDueTime.clear();
                 break;
             }
 
-            if (!messageQueue.empty()) {
-                Message message = messageQueue.front();
-                messageQueue.pop();
-                lock.unlock();
+            while (!shard.pending.empty() && shard.pending.front().dueTime <= now) {
+                due.push_back(popPending(shard));
+            }
+
+            for (const auto& entry : due) {
+                deliverEntry(shard, entry);
+            }
+            shard.queuedEntries -= due.size();
+            if (!due.empty() || shard.ingress.hasPending() || shard.staged.load()) {
+                due.clear();
+                continue;
+            }
 
-                // Apply network delay
-                if (networkDelayMax > 0) {
-                    std::uniform_real_distribution<double> delayDist(networkDelayMin, networkDelayMax);
-                    double delayMs = delayDist(rng);
-                    std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(delayMs)));
-                }
+            // Idle: sleep until the earliest in-flight message is due or a
+            // sender publishes something new
+            std::unique_lock<std::mutex> lock(shard.wakeMutex);
+            shard.sleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (shard.ingress.hasPending() || shard.staged.load() || !running) {
+                shard.sleeping.store(false);
+                continue;
+            }
 
-                deliverMessage(message);
+            auto woken = [this, &shard] { return !shard.sleeping.load() || !running; };
+            if (shard.pending.empty()) {
+                shard.wakeCondition.wait(lock, woken);
+            } else {
+                shard.wakeCondition.wait_until(lock, shard.pending.front().dueTime, woken);
             }
+            shard.sleeping.store(false);
         }
     }
     
-    bool NetworkManager::simulateNetworkConditions() {
-      
-        if (packetLossRate > 0.0) {
-            double randomValue = failureDistribution(rng);
-            if (randomValue < packetLossRate) {
-                return false; 
+    void NetworkManager::enqueuePending(DeliveryShard& shard, IngressEntry&& entry,
+                                        std::chrono::steady_clock::time_point dueTime) {
+        // A device never sees a later message overtake an earlier one. Stale
+        // entries are in the past, so they never need clearing.
+        // A shard owns the handles with index % shards == its position, so
+        // index / shards numbers its own devices densely
+        const size_t shardCount = shards.size();
+        auto clampRecipient = [&shard, shardCount](DeviceHandle destination) -> std::chrono::steady_clock::time_point& {
+            size_t local = destination.index() / shardCount;
+            if (local >= shard.lastDueTime.size()) {
+                shard.lastDueTime.resize(local + 1);
             }
+            return shard.lastDueTime[local];
+        };
+        
+        if (entry.fanOut) {
+            // A broadcast is due once every recipient's earlier traffic is
+            for (DeviceHandle destination : *entry.fanOut) {
+                dueTime = std::max(dueTime, clampRecipient(destination));
+            }
+            for (DeviceHandle destination : *entry.fanOut) {
+                clampRecipient(destination) = dueTime;
+            }
+        } else if (entry.message.getDestinationHandle().isValid()) {
+            auto& lastDue = clampRecipient(entry.message.getDestinationHandle());
+            dueTime = std::max(dueTime, lastDue);
+            lastDue = dueTime;
+        }
+        
+        uint32_t slot;
+        if (shard.freeSlots.empty()) {
+            slot = static_cast<uint32_t>(shard.inFlight.size());
+            shard.inFlight.emplace_back(std::move(entry));
+        } else {
+            slot = shard.freeSlots.back();
+            shard.freeSlots.pop_back();
+            shard.inFlight[slot].emplace(std::move(entry));
         }
-        return true;  
+        
+        shard.pending.push_back(PendingDelivery{dueTime, shard.nextSequence++, slot});
+        std::push_heap(shard.pending.begin(), shard.pending.end(), std::greater<PendingDelivery>());
+    }
+    
+    NetworkManager::IngressEntry NetworkManager::popPending(DeliveryShard& shard) {
+        std::pop_heap(shard.pending.begin(), shard.pending.end(), std::greater<PendingDelivery>());
+        uint32_t slot = shard.pending.back().slot;
+        shard.pending.pop_back();
+        
+        IngressEntry entry = std::move(*shard.inFlight[slot]);
+        shard.inFlight[slot].reset();
+        shard.freeSlots.push_back(slot);
+        return entry;
+    }
+    
+    std::chrono::steady_clock::duration NetworkManager::drawNetworkDelay(const IngressEntry& entry) const {
+        if (networkDelayMax <= 0) {
+            return std::chrono::steady_clock::duration::zero();
+        }
+        
+        double delay = networkDelayMin + (networkDelayMax - networkDelayMin) * entry.delayDraw;
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(delay));
+    }
+    
+    CounterBlock NetworkManager::drawLinkConditions(const Message& message) {
+        if (packetLossRate <= 0.0 && networkDelayMax <= 0.0) {
+            return CounterBlock{~uint64_t(0), 0};  // ideal link: nothing to draw
+        }
+        
+        DeviceHandle source = message.getSourceHandle();
+        if (!source.isValid()) {
+            source = idTable->find(message.getSourceDeviceId());
+        }
+        if (source.isValid() && source.index() < StreamCounters::capacity()) {
+            return philox2x64(linkCounters.next(source.index()), 0,
+                              streamKey(lossSeed, StreamPurpose::NETWORK_LINK, source.value));
+        }
+        return philox2x64(lossCounter.fetch_add(1, std::memory_order_relaxed), 0,
+                          streamKey(lossSeed, StreamPurpose::NETWORK_LINK, DeviceHandle::INVALID));
+    }
+    
+    bool NetworkManager::simulateNetworkConditions(const CounterBlock& draw) const {
+        return !(packetLossRate > 0.0 && unitInterval(draw.first) < packetLossRate);
     }
     
   
@@ -200,20 +691,78 @@ void NetworkManager::setIPSecManager(std::shared_ptr<IPSecManager> ipsec) {
     std::cout << "IPsec Manager integrated with Network Manager" << std::endl;
 }
 
+bool ReceiveWaiter::enlist() {
+    return network->addReceiveWaiter(*this);
+}
+
+void ReceiveWaiter::withdraw() {
+    if (registered) {
+        network->removeReceiveWaiter(*this);
+    }
+}
+
+bool NetworkManager::addReceiveWaiter(ReceiveWaiter& waiter) {
+    std::lock_guard<std::mutex> lock(receiveMutex);
+    if (receiveWaiters.size() <= waiter.device.index()) {
+        receiveWaiters.resize(waiter.device.index() + 1, nullptr);
+    }
+    ReceiveWaiter*& entry = receiveWaiters[waiter.device.index()];
+    if (entry) {
+        std::cerr << "Warning: a behaviour is already waiting for messages to '"
+                  << idTable->name(waiter.device) << "'" << std::endl;
+        return false;
+    }
+    entry = &waiter;
+    waiter.registered = true;
+    receiveWaiterCount++;
+    return true;
+}
+
+void NetworkManager::removeReceiveWaiter(ReceiveWaiter& waiter) {
+    std::lock_guard<std::mutex> lock(receiveMutex);
+    if (waiter.registered && receiveWaiters[waiter.device.index()] == &waiter) {
+        receiveWaiters[waiter.device.index()] = nullptr;
+        receiveWaiterCount--;
+    }
+    waiter.registered = false;
+}
+
+void NetworkManager::wakeReceiver(const Message& message, DeviceHandle destination) {
+    std::lock_guard<std::mutex> lock(receiveMutex);
+    if (destination.index() >= receiveWaiters.size() || !receiveWaiters[destination.index()]) {
+        return;
+    }
+    ReceiveWaiter* waiter = receiveWaiters[destination.index()];
+    receiveWaiters[destination.index()] = nullptr;
+    receiveWaiterCount--;
+    
+    // Still under the lock, so the waiting frame cannot be destroyed meanwhile
+    waiter->deliver(message);
+}
+
+void NetworkManager::deliverEntry(DeliveryShard& shard, const IngressEntry& entry) {
+    if (!entry.fanOut) {
+        deliverMessage(shard, entry.message, entry.message.getDestinationHandle());
+        return;
+    }
+    for (DeviceHandle destination : *entry.fanOut) {
+        deliverMessage(shard, entry.message, destination);
+    }
+}
+
 // Update the deliverMessage method to include IPsec processing
-void NetworkManager::deliverMessage(const Message& message) {
+bool NetworkManager::deliverMessage(DeliveryShard& shard, const Message& message, DeviceHandle destination) {
     if (!deviceManager) {
-        std::lock_guard<std::mutex> lock(statsMutex);
-        stats.errors++;
-        return;
+        shard.errors++;
+        return false;
     }
     
     // Apply IPsec security if enabled
-    std::string payload = message.getPayload();
-    std::string sourceDeviceId = message.getSourceDeviceId();
-    std::string destDeviceId = message.getDestinationDeviceId();
-    
     if (ipsecManager && ipsecManager->isEnabledIPSec()) {
+        const std::string& payload = message.getPayload();
+        const std::string& sourceDeviceId = message.getSourceDeviceId();
+        const std::string& destDeviceId = idTable->name(destination);
+        
         // Simulate IP addresses for devices (in real implementation, this would be actual IPs)
         // Handle device IDs with or without underscores
         size_t sourceUnderscorePos = sourceDeviceId.find_last_of('_');
@@ -238,26 +787,25 @@ void NetworkManager::deliverMessage(const Message& message) {
                   << " to " << destDeviceId << std::endl;
     }
     
-    // Check if destination device exists before attempting delivery
-    bool destinationExists = deviceManager->deviceExists(destDeviceId);
-    
+    // Handle was resolved in sendMessage, so this is a single array lookup
     bool delivered = false;
-    if (destinationExists) {
-        delivered = deviceManager->sendMessageToDevice(message);
+    if (deviceManager->deviceExists(destination)) {
+        delivered = deviceManager->sendMessageToDevice(destination, message);
     } else {
-        std::cerr << "Warning: Destination device '" << destDeviceId 
-                  << "' not found. Message from " << sourceDeviceId 
+        std::cerr << "Warning: Destination device '" << message.getDestinationDeviceId() 
+                  << "' not found. Message from " << message.getSourceDeviceId() 
                   << " dropped." << std::endl;
     }
     
-    {
-        std::lock_guard<std::mutex> lock(statsMutex);
-        if (delivered) {
-            stats.messagesReceived++;
-        } else {
-            stats.errors++;
+    if (delivered) {
+        shard.messagesReceived++;
+        if (receiveWaiterCount.load(std::memory_order_relaxed) != 0) {
+            wakeReceiver(message, destination);
         }
+    } else {
+        shard.errors++;
     }
+    return delivered;
 }
     
 } // namespace iot
\ No newline at end of file
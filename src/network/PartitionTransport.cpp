@@ -0,0 +1,473 @@
+#include "../../include/network/PartitionTransport.h"
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace iot {
+
+    namespace {
+        constexpr size_t RECORD_ALIGNMENT = 8;
+        constexpr size_t RECORD_HEADER = sizeof(uint32_t);
+
+        size_t recordSize(size_t payload) {
+            return (RECORD_HEADER + payload + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+        }
+
+        size_t roundUpToPowerOfTwo(size_t value) {
+            size_t power = 64;
+            while (power < value) power <<= 1;
+            return power;
+        }
+
+        // Shared (not process-private) futexes, since the doorbells live in a MAP_SHARED region
+        void futexWait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::milliseconds timeout) {
+            timespec relative{static_cast<time_t>(timeout.count() / 1000),
+                              static_cast<long>((timeout.count() % 1000) * 1000000)};
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+        }
+
+        void futexWakeAll(std::atomic<uint32_t>& word) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+        }
+
+        // TCP frame header: payload length, destination endpoint, source endpoint
+        constexpr size_t TCP_HEADER = 3 * sizeof(uint32_t);
+        constexpr uint32_t HELLO = 0xFFFFFFFF;
+
+        bool setNonBlocking(int socket) {
+            int flags = fcntl(socket, F_GETFL, 0);
+            int noDelay = 1;
+            setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+        }
+    }
+
+    // ----- SharedMemoryRegion -----
+
+    SharedMemoryRegion::SharedMemoryRegion(size_t endpointCount, size_t ringBytes)
+        : base(nullptr)
+        , mappedSize(0)
+        , endpoints(endpointCount)
+        , ringCapacity(roundUpToPowerOfTwo(ringBytes))
+        , ringStride(sizeof(Ring) + roundUpToPowerOfTwo(ringBytes))
+        , ringsOffset(endpointCount * sizeof(Doorbell)) {
+        mappedSize = ringsOffset + endpoints * endpoints * ringStride;
+        // Pages are only backed once a ring is actually used
+        void* mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "Cannot map " << mappedSize << " bytes of shared memory: " << std::strerror(errno) << std::endl;
+            return;
+        }
+        base = mapping;
+        for (size_t i = 0; i < endpoints; ++i) {
+            Doorbell* bell = new (static_cast<uint8_t*>(base) + i * sizeof(Doorbell)) Doorbell;
+            bell->sequence.store(0, std::memory_order_relaxed);
+            bell->sleepers.store(0, std::memory_order_relaxed);
+        }
+        for (size_t from = 0; from < endpoints; ++from) {
+            for (size_t to = 0; to < endpoints; ++to) {
+                Ring* entry = new (&ring(from, to)) Ring;
+                entry->head.store(0, std::memory_order_relaxed);
+                entry->tail.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    SharedMemoryRegion::~SharedMemoryRegion() {
+        if (base) {
+            munmap(base, mappedSize);
+        }
+    }
+
+    SharedMemoryRegion::Doorbell& SharedMemoryRegion::doorbell(size_t endpoint) const {
+        return *reinterpret_cast<Doorbell*>(static_cast<uint8_t*>(base) + endpoint * sizeof(Doorbell));
+    }
+
+    SharedMemoryRegion::Ring& SharedMemoryRegion::ring(size_t from, size_t to) const {
+        return *reinterpret_cast<Ring*>(static_cast<uint8_t*>(base) + ringsOffset + (from * endpoints + to) * ringStride);
+    }
+
+    uint8_t* SharedMemoryRegion::ringData(size_t from, size_t to) const {
+        return reinterpret_cast<uint8_t*>(&ring(from, to)) + sizeof(Ring);
+    }
+
+    // ----- ShmTransport -----
+
+    ShmTransport::ShmTransport(std::shared_ptr<SharedMemoryRegion> sharedRegion, size_t endpoint)
+        : region(std::move(sharedRegion))
+        , self(endpoint) {}
+
+    void ShmTransport::ring(size_t endpoint) {
+        auto& bell = region->doorbell(endpoint);
+        bell.sequence.fetch_add(1, std::memory_order_seq_cst);
+        if (bell.sleepers.load(std::memory_order_seq_cst) != 0) {
+            futexWakeAll(bell.sequence);
+        }
+    }
+
+    bool ShmTransport::trySend(size_t to, const uint8_t* data, size_t size) {
+        if (to >= region->getEndpointCount() || size > getMaxFrameSize()) {
+            std::cerr << "Frame of " << size << " bytes cannot be sent to endpoint " << to << std::endl;
+            return false;
+        }
+        auto& entry = region->ring(self, to);
+        uint8_t* buffer = region->ringData(self, to);
+        const size_t capacity = region->getRingCapacity();
+        const size_t needed = recordSize(size);
+
+        uint64_t tail = entry.tail.load(std::memory_order_relaxed);
+        if (tail + needed - entry.head.load(std::memory_order_acquire) > capacity) {
+            return false;
+        }
+
+        uint32_t length = static_cast<uint32_t>(size);
+        size_t at = tail & (capacity - 1);
+        std::memcpy(buffer + at, &length, sizeof(length));
+        size_t start = (at + RECORD_HEADER) & (capacity - 1);
+        size_t first = std::min(size, capacity - start);
+        std::memcpy(buffer + start, data, first);
+        std::memcpy(buffer, data + first, size - first);
+
+        entry.tail.store(tail + needed, std::memory_order_release);
+        ring(to);
+        return true;
+    }
+
+    bool ShmTransport::tryReceive(size_t from, std::vector<uint8_t>& frame) {
+        if (from >= region->getEndpointCount()) {
+            return false;
+        }
+        auto& entry = region->ring(from, self);
+        const uint8_t* buffer = region->ringData(from, self);
+        const size_t capacity = region->getRingCapacity();
+
+        uint64_t head = entry.head.load(std::memory_order_relaxed);
+        if (head == entry.tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        uint32_t length;
+        size_t at = head & (capacity - 1);
+        std::memcpy(&length, buffer + at, sizeof(length));
+        frame.resize(length);
+        size_t start = (at + RECORD_HEADER) & (capacity - 1);
+        size_t first = std::min<size_t>(length, capacity - start);
+        std::memcpy(frame.data(), buffer + start, first);
+        std::memcpy(frame.data() + first, buffer, length - first);
+
+        entry.head.store(head + recordSize(length), std::memory_order_release);
+        ring(from);  // the producer may be waiting for room
+        return true;
+    }
+
+    uint64_t ShmTransport::prepareWait() {
+        return region->doorbell(self).sequence.load(std::memory_order_seq_cst);
+    }
+
+    void ShmTransport::wait(uint64_t token, std::chrono::milliseconds timeout) {
+        auto& bell = region->doorbell(self);
+        bell.sleepers.fetch_add(1, std::memory_order_seq_cst);
+        // Returns at once if anything rang since prepareWait
+        futexWait(bell.sequence, static_cast<uint32_t>(token), timeout);
+        bell.sleepers.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    // ----- TcpTransport -----
+
+    TcpTransport::TcpTransport(size_t endpoint, size_t endpointCount)
+        : self(endpoint)
+        , endpoints(endpointCount)
+        , listener(-1)
+        , port(0)
+        , inbox(endpointCount) {}
+
+    TcpTransport::~TcpTransport() {
+        closeListener();
+        for (auto& connection : connections) {
+            if (connection.socket >= 0) {
+                close(connection.socket);
+            }
+        }
+    }
+
+    std::unique_ptr<TcpTransport> TcpTransport::listen(const std::string& address, uint16_t listenPort,
+                                                       size_t workers) {
+        std::unique_ptr<TcpTransport> transport(new TcpTransport(workers, workers + 1));
+        transport->connections.resize(workers);
+
+        int socket = ::socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in bound{};
+        bound.sin_family = AF_INET;
+        bound.sin_port = htons(listenPort);
+        socklen_t length = sizeof(bound);
+        if (socket < 0 || inet_pton(AF_INET, address.c_str(), &bound.sin_addr) != 1 ||
+            bind(socket, reinterpret_cast<sockaddr*>(&bound), sizeof(bound)) != 0 ||
+            ::listen(socket, static_cast<int>(workers) + 4) != 0 ||
+            getsockname(socket, reinterpret_cast<sockaddr*>(&bound), &length) != 0) {
+            std::cerr << "Cannot listen on " << address << ":" << listenPort << ": " << std::strerror(errno) << std::endl;
+            if (socket >= 0) close(socket);
+            return nullptr;
+        }
+        transport->listener = socket;
+        transport->port = ntohs(bound.sin_port);
+        return transport;
+    }
+
+    bool TcpTransport::acceptWorkers(std::chrono::milliseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::vector<Connection> pending;
+        size_t connected = 0;
+
+        while (connected < connections.size()) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                std::cerr << "Only " << connected << " of " << connections.size() << " workers connected" << std::endl;
+                return false;
+            }
+
+            std::vector<pollfd> polls{{listener, POLLIN, 0}};
+            for (const auto& connection : pending) {
+                polls.push_back({connection.socket, POLLIN, 0});
+            }
+            poll(polls.data(), polls.size(), static_cast<int>(remaining.count()));
+
+            if (polls[0].revents & POLLIN) {
+                int socket = accept(listener, nullptr, nullptr);
+                if (socket >= 0 && setNonBlocking(socket)) {
+                    Connection connection;
+                    connection.socket = socket;
+                    connection.open = true;
+                    pending.push_back(std::move(connection));
+                } else if (socket >= 0) {
+                    close(socket);
+                }
+            }
+
+            // A worker identifies itself with a HELLO header carrying its index
+            for (size_t i = 0; i < pending.size();) {
+                Connection& connection = pending[i];
+                readConnection(connection);
+                uint32_t header[3];
+                if (connection.input.size() >= TCP_HEADER) {
+                    std::memcpy(header, connection.input.data(), TCP_HEADER);
+                }
+                bool identified = connection.input.size() >= TCP_HEADER && header[1] == HELLO &&
+                                  header[2] < connections.size() && !connections[header[2]].open;
+                if (!identified && connection.open && connection.input.size() < TCP_HEADER) {
+                    ++i;
+                    continue;
+                }
+                if (identified) {
+                    connection.input.erase(connection.input.begin(), connection.input.begin() + TCP_HEADER);
+                    connections[header[2]] = std::move(connection);
+                    connected++;
+                } else {
+                    close(connection.socket);
+                }
+                pending.erase(pending.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+        for (auto& connection : pending) {
+            close(connection.socket);
+        }
+        return true;
+    }
+
+    std::unique_ptr<TcpTransport> TcpTransport::connect(const std::string& host, uint16_t coordinatorPort,
+                                                        size_t worker, size_t workers) {
+        std::unique_ptr<TcpTransport> transport(new TcpTransport(worker, workers + 1));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(coordinatorPort);
+        int socket = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (socket < 0 || inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1 ||
+            ::connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            !setNonBlocking(socket)) {
+            std::cerr << "Cannot connect to coordinator at " << host << ":" << coordinatorPort << ": "
+                      << std::strerror(errno) << std::endl;
+            if (socket >= 0) close(socket);
+            return nullptr;
+        }
+
+        Connection connection;
+        connection.socket = socket;
+        connection.open = true;
+        transport->connections.push_back(std::move(connection));
+        uint32_t hello[3] = {0, HELLO, static_cast<uint32_t>(worker)};
+        transport->connections[0].output.insert(transport->connections[0].output.end(),
+            reinterpret_cast<uint8_t*>(hello), reinterpret_cast<uint8_t*>(hello) + TCP_HEADER);
+        transport->flushConnection(transport->connections[0]);
+        return transport;
+    }
+
+    void TcpTransport::closeListener() {
+        if (listener >= 0) {
+            close(listener);
+            listener = -1;
+        }
+    }
+
+    TcpTransport::Connection* TcpTransport::connectionTo(size_t endpoint) {
+        if (!isCoordinator()) {
+            return connections.empty() ? nullptr : &connections[0];
+        }
+        return endpoint < connections.size() ? &connections[endpoint] : nullptr;
+    }
+
+    void TcpTransport::enqueue(Connection& connection, size_t to, size_t from, const uint8_t* data, size_t size) {
+        uint32_t header[3] = {static_cast<uint32_t>(size), static_cast<uint32_t>(to), static_cast<uint32_t>(from)};
+        connection.output.insert(connection.output.end(),
+            reinterpret_cast<uint8_t*>(header), reinterpret_cast<uint8_t*>(header) + TCP_HEADER);
+        connection.output.insert(connection.output.end(), data, data + size);
+    }
+
+    void TcpTransport::flushConnection(Connection& connection) {
+        while (connection.open && connection.outputSent < connection.output.size()) {
+            ssize_t sent = send(connection.socket, connection.output.data() + connection.outputSent,
+                                connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+            if (sent > 0) {
+                connection.outputSent += static_cast<size_t>(sent);
+            } else if (sent < 0 && errno == EINTR) {
+                continue;
+            } else {
+                if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                    connection.open = false;
+                }
+                break;
+            }
+        }
+        if (connection.outputSent == connection.output.size()) {
+            connection.output.clear();
+            connection.outputSent = 0;
+        }
+    }
+
+    void TcpTransport::readConnection(Connection& connection) {
+        uint8_t buffer[65536];
+        while (connection.open) {
+            ssize_t received = recv(connection.socket, buffer, sizeof(buffer), 0);
+            if (received > 0) {
+                connection.input.insert(connection.input.end(), buffer, buffer + received);
+            } else if (received < 0 && errno == EINTR) {
+                continue;
+            } else {
+                if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    connection.open = false;
+                }
+                break;
+            }
+        }
+    }
+
+    void TcpTransport::service() {
+        for (auto& connection : connections) {
+            flushConnection(connection);
+            readConnection(connection);
+
+            size_t offset = 0;
+            while (connection.input.size() - offset >= TCP_HEADER) {
+                uint32_t header[3];
+                std::memcpy(header, connection.input.data() + offset, TCP_HEADER);
+                if (connection.input.size() - offset - TCP_HEADER < header[0]) {
+                    break;
+                }
+                const uint8_t* payload = connection.input.data() + offset + TCP_HEADER;
+                if (header[1] == self && header[2] < endpoints) {
+                    inbox[header[2]].emplace_back(payload, payload + header[0]);
+                } else if (isCoordinator() && header[1] < connections.size()) {
+                    // Worker to worker: relay, keeping the original source
+                    enqueue(connections[header[1]], header[1], header[2], payload, header[0]);
+                }
+                offset += TCP_HEADER + header[0];
+            }
+            connection.input.erase(connection.input.begin(), connection.input.begin() + static_cast<std::ptrdiff_t>(offset));
+        }
+        for (auto& connection : connections) {
+            flushConnection(connection);
+        }
+    }
+
+    bool TcpTransport::trySend(size_t to, const uint8_t* data, size_t size) {
+        Connection* connection = connectionTo(to);
+        if (!connection || !connection->open) {
+            return false;
+        }
+        enqueue(*connection, to, self, data, size);
+        flushConnection(*connection);
+        return true;
+    }
+
+    bool TcpTransport::tryReceive(size_t from, std::vector<uint8_t>& frame) {
+        if (from >= endpoints) {
+            return false;
+        }
+        if (inbox[from].empty()) {
+            service();
+            if (inbox[from].empty()) {
+                return false;
+            }
+        }
+        frame = std::move(inbox[from].front());
+        inbox[from].pop_front();
+        return true;
+    }
+
+    void TcpTransport::wait(uint64_t token, std::chrono::milliseconds timeout) {
+        (void)token;
+        std::vector<pollfd> polls;
+        for (const auto& connection : connections) {
+            if (connection.open) {
+                short events = POLLIN;
+                if (connection.outputSent < connection.output.size()) events |= POLLOUT;
+                polls.push_back({connection.socket, events, 0});
+            }
+        }
+        poll(polls.data(), polls.size(), static_cast<int>(timeout.count()));
+        service();
+    }
+
+    bool TcpTransport::isConnected(size_t endpoint) const {
+        if (endpoint == self) {
+            return true;
+        }
+        if (!isCoordinator()) {
+            return !connections.empty() && connections[0].open;
+        }
+        return endpoint < connections.size() && connections[endpoint].open;
+    }
+
+    bool TcpTransport::flush(std::chrono::milliseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            service();
+            bool pending = false;
+            for (const auto& connection : connections) {
+                pending = pending || (connection.open && connection.outputSent < connection.output.size());
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (!pending || remaining.count() <= 0) {
+                return !pending;
+            }
+            wait(0, std::min(remaining, std::chrono::milliseconds(100)));
+        }
+    }
+
+} // namespace iot
@@ -1,8 +1,8 @@
 #include "../../include/security/IPSecManager.h"
+#include "../../include/utils/CheckpointStream.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
-#include <random>
 #include <algorithm>
 #include <chrono>
 #include <cstdint>
@@ -14,7 +14,8 @@ namespace iot {
         : defaultMode(mode)
         , defaultEncryption(EncryptionAlgorithm::AES_128_CBC)
         , defaultAuthentication(AuthenticationAlgorithm::HMAC_SHA256)
-        , isEnabled(true) {
+        , isEnabled(true)
+        , keyRng(streamKey(getGlobalSeed(), StreamPurpose::IPSEC_KEYS, 0)) {
         std::cout << "IPsec Manager initialized in " 
                   << (mode == IPsecMode::TRANSPORT ? "Transport" : "Tunnel") 
                   << " mode" << std::endl;
@@ -251,21 +252,18 @@ namespace iot {
         return verifyHMAC(payload, signature, sa->authenticationKey, defaultAuthentication);
     }
     
+    void IPSecManager::setRandomSeed(uint64_t seed) {
+        std::lock_guard<std::mutex> lock(ipsecMutex);
+        keyRng = RandomStream(streamKey(seed, StreamPurpose::IPSEC_KEYS, 0));
+    }
+    
     std::string IPSecManager::generateSPI() const {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<> dis(10000000, 99999999);
-        
-        return "SPI" + std::to_string(dis(gen));
+        return "SPI" + std::to_string(10000000 + keyRng.below(90000000));
     }
     
     std::string IPSecManager::generateEncryptionKey(EncryptionAlgorithm algo) const {
         // This method is kept for backward compatibility but DH is preferred
         // It's now mainly used for fallback scenarios
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<> dis(0, 255);
-        
         size_t keyLength = 16;  // 128 bits default
         switch (algo) {
             case EncryptionAlgorithm::AES_128_CBC:
@@ -282,7 +280,7 @@ namespace iot {
         
         std::string key;
         for (size_t i = 0; i < keyLength; ++i) {
-            key += static_cast<char>(dis(gen));
+            key += static_cast<char>(keyRng.nextBits() & 0xFF);
         }
         
         return key;
@@ -585,4 +583,95 @@ namespace iot {
         return result.substr(0, 128);  // 512 bits = 128 hex characters
     }
     
+    void IPSecManager::writeCheckpoint(CheckpointWriter& out) {
+        std::lock_guard<std::mutex> lock(ipsecMutex);
+        auto now = std::chrono::steady_clock::now();
+        out.writeBool(isEnabled);
+        out.writeU8(static_cast<uint8_t>(defaultMode));
+        out.writeU8(static_cast<uint8_t>(defaultEncryption));
+        out.writeU8(static_cast<uint8_t>(defaultAuthentication));
+        
+        out.writeVarint(securityAssociations.size());
+        for (const auto& [spi, sa] : securityAssociations) {
+            out.writeString(spi);
+            out.writeString(sa.encryptionKey);
+            out.writeString(sa.authenticationKey);
+            out.writeString(sa.sourceIP);
+            out.writeString(sa.destinationIP);
+            out.writeSigned(sa.sequenceNumber);
+            out.writeDuration(now - sa.creationTime);
+            out.writeDuration(sa.expiryTime - now);
+            out.writeBool(sa.isActive);
+        }
+        
+        out.writeVarint(securityPolicies.size());
+        for (const auto& [key, policy] : securityPolicies) {
+            out.writeString(key);
+            out.writeString(policy.sourceIP);
+            out.writeString(policy.destinationIP);
+            out.writeString(policy.protocol);
+            out.writeBool(policy.requireEncryption);
+            out.writeBool(policy.requireAuthentication);
+            out.writeSigned(policy.securityLevel);
+        }
+        out.writeVarint(keyRng.getCounter());
+    }
+    
+    bool IPSecManager::readCheckpoint(CheckpointReader& in) {
+        auto now = std::chrono::steady_clock::now();
+        bool enabled = in.readBool();
+        uint8_t mode = in.readU8();
+        uint8_t encryption = in.readU8();
+        uint8_t authentication = in.readU8();
+        if (mode > static_cast<uint8_t>(IPsecMode::TUNNEL) ||
+            encryption > static_cast<uint8_t>(EncryptionAlgorithm::NULL_ENCRYPTION) ||
+            authentication > static_cast<uint8_t>(AuthenticationAlgorithm::NULL_AUTH)) {
+            in.fail();
+        }
+        
+        std::map<std::string, SecurityAssociation> associations;
+        size_t associationCount = in.readCount();
+        for (size_t i = 0; i < associationCount && in.ok(); ++i) {
+            SecurityAssociation sa;
+            sa.spi = in.readString();
+            sa.encryptionKey = in.readString();
+            sa.authenticationKey = in.readString();
+            sa.sourceIP = in.readString();
+            sa.destinationIP = in.readString();
+            sa.sequenceNumber = in.readSigned();
+            sa.creationTime = now - in.readDuration();
+            sa.expiryTime = now + in.readDuration();
+            sa.isActive = in.readBool();
+            associations.emplace(sa.spi, std::move(sa));
+        }
+        
+        std::map<std::string, SecurityPolicy> policies;
+        size_t policyCount = in.readCount();
+        for (size_t i = 0; i < policyCount && in.ok(); ++i) {
+            std::string key = in.readString();
+            SecurityPolicy policy;
+            policy.sourceIP = in.readString();
+            policy.destinationIP = in.readString();
+            policy.protocol = in.readString();
+            policy.requireEncryption = in.readBool();
+            policy.requireAuthentication = in.readBool();
+            policy.securityLevel = static_cast<int>(in.readSigned());
+            policies.emplace(std::move(key), std::move(policy));
+        }
+        uint64_t keyPosition = in.readVarint();
+        if (!in.ok()) {
+            return false;
+        }
+        
+        std::lock_guard<std::mutex> lock(ipsecMutex);
+        keyRng.setCounter(keyPosition);
+        isEnabled = enabled;
+        defaultMode = static_cast<IPsecMode>(mode);
+        defaultEncryption = static_cast<EncryptionAlgorithm>(encryption);
+        defaultAuthentication = static_cast<AuthenticationAlgorithm>(authentication);
+        securityAssociations = std::move(associations);
+        securityPolicies = std::move(policies);
+        return true;
+    }
+    
 } // namespace iot
\ No newline at end of file
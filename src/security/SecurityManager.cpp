@@ -1,6 +1,5 @@
 #include "../../include/security/SecurityManager.h"
 #include <iostream>
-#include <random>
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
@@ -11,7 +10,8 @@ namespace iot {
     static std::mutex securityMutex;
 
     SecurityManager::SecurityManager(SecurityLevel defaultLevel)
-        : defaultSecurityLevel(defaultLevel) {
+        : defaultSecurityLevel(defaultLevel)
+        , keyRng(streamKey(getGlobalSeed(), StreamPurpose::SECURITY_KEYS, 0)) {
         std::cout << "Security Manager initialized with default level: " 
                   << static_cast<int>(defaultLevel) << std::endl;
     }
@@ -35,11 +35,7 @@ namespace iot {
         info.securityLevel = level;
         info.isAuthenticated = false;
         
-        // Generate secure auth token
-        static std::random_device rd;
-        static std::mt19937_64 gen(rd());  // Use 64-bit Mersenne Twister
-        static std::uniform_int_distribution<uint64_t> dis;
-        
+        // Generate auth token
         // Create a more complex token with timestamp
         auto now = std::chrono::system_clock::now();
         auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -47,13 +43,13 @@ namespace iot {
         ).count();
         
         std::stringstream tokenStream;
-        tokenStream << std::hex << timestamp << "_" << dis(gen);
+        tokenStream << std::hex << timestamp << "_" << keyRng.nextBits();
         info.authToken = "TOKEN_" + tokenStream.str();
         
         // Generate encryption key using more entropy
         std::string keyMaterial;
         for (int i = 0; i < 32; ++i) {
-            keyMaterial += static_cast<char>(dis(gen) & 0xFF);
+            keyMaterial += static_cast<char>(keyRng.nextBits() & 0xFF);
         }
         info.encryptionKey = keyMaterial;
         
@@ -64,6 +60,11 @@ namespace iot {
         return {true, info.authToken};
     }
     
+    void SecurityManager::setRandomSeed(uint64_t seed) {
+        std::lock_guard<std::mutex> lock(securityMutex);
+        keyRng = RandomStream(streamKey(seed, StreamPurpose::SECURITY_KEYS, 0));
+    }
+    
     // Add this method implementation
 std::string SecurityManager::getDeviceToken(const std::string& deviceId) const {
     std::lock_guard<std::mutex> lock(securityMutex);
@@ -0,0 +1,59 @@
+#include "../../include/simulation/Behavior.h"
+#include "../../include/simulation/SimulationEngine.h"
+#include "../../include/network/NetworkManager.h"
+#include <iostream>
+
+namespace iot {
+
+    Behavior::promise_type::~promise_type() {
+        if (engine) {
+            engine->unlinkBehavior(*this);
+        }
+    }
+
+    void Behavior::promise_type::unhandled_exception() {
+        // The behaviour ends here; the engine keeps running like it does for event callbacks
+        try {
+            std::rethrow_exception(std::current_exception());
+        } catch (const std::exception& e) {
+            std::cerr << "Error in behaviour";
+            if (device.isValid()) {
+                std::cerr << " of device " << device.value;
+            }
+            std::cerr << ": " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Unknown error in behaviour" << std::endl;
+        }
+    }
+
+    void SleepAwaitable::await_suspend(Behavior::Handle coroutine) {
+        engine->scheduleResume(delay, coroutine);
+    }
+
+    void UntilAwaitable::await_suspend(Behavior::Handle waiting) {
+        coroutine = waiting;
+        engine->addUntilWaiter(*this);
+    }
+
+    bool ReceiveAwaitable::await_suspend(Behavior::Handle waiting) {
+        coroutine = waiting;
+        if (!device.isValid()) {
+            device = waiting.promise().device;
+        }
+        if (!device.isValid() || !waiting.promise().engine) {
+            return false;  // nothing to wait on: resume at once with no message
+        }
+        return enlist();
+    }
+
+    void ReceiveAwaitable::deliver(const Message& delivered) {
+        registered = false;
+        message.emplace(delivered);
+        coroutine.promise().engine->scheduleResume(std::chrono::milliseconds(0), coroutine);
+    }
+
+    ReceiveAwaitable NetworkManager::receive(DeviceHandle device) {
+        return ReceiveAwaitable(this, device);
+    }
+
+} // namespace iot
@@ -0,0 +1,204 @@
+#include "../../include/simulation/BranchRunner.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <thread>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace iot {
+
+    BranchRunner::BranchRunner(const std::string& resultDirectory)
+        : directory(resultDirectory)
+        , maxConcurrent(std::max(1u, std::thread::hardware_concurrency())) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            std::cerr << "Cannot create branch result directory " << directory << ": " << error.message() << std::endl;
+        }
+    }
+
+    bool BranchRunner::addBranch(const std::string& name, BranchFunction body) {
+        if (name.empty() || name.find_first_of("/ \t\n") != std::string::npos) {
+            std::cerr << "Invalid branch name '" << name << "'" << std::endl;
+            return false;
+        }
+        for (const auto& branch : branches) {
+            if (branch.name == name) {
+                std::cerr << "Branch " << name << " already exists" << std::endl;
+                return false;
+            }
+        }
+        branches.push_back(Branch{name, std::move(body)});
+        return true;
+    }
+
+    void BranchRunner::setMaxConcurrent(size_t branchesAtOnce) {
+        maxConcurrent = branchesAtOnce == 0 ? std::max(1u, std::thread::hardware_concurrency()) : branchesAtOnce;
+    }
+
+    bool BranchRunner::runAll() {
+        results.clear();
+        for (const auto& branch : branches) {
+            std::string base = directory + "/" + branch.name;
+            results.push_back(BranchResult{branch.name, false, -1, 0, base + ".result", base + ".log", {}, 0.0,
+                                           std::chrono::steady_clock::duration::zero()});
+            std::remove(results.back().resultFile.c_str());
+        }
+
+        size_t threads = countThreads();
+        if (threads > 1) {
+            std::cerr << "Warning: forking branches with " << threads
+                      << " threads alive; only the calling thread exists in each branch" << std::endl;
+        }
+
+        // Anything still buffered would otherwise be printed again by every child
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+
+        std::map<pid_t, size_t> running;
+        std::vector<std::chrono::steady_clock::time_point> forkTimes(branches.size());
+        size_t next = 0;
+        while (next < branches.size() || !running.empty()) {
+            while (next < branches.size() && running.size() < maxConcurrent) {
+                size_t index = next++;
+                forkTimes[index] = std::chrono::steady_clock::now();
+                pid_t pid = fork();
+                if (pid == 0) {
+                    runChild(index, forkTimes[index]);
+                }
+                if (pid < 0) {
+                    std::cerr << "Cannot fork branch " << branches[index].name << ": "
+                              << std::strerror(errno) << std::endl;
+                    continue;
+                }
+                running[pid] = index;
+            }
+            if (running.empty()) {
+                break;
+            }
+
+            int status = 0;
+            pid_t pid = waitpid(-1, &status, 0);
+            if (pid < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "Lost track of branch processes: " << std::strerror(errno) << std::endl;
+                break;
+            }
+            auto entry = running.find(pid);
+            if (entry == running.end()) {
+                continue;  // not one of ours
+            }
+            size_t index = entry->second;
+            running.erase(entry);
+
+            BranchResult& result = results[index];
+            result.wallTime = std::chrono::steady_clock::now() - forkTimes[index];
+            if (WIFEXITED(status)) {
+                result.exitCode = WEXITSTATUS(status);
+            } else if (WIFSIGNALED(status)) {
+                result.signal = WTERMSIG(status);
+            }
+            bool haveResults = readResultFile(result.resultFile, result.metrics);
+            result.succeeded = result.exitCode == 0 && haveResults;
+            auto startup = result.metrics.find("branch.startup_ms");
+            if (startup != result.metrics.end()) {
+                result.startupMs = startup->second;
+            }
+        }
+
+        return std::all_of(results.begin(), results.end(), [](const BranchResult& result) {
+            return result.succeeded;
+        });
+    }
+
+    void BranchRunner::runChild(size_t index, std::chrono::steady_clock::time_point forkTime) const {
+        BranchContext context(branches[index].name, index);
+        context.recordMetric("branch.startup_ms",
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - forkTime).count());
+
+        int log = open(results[index].logFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (log >= 0) {
+            dup2(log, STDOUT_FILENO);
+            dup2(log, STDERR_FILENO);
+            close(log);
+        }
+
+        bool succeeded = false;
+        try {
+            succeeded = branches[index].body(context);
+        } catch (const std::exception& e) {
+            std::cerr << "Error in branch " << context.getName() << ": " << e.what() << std::endl;
+        }
+
+        {
+            std::ofstream file(results[index].resultFile, std::ios::trunc);
+            file << std::setprecision(17);
+            for (const auto& [metric, value] : context.metrics) {
+                file << metric << " " << value << "\n";
+            }
+            succeeded = succeeded && static_cast<bool>(file);
+        }
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+
+        // Skip the parent's atexit handlers and static destructors
+        _exit(succeeded ? 0 : 1);
+    }
+
+    bool BranchRunner::readResultFile(const std::string& path, std::map<std::string, double>& metrics) {
+        std::ifstream file(path);
+        if (!file) {
+            return false;
+        }
+        std::string metric;
+        double value;
+        while (file >> metric >> value) {
+            metrics[metric] = value;
+        }
+        return true;
+    }
+
+    size_t BranchRunner::countThreads() {
+        std::error_code error;
+        size_t threads = 0;
+        for (auto it = std::filesystem::directory_iterator("/proc/self/task", error);
+             !error && it != std::filesystem::directory_iterator(); it.increment(error)) {
+            threads++;
+        }
+        return threads == 0 ? 1 : threads;
+    }
+
+    void BranchRunner::printResults() const {
+        std::cout << "\n=== What-If Branches ===" << std::endl;
+        for (const auto& result : results) {
+            std::cout << std::left << std::setw(20) << result.name
+                      << (result.succeeded ? "OK    " : "FAILED") << std::fixed << std::setprecision(2)
+                      << " startup " << result.startupMs << " ms, wall "
+                      << std::chrono::duration<double, std::milli>(result.wallTime).count() << " ms";
+            if (result.signal != 0) {
+                std::cout << " (signal " << result.signal << ")";
+            } else if (result.exitCode > 0) {
+                std::cout << " (exit " << result.exitCode << ")";
+            }
+            std::cout << std::endl;
+            for (const auto& [metric, value] : result.metrics) {
+                if (metric != "branch.startup_ms") {
+                    std::cout << "    " << std::setw(28) << metric << std::defaultfloat << std::setprecision(6) << value
+                              << std::fixed << std::setprecision(2) << std::endl;
+                }
+            }
+        }
+        std::cout << std::defaultfloat << "========================" << std::endl;
+    }
+
+} // namespace iot
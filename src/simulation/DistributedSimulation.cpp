@@ -0,0 +1,726 @@
+#include "../../include/simulation/DistributedSimulation.h"
+#include "../../include/network/ProtocolCharacteristics.h"
+#include "../../include/utils/CheckpointStream.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace iot {
+
+    namespace {
+        using Duration = std::chrono::steady_clock::duration;
+
+        /**
+         * @brief Frames of the window protocol (first byte of every frame)
+         */
+        enum FrameKind : uint8_t {
+            READY = 1,     // worker -> coordinator: devices, smallest latency, next event
+            WINDOW = 2,    // coordinator -> worker: run up to this offset
+            REPORT = 3,    // worker -> coordinator: next event after the exchange
+            STOP = 4,      // coordinator -> worker: send FINAL and exit
+            FINAL = 5,     // worker -> coordinator: statistics and metrics
+            MESSAGES = 6   // worker -> worker: cross-partition messages of one window
+        };
+
+        constexpr size_t MESSAGE_BATCH_BYTES = 64 * 1024;
+        constexpr std::chrono::milliseconds POLL_INTERVAL(100);
+
+        Duration latencyOf(NetworkManager::Protocol protocol) {
+            return std::chrono::duration_cast<Duration>(
+                std::chrono::duration<double, std::milli>(getProtocolCharacteristics(protocol).latencyMs));
+        }
+
+        /**
+         * @brief Wait for the next frame from an endpoint
+         * @return false if the other side is gone and nothing is left to read
+         */
+        bool receiveFrame(PartitionTransport& link, size_t from, std::vector<uint8_t>& frame,
+                          const std::function<bool()>& alive) {
+            while (true) {
+                uint64_t token = link.prepareWait();
+                if (link.tryReceive(from, frame)) {
+                    return true;
+                }
+                if (!alive()) {
+                    return link.tryReceive(from, frame);
+                }
+                link.wait(token, POLL_INTERVAL);
+            }
+        }
+
+        /**
+         * @brief Send a frame, running whileBlocked each time the link is full
+         */
+        bool sendFrame(PartitionTransport& link, size_t to, const CheckpointWriter& frame,
+                       const std::function<bool()>& alive, const std::function<void()>& whileBlocked = nullptr) {
+            while (true) {
+                uint64_t token = link.prepareWait();
+                if (link.trySend(to, frame.data(), frame.size())) {
+                    return true;
+                }
+                if (whileBlocked) {
+                    whileBlocked();
+                }
+                if (!alive() || frame.size() > link.getMaxFrameSize()) {
+                    return false;
+                }
+                link.wait(token, POLL_INTERVAL);
+            }
+        }
+
+        void writeMessage(CheckpointWriter& writer, Duration arrival, const Message& message) {
+            writer.writeDuration(arrival);
+            writer.writeString(message.getSourceDeviceId());
+            writer.writeString(message.getDestinationDeviceId());
+            writer.writeString(message.getPayload());
+            writer.writeU8(static_cast<uint8_t>(message.getMessageType()));
+            writer.writeVarint(message.getHeaders().size());
+            for (const auto& [key, value] : message.getHeaders()) {
+                writer.writeString(key);
+                writer.writeString(value);
+            }
+        }
+    }
+
+    // ----- DistributedPartition -----
+
+    DistributedPartition::DistributedPartition(size_t partition, size_t partitions, PlacementFunction function)
+        : index(partition)
+        , partitionCount(partitions)
+        , placement(std::move(function))
+        , deviceManager(std::make_shared<DeviceManager>())
+        , networkManager(std::make_shared<NetworkManager>(deviceManager))
+        , engine(std::make_unique<SimulationEngine>(nullptr, nullptr))
+        , outboxes(partitions)
+        , messagesSent(0)
+        , crossPartitionSent(0) {
+        engine->setTimeMode(SimulationEngine::TimeMode::VIRTUAL_TIME);
+        origin = engine->getCurrentTime();
+    }
+
+    size_t DistributedPartition::partitionOf(const std::string& deviceId) const {
+        return std::min(placement(deviceId, partitionCount), partitionCount - 1);
+    }
+
+    bool DistributedPartition::addDevice(const std::string& deviceId,
+                                         const std::function<std::shared_ptr<IoTDevice>()>& create) {
+        deviceManager->internDeviceId(deviceId);
+        if (!owns(deviceId)) {
+            return false;
+        }
+        auto device = create();
+        return device && deviceManager->registerDevice(device);
+    }
+
+    bool DistributedPartition::sendMessage(Message message) {
+        const auto& ids = deviceManager->getIdTable();
+        DeviceHandle source = message.getSourceHandle();
+        if (!source.isValid()) {
+            source = ids->find(message.getSourceDeviceId());
+        }
+        if (!source.isValid() || !deviceManager->deviceExists(source)) {
+            return false;
+        }
+        message.setSourceHandle(source);
+
+        auto arrival = engine->getCurrentTime() - origin + latencyOf(networkManager->getDeviceProtocol(source));
+        messagesSent++;
+
+        size_t target = partitionOf(message.getDestinationDeviceId());
+        if (target == index) {
+            message.setDestinationHandle(ids->find(message.getDestinationDeviceId()));
+            postDelivery(arrival, std::move(message));
+        } else {
+            crossPartitionSent++;
+            outboxes[target].push_back(CrossMessage{arrival, std::move(message)});
+        }
+        return true;
+    }
+
+    void DistributedPartition::postDelivery(std::chrono::steady_clock::duration arrival, Message&& message) {
+        // The callback is too small for a Message, so the engine event carries a slot index
+        uint32_t slot;
+        if (freeInbox.empty()) {
+            slot = static_cast<uint32_t>(inbox.size());
+            inbox.emplace_back();
+        } else {
+            slot = freeInbox.back();
+            freeInbox.pop_back();
+        }
+        uint64_t key = message.getDestinationHandle().value;
+        inbox[slot].emplace(std::move(message));
+
+        DistributedPartition* target = this;
+        EngineDriver(*engine).postAt(origin + arrival, [target, slot]() {
+            Message delivered = std::move(*target->inbox[slot]);
+            target->inbox[slot].reset();
+            target->freeInbox.push_back(slot);
+            target->networkManager->deliverNow(delivered);
+        }, key);
+    }
+
+    // ----- DistributedSimulation -----
+
+    DistributedSimulation::DistributedSimulation(size_t processCount, ScenarioBuilder scenario,
+                                                 const std::string& directory)
+        : processes(std::max<size_t>(1, processCount))
+        , builder(std::move(scenario))
+        , logDirectory(directory)
+        , placement(&DistributedSimulation::hashPlacement)
+        , transport(Transport::SHARED_MEMORY)
+        , tcpAddress("127.0.0.1")
+        , tcpPort(0)
+        , spawnWorkers(true)
+        , ringBytes(1 << 20)
+        , lookahead(std::chrono::milliseconds(1))
+        , elapsed(Duration::zero())
+        , wallTime(Duration::zero())
+        , windows(0) {
+        std::error_code error;
+        std::filesystem::create_directories(logDirectory, error);
+        if (error) {
+            std::cerr << "Cannot create worker log directory " << logDirectory << ": " << error.message() << std::endl;
+        }
+    }
+
+    size_t DistributedSimulation::hashPlacement(const std::string& deviceId, size_t partitions) {
+        uint64_t hash = 0xcbf29ce484222325ULL;  // FNV-1a, then mixed so sequential IDs spread evenly
+        for (unsigned char c : deviceId) {
+            hash = (hash ^ c) * 0x100000001b3ULL;
+        }
+        return static_cast<size_t>(mixBits(hash) % partitions);
+    }
+
+    void DistributedSimulation::setPlacement(DistributedPartition::PlacementFunction function) {
+        placement = function ? std::move(function) : &DistributedSimulation::hashPlacement;
+    }
+
+    void DistributedSimulation::useSharedMemory(size_t ringBytesPerLink) {
+        transport = Transport::SHARED_MEMORY;
+        ringBytes = ringBytesPerLink;
+    }
+
+    void DistributedSimulation::useTcp(const std::string& address, uint16_t port, bool spawnLocalWorkers) {
+        transport = Transport::TCP;
+        tcpAddress = address;
+        tcpPort = port;
+        spawnWorkers = spawnLocalWorkers;
+    }
+
+    double DistributedSimulation::getMetric(const std::string& name) const {
+        auto entry = metrics.find(name);
+        return entry == metrics.end() ? 0.0 : entry->second;
+    }
+
+    bool DistributedSimulation::run(const std::chrono::milliseconds& duration) {
+        stats.assign(processes, PartitionStats{0, 0, 0, 0, 0, 0, Duration::zero(), Duration::zero()});
+        metrics.clear();
+        windows = 0;
+        elapsed = Duration::zero();
+        auto wallStart = std::chrono::steady_clock::now();
+
+        std::shared_ptr<SharedMemoryRegion> region;
+        std::unique_ptr<TcpTransport> tcp;
+        if (transport == Transport::SHARED_MEMORY) {
+            region = std::make_shared<SharedMemoryRegion>(processes + 1, ringBytes);
+            if (!region->isValid()) {
+                return false;
+            }
+        } else {
+            tcp = TcpTransport::listen(tcpAddress, tcpPort, processes);
+            if (!tcp) {
+                return false;
+            }
+        }
+        const bool local = transport == Transport::SHARED_MEMORY || spawnWorkers;
+        const std::string connectAddress = tcpAddress == "0.0.0.0" ? "127.0.0.1" : tcpAddress;
+        const uint16_t port = tcp ? tcp->getPort() : 0;
+
+        // Anything still buffered would otherwise be printed again by every worker
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+
+        std::vector<pid_t> workers;
+        bool forked = true;
+        for (size_t i = 0; local && i < processes; ++i) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                TcpTransport* listener = tcp.get();
+                runChild(i, [&region, listener, &connectAddress, port, i, this]() -> std::unique_ptr<PartitionTransport> {
+                    if (region) {
+                        return std::make_unique<ShmTransport>(region, i);
+                    }
+                    listener->closeListener();
+                    return TcpTransport::connect(connectAddress, port, i, processes);
+                });
+            }
+            if (pid < 0) {
+                std::cerr << "Cannot fork worker " << i << ": " << std::strerror(errno) << std::endl;
+                forked = false;
+                break;
+            }
+            workers.push_back(pid);
+        }
+
+        std::unique_ptr<PartitionTransport> link;
+        if (forked && region) {
+            link = std::make_unique<ShmTransport>(region, processes);
+        } else if (forked) {
+            if (tcp->acceptWorkers(local ? std::chrono::seconds(30) : std::chrono::minutes(10))) {
+                link = std::move(tcp);
+            }
+        }
+
+        // A worker only exits cleanly after its final report, so any other exit fails the run
+        std::vector<int> exitStatus(workers.size(), -1);
+        auto reap = [&](bool block) {
+            bool healthy = true;
+            for (size_t i = 0; i < workers.size(); ++i) {
+                int status = 0;
+                if (exitStatus[i] == -1) {
+                    pid_t reaped;
+                    do {
+                        reaped = waitpid(workers[i], &status, block ? 0 : WNOHANG);
+                    } while (reaped < 0 && errno == EINTR);
+                    if (reaped == workers[i]) {
+                        exitStatus[i] = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+                    } else if (reaped < 0) {
+                        exitStatus[i] = 255;
+                    }
+                }
+                healthy = healthy && exitStatus[i] <= 0;
+            }
+            return healthy;
+        };
+
+        bool succeeded = link && coordinate(*link, std::chrono::duration_cast<Duration>(duration),
+                                             [&reap]() { return reap(false); });
+        if (!succeeded) {
+            for (size_t i = 0; i < workers.size(); ++i) {
+                if (exitStatus[i] == -1) kill(workers[i], SIGKILL);
+            }
+        }
+        if (link) {
+            link->flush(std::chrono::seconds(5));
+        }
+        succeeded = reap(true) && succeeded;
+        for (size_t i = 0; i < workers.size(); ++i) {
+            if (exitStatus[i] != 0) {
+                std::cerr << "Worker " << i << " failed (status " << exitStatus[i] << "), see "
+                          << logDirectory << "/worker_" << i << ".log" << std::endl;
+            }
+        }
+        wallTime = std::chrono::steady_clock::now() - wallStart;
+        return succeeded;
+    }
+
+    bool DistributedSimulation::runWorker(const std::string& host, uint16_t port, size_t index) {
+        if (index >= processes) {
+            std::cerr << "Worker index " << index << " out of range (" << processes << " processes)" << std::endl;
+            return false;
+        }
+        auto link = TcpTransport::connect(host, port, index, processes);
+        if (!link) {
+            return false;
+        }
+        TcpTransport* connection = link.get();
+        size_t coordinatorEndpoint = processes;
+        bool succeeded = runPartition(*link, index, [connection, coordinatorEndpoint]() {
+            return connection->isConnected(coordinatorEndpoint);
+        });
+        link->flush(std::chrono::seconds(5));
+        return succeeded;
+    }
+
+    void DistributedSimulation::runChild(size_t index,
+                                         const std::function<std::unique_ptr<PartitionTransport>()>& connect) {
+        std::string logFile = logDirectory + "/worker_" + std::to_string(index) + ".log";
+        int log = open(logFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (log >= 0) {
+            dup2(log, STDOUT_FILENO);
+            dup2(log, STDERR_FILENO);
+            close(log);
+        }
+
+        bool succeeded = false;
+        auto link = connect();
+        if (link) {
+            pid_t coordinator = getppid();
+            PartitionTransport* connection = link.get();
+            size_t coordinatorEndpoint = processes;
+            try {
+                succeeded = runPartition(*link, index, [coordinator, connection, coordinatorEndpoint]() {
+                    return getppid() == coordinator && connection->isConnected(coordinatorEndpoint);
+                });
+            } catch (const std::exception& e) {
+                std::cerr << "Error in worker " << index << ": " << e.what() << std::endl;
+            }
+            succeeded = link->flush(std::chrono::seconds(5)) && succeeded;
+        }
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+
+        // Skip the coordinator's atexit handlers and static destructors
+        _exit(succeeded ? 0 : 1);
+    }
+
+    bool DistributedSimulation::runPartition(PartitionTransport& link, size_t index,
+                                             const std::function<bool()>& alive) {
+        const size_t coordinator = processes;
+        Message::setNodeId(static_cast<uint8_t>(index + 1));
+        DistributedPartition partition(index, processes, placement);
+        builder(partition);
+
+        PartitionStats own{0, 0, 0, 0, 0, 0, Duration::zero(), Duration::zero()};
+        Duration smallest = Duration::max();
+        for (const auto& device : partition.deviceManager->getAllDevices()) {
+            own.devices++;
+            smallest = std::min(smallest, latencyOf(partition.networkManager->getDeviceProtocol(device->getHandle())));
+        }
+        std::cout << "Worker " << index << " of " << processes << ": " << own.devices << " devices over "
+                  << link.getName() << std::endl;
+
+        auto writeNextEvent = [&partition](CheckpointWriter& writer) {
+            std::chrono::steady_clock::time_point next;
+            bool pending = EngineDriver(*partition.engine).nextEventTime(next);
+            writer.writeBool(pending);
+            writer.writeDuration(pending ? next - partition.origin : Duration::zero());
+        };
+
+        CheckpointWriter ready;
+        ready.writeU8(READY);
+        ready.writeVarint(own.devices);
+        ready.writeBool(smallest != Duration::max());
+        ready.writeDuration(smallest == Duration::max() ? Duration::zero() : smallest);
+        writeNextEvent(ready);
+        if (!sendFrame(link, coordinator, ready, alive)) {
+            return false;
+        }
+
+        std::vector<uint8_t> frame;
+        std::vector<std::vector<std::vector<uint8_t>>> arrived(processes);
+        std::vector<bool> complete(processes);
+        while (true) {
+            auto waitStart = std::chrono::steady_clock::now();
+            if (!receiveFrame(link, coordinator, frame, alive)) {
+                std::cerr << "Worker " << index << " lost the coordinator" << std::endl;
+                return false;
+            }
+            CheckpointReader command(frame.data(), frame.size());
+            uint8_t kind = command.readU8();
+            if (kind == STOP) {
+                own.syncTime += std::chrono::steady_clock::now() - waitStart;
+                break;
+            }
+            Duration windowEnd = command.readDuration();
+            if (kind != WINDOW || !command.ok()) {
+                std::cerr << "Worker " << index << " received an unexpected frame" << std::endl;
+                return false;
+            }
+
+            auto busyStart = std::chrono::steady_clock::now();
+            own.syncTime += busyStart - waitStart;
+            own.eventsExecuted += EngineDriver(*partition.engine).runUntil(partition.origin + windowEnd);
+            auto exchangeStart = std::chrono::steady_clock::now();
+            own.busyTime += exchangeStart - busyStart;
+
+            // Peers may be sending to us while we send to them, so drain while blocked
+            for (size_t peer = 0; peer < processes; ++peer) {
+                arrived[peer].clear();
+                complete[peer] = peer == index;
+            }
+            auto drain = [&]() {
+                for (size_t peer = 0; peer < processes; ++peer) {
+                    while (!complete[peer] && link.tryReceive(peer, frame)) {
+                        complete[peer] = frame.size() > 1 && frame[1] != 0;
+                        arrived[peer].push_back(std::move(frame));
+                        frame.clear();
+                    }
+                }
+            };
+
+            const size_t batchLimit = std::min(MESSAGE_BATCH_BYTES, link.getMaxFrameSize() / 2);
+            for (size_t step = 1; step < processes; ++step) {
+                size_t peer = (index + step) % processes;  // spread the first sends over peers
+                auto& outbox = partition.outboxes[peer];
+                size_t next = 0;
+                do {
+                    CheckpointWriter batch;
+                    batch.writeU8(MESSAGES);
+                    batch.writeBool(false);
+                    while (next < outbox.size() && batch.size() < batchLimit) {
+                        writeMessage(batch, outbox[next].arrival, outbox[next].message);
+                        next++;
+                    }
+                    if (next == outbox.size()) {
+                        batch.data()[1] = 1;  // last frame of this window
+                    }
+                    if (!sendFrame(link, peer, batch, alive, drain)) {
+                        std::cerr << "Worker " << index << " cannot reach worker " << peer << std::endl;
+                        return false;
+                    }
+                } while (next < outbox.size());
+                outbox.clear();
+            }
+
+            while (true) {
+                uint64_t token = link.prepareWait();
+                drain();
+                if (std::all_of(complete.begin(), complete.end(), [](bool done) { return done; })) {
+                    break;
+                }
+                if (!alive()) {
+                    std::cerr << "Worker " << index << " lost a peer" << std::endl;
+                    return false;
+                }
+                link.wait(token, POLL_INTERVAL);
+            }
+
+            // Post in source-partition order so runs are reproducible
+            const auto& ids = partition.deviceManager->getIdTable();
+            for (size_t peer = 0; peer < processes; ++peer) {
+                for (const auto& batch : arrived[peer]) {
+                    CheckpointReader reader(batch.data(), batch.size());
+                    reader.readU8();
+                    reader.readBool();
+                    while (reader.ok() && !reader.atEnd()) {
+                        Duration arrival = reader.readDuration();
+                        std::string source = reader.readString();
+                        std::string destination = reader.readString();
+                        std::string payload = reader.readString();
+                        auto type = static_cast<Message::MessageType>(reader.readU8());
+                        // A new message here, with an ID from this process
+                        Message message(source, destination, payload, type);
+                        size_t headers = reader.readCount();
+                        for (size_t h = 0; h < headers; ++h) {
+                            std::string key = reader.readString();
+                            message.addHeader(key, reader.readString());
+                        }
+                        if (!reader.ok()) {
+                            std::cerr << "Worker " << index << " received a malformed batch" << std::endl;
+                            return false;
+                        }
+                        if (arrival <= windowEnd) {
+                            // Only possible if a peer's latency is below the lookahead
+                            own.lookaheadViolations++;
+                            arrival = windowEnd + Duration(1);
+                        }
+                        message.setSourceHandle(ids->find(source));
+                        message.setDestinationHandle(ids->find(destination));
+                        partition.postDelivery(arrival, std::move(message));
+                        own.crossPartitionReceived++;
+                    }
+                }
+            }
+
+            CheckpointWriter report;
+            report.writeU8(REPORT);
+            writeNextEvent(report);
+            own.syncTime += std::chrono::steady_clock::now() - exchangeStart;
+            if (!sendFrame(link, coordinator, report, alive)) {
+                return false;
+            }
+        }
+
+        own.messagesSent = partition.messagesSent;
+        own.crossPartitionSent = partition.crossPartitionSent;
+        CheckpointWriter results;
+        results.writeU8(FINAL);
+        results.writeVarint(own.devices);
+        results.writeVarint(own.eventsExecuted);
+        results.writeVarint(own.messagesSent);
+        results.writeVarint(own.crossPartitionSent);
+        results.writeVarint(own.crossPartitionReceived);
+        results.writeVarint(own.lookaheadViolations);
+        results.writeDuration(own.busyTime);
+        results.writeDuration(own.syncTime);
+        results.writeVarint(partition.metrics.size());
+        for (const auto& [name, value] : partition.metrics) {
+            results.writeString(name);
+            results.writeDouble(value);
+        }
+        std::cout << "Worker " << index << " done: " << own.eventsExecuted << " events, "
+                  << own.crossPartitionSent << " cross-partition messages sent" << std::endl;
+        return sendFrame(link, coordinator, results, alive);
+    }
+
+    bool DistributedSimulation::coordinate(PartitionTransport& link, Duration duration,
+                                           const std::function<bool()>& alive) {
+        std::vector<uint8_t> frame;
+        std::vector<bool> pending(processes);
+        std::vector<Duration> nextEvent(processes);
+        std::vector<bool> finished(processes);
+
+        // A worker drops its connection once its final report is sent
+        auto healthy = [&]() {
+            for (size_t worker = 0; worker < processes; ++worker) {
+                if (!finished[worker] && !link.isConnected(worker)) return false;
+            }
+            return alive();
+        };
+
+        auto readNextEvent = [&](CheckpointReader& reader, size_t worker) {
+            pending[worker] = reader.readBool();
+            nextEvent[worker] = reader.readDuration();
+        };
+        auto expect = [&](size_t worker, FrameKind kind) -> std::optional<CheckpointReader> {
+            if (!receiveFrame(link, worker, frame, healthy)) {
+                std::cerr << "Worker " << worker << " stopped responding" << std::endl;
+                return std::nullopt;
+            }
+            CheckpointReader reader(frame.data(), frame.size());
+            if (reader.readU8() != kind) {
+                std::cerr << "Unexpected frame from worker " << worker << std::endl;
+                return std::nullopt;
+            }
+            return reader;
+        };
+        auto broadcast = [&](const CheckpointWriter& command) {
+            for (size_t worker = 0; worker < processes; ++worker) {
+                if (!sendFrame(link, worker, command, healthy)) return false;
+            }
+            return true;
+        };
+
+        Duration smallest = Duration::max();
+        for (size_t worker = 0; worker < processes; ++worker) {
+            auto ready = expect(worker, READY);
+            if (!ready) return false;
+            stats[worker].devices = ready->readVarint();
+            bool hasLatency = ready->readBool();
+            Duration latency = ready->readDuration();
+            if (hasLatency) smallest = std::min(smallest, latency);
+            readNextEvent(*ready, worker);
+        }
+        lookahead = smallest == Duration::max() ? Duration(std::chrono::milliseconds(1)) : smallest;
+        // A zero lookahead would stall the windows
+        lookahead = std::max<Duration>(lookahead, std::chrono::microseconds(1));
+
+        while (true) {
+            Duration windowEnd = duration;
+            bool any = false;
+            Duration bound = Duration::zero();
+            for (size_t worker = 0; worker < processes; ++worker) {
+                if (pending[worker]) {
+                    bound = any ? std::min(bound, nextEvent[worker]) : nextEvent[worker];
+                    any = true;
+                }
+            }
+            if (any) {
+                // Nothing can arrive before bound + lookahead, so the window stops just short of it
+                windowEnd = std::min(duration, std::max(bound, elapsed) + lookahead - Duration(1));
+            }
+
+            CheckpointWriter command;
+            command.writeU8(WINDOW);
+            command.writeDuration(windowEnd);
+            if (!broadcast(command)) return false;
+            for (size_t worker = 0; worker < processes; ++worker) {
+                auto report = expect(worker, REPORT);
+                if (!report) return false;
+                readNextEvent(*report, worker);
+            }
+            windows++;
+            elapsed = windowEnd;
+            if (windowEnd >= duration) break;
+        }
+
+        CheckpointWriter stop;
+        stop.writeU8(STOP);
+        if (!broadcast(stop)) return false;
+        
+        // Workers hang up right after their final report, in whatever order
+        // they finish, so reports are taken as they arrive: a worker is only
+        // missing if its connection is gone with no report left to read
+        std::vector<std::vector<uint8_t>> finals(processes);
+        size_t collected = 0;
+        while (collected < processes) {
+            uint64_t token = link.prepareWait();
+            bool arrived = false;
+            for (size_t worker = 0; worker < processes; ++worker) {
+                if (!finished[worker] && link.tryReceive(worker, finals[worker])) {
+                    finished[worker] = true;
+                    collected++;
+                    arrived = true;
+                }
+            }
+            if (arrived) continue;
+            if (!healthy()) {
+                for (size_t worker = 0; worker < processes; ++worker) {
+                    if (!finished[worker] && !link.tryReceive(worker, finals[worker])) {
+                        std::cerr << "Worker " << worker << " stopped responding" << std::endl;
+                        return false;
+                    }
+                    finished[worker] = true;
+                }
+                break;
+            }
+            link.wait(token, POLL_INTERVAL);
+        }
+        
+        // Folded in worker order, so metric sums do not depend on arrival order
+        for (size_t worker = 0; worker < processes; ++worker) {
+            CheckpointReader results(finals[worker].data(), finals[worker].size());
+            if (results.readU8() != FINAL) {
+                std::cerr << "Unexpected frame from worker " << worker << std::endl;
+                return false;
+            }
+            PartitionStats& entry = stats[worker];
+            entry.devices = results.readVarint();
+            entry.eventsExecuted = results.readVarint();
+            entry.messagesSent = results.readVarint();
+            entry.crossPartitionSent = results.readVarint();
+            entry.crossPartitionReceived = results.readVarint();
+            entry.lookaheadViolations = results.readVarint();
+            entry.busyTime = results.readDuration();
+            entry.syncTime = results.readDuration();
+            size_t count = results.readCount();
+            for (size_t m = 0; m < count; ++m) {
+                std::string name = results.readString();
+                metrics[name] += results.readDouble();
+            }
+            if (!results.ok()) {
+                std::cerr << "Malformed final report from worker " << worker << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void DistributedSimulation::printStats() const {
+        std::cout << "\n=== Distributed Simulation Statistics ===" << std::endl;
+        std::cout << "Worker processes: " << processes << " ("
+                  << (transport == Transport::SHARED_MEMORY ? "shared-memory rings" : "TCP") << ")" << std::endl;
+        std::cout << "Lookahead: "
+                  << std::chrono::duration<double, std::milli>(lookahead).count() << " ms" << std::endl;
+        std::cout << "Simulated: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms in "
+                  << windows << " windows (wall "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(wallTime).count() << " ms)" << std::endl;
+        for (size_t i = 0; i < stats.size(); ++i) {
+            const PartitionStats& entry = stats[i];
+            std::cout << "  Worker " << std::setw(2) << i << ": " << entry.devices << " devices, "
+                      << entry.eventsExecuted << " events, " << entry.messagesSent << " sent ("
+                      << entry.crossPartitionSent << " out, " << entry.crossPartitionReceived << " in), busy "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(entry.busyTime).count() << " ms, sync "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(entry.syncTime).count() << " ms";
+            if (entry.lookaheadViolations > 0) {
+                std::cout << ", " << entry.lookaheadViolations << " lookahead violations";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "==========================================" << std::endl;
+    }
+
+} // namespace iot
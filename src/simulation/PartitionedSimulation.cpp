@@ -0,0 +1,284 @@
+#include "../../include/simulation/PartitionedSimulation.h"
+#include "../../include/network/ProtocolCharacteristics.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <barrier>
+#include <thread>
+
+namespace iot {
+
+    PartitionedSimulation::PartitionedSimulation(std::shared_ptr<DeviceManager> dm,
+                                                 std::shared_ptr<NetworkManager> nm,
+                                                 size_t partitionCount)
+        : deviceManager(dm)
+        , networkManager(nm)
+        , lookahead(std::chrono::milliseconds(1))
+        , lookaheadOverride(std::chrono::steady_clock::duration::zero())
+        , elapsed(std::chrono::steady_clock::duration::zero())
+        , windows(0)
+        , lookaheadViolations(0)
+        , wallTime(std::chrono::steady_clock::duration::zero()) {
+        partitionCount = std::max<size_t>(1, partitionCount);
+        for (size_t i = 0; i < partitionCount; ++i) {
+            auto partition = std::make_unique<Partition>();
+            partition->engine = std::make_unique<SimulationEngine>(nullptr, nullptr);
+            partition->engine->setTimeMode(SimulationEngine::TimeMode::VIRTUAL_TIME);
+            partition->origin = partition->engine->getCurrentTime();
+            partitions.push_back(std::move(partition));
+        }
+        std::cout << "Partitioned simulation initialized (" << partitionCount << " logical processes)" << std::endl;
+    }
+
+    PartitionedSimulation::~PartitionedSimulation() = default;
+
+    void PartitionedSimulation::assignPartition(DeviceHandle device, size_t partition) {
+        if (!device.isValid() || partition >= partitions.size()) {
+            std::cerr << "Cannot assign device to partition " << partition << std::endl;
+            return;
+        }
+        if (partitionOf.size() <= device.index()) {
+            partitionOf.resize(device.index() + 1, NO_PARTITION);
+        }
+        partitionOf[device.index()] = static_cast<uint32_t>(partition);
+    }
+
+    size_t PartitionedSimulation::partitionByRegion(const MeshNetwork& mesh) {
+        auto regions = mesh.getRegions();
+        const auto& meshIds = mesh.getIdTable();
+        const auto& deviceIds = deviceManager->getIdTable();
+
+        std::vector<size_t> load(partitions.size(), 0);
+        for (const auto& region : regions) {
+            size_t target = std::min_element(load.begin(), load.end()) - load.begin();
+            for (DeviceHandle handle : region) {
+                // Translate if the mesh was built on its own interning table
+                DeviceHandle device = meshIds == deviceIds ? handle : deviceIds->find(meshIds->name(handle));
+                if (device.isValid()) {
+                    assignPartition(device, target);
+                }
+            }
+            load[target] += region.size();
+        }
+
+        std::cout << "Partitioned " << regions.size() << " mesh regions over "
+                  << partitions.size() << " logical processes" << std::endl;
+        return regions.size();
+    }
+
+    size_t PartitionedSimulation::getPartition(DeviceHandle device) const {
+        if (!device.isValid()) {
+            return 0;
+        }
+        if (device.index() < partitionOf.size() && partitionOf[device.index()] != NO_PARTITION) {
+            return partitionOf[device.index()];
+        }
+        return device.index() % partitions.size();
+    }
+
+    SimulationEngine& PartitionedSimulation::engineFor(DeviceHandle device) {
+        return *partitions[getPartition(device)]->engine;
+    }
+
+    bool PartitionedSimulation::sendMessage(Message message) {
+        const auto& ids = deviceManager->getIdTable();
+        DeviceHandle source = message.getSourceHandle();
+        if (!source.isValid()) {
+            source = ids->find(message.getSourceDeviceId());
+        }
+        DeviceHandle destination = message.getDestinationHandle();
+        if (!destination.isValid()) {
+            destination = ids->find(message.getDestinationDeviceId());
+        }
+        if (!source.isValid() || !destination.isValid()) {
+            return false;
+        }
+        message.setSourceHandle(source);
+        message.setDestinationHandle(destination);
+
+        Partition& from = *partitions[getPartition(source)];
+        auto latency = source.index() < deviceLatency.size() ? deviceLatency[source.index()] : lookahead;
+        auto arrival = from.engine->getCurrentTime() - from.origin + latency;
+        from.messagesSent++;
+
+        size_t target = getPartition(destination);
+        if (partitions[target].get() == &from) {
+            postDelivery(from, arrival, std::move(message));
+        } else {
+            from.crossPartitionSent++;
+            from.outbox.push_back(CrossMessage{arrival, static_cast<uint32_t>(target), std::move(message)});
+        }
+        return true;
+    }
+
+    void PartitionedSimulation::setLookahead(const std::chrono::milliseconds& window) {
+        lookaheadOverride = window;
+    }
+
+    void PartitionedSimulation::refreshLatencies() {
+        const auto& ids = deviceManager->getIdTable();
+        deviceLatency.assign(ids->size(), std::chrono::steady_clock::duration::zero());
+        for (auto& partition : partitions) {
+            partition->devices = 0;
+        }
+
+        auto smallest = std::chrono::steady_clock::duration::max();
+        for (size_t i = 0; i < deviceLatency.size(); ++i) {
+            DeviceHandle device(static_cast<uint32_t>(i));
+            if (!deviceManager->deviceExists(device)) continue;
+            auto protocol = networkManager ? networkManager->getDeviceProtocol(device)
+                                           : NetworkManager::Protocol::CUSTOM;
+            deviceLatency[i] = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::milli>(getProtocolCharacteristics(protocol).latencyMs));
+            smallest = std::min(smallest, deviceLatency[i]);
+            partitions[getPartition(device)]->devices++;
+        }
+
+        if (lookaheadOverride > std::chrono::steady_clock::duration::zero()) {
+            lookahead = lookaheadOverride;
+        } else if (smallest != std::chrono::steady_clock::duration::max()) {
+            lookahead = smallest;
+        }
+        // A zero lookahead would stall the windows
+        lookahead = std::max<std::chrono::steady_clock::duration>(lookahead, std::chrono::microseconds(1));
+    }
+
+    bool PartitionedSimulation::lowerBoundOnTimestamps(std::chrono::steady_clock::duration& bound) {
+        bool any = false;
+        for (auto& partition : partitions) {
+            std::chrono::steady_clock::time_point next;
+            if (EngineDriver(*partition->engine).nextEventTime(next)) {
+                auto offset = next - partition->origin;
+                bound = any ? std::min(bound, offset) : offset;
+                any = true;
+            }
+        }
+        return any;
+    }
+
+    void PartitionedSimulation::exchangeMessages(std::chrono::steady_clock::duration windowEnd) {
+        for (auto& partition : partitions) {
+            for (auto& cross : partition->outbox) {
+                if (cross.arrival <= windowEnd) {
+                    // Only possible with a forced lookahead above a real latency
+                    lookaheadViolations++;
+                    cross.arrival = windowEnd + std::chrono::steady_clock::duration(1);
+                }
+                postDelivery(*partitions[cross.destinationPartition], cross.arrival, std::move(cross.message));
+            }
+            partition->outbox.clear();
+        }
+    }
+
+    void PartitionedSimulation::postDelivery(Partition& destination, std::chrono::steady_clock::duration arrival,
+                                             Message&& message) {
+        uint32_t slot;
+        if (destination.freeInbox.empty()) {
+            slot = static_cast<uint32_t>(destination.inbox.size());
+            destination.inbox.emplace_back();
+        } else {
+            slot = destination.freeInbox.back();
+            destination.freeInbox.pop_back();
+        }
+        uint64_t key = message.getDestinationHandle().value;
+        destination.inbox[slot].emplace(std::move(message));
+
+        Partition* target = &destination;
+        NetworkManager* network = networkManager.get();
+        EngineDriver(*target->engine).postAt(target->origin + arrival, [network, target, slot]() {
+            Message delivered = std::move(*target->inbox[slot]);
+            target->inbox[slot].reset();
+            target->freeInbox.push_back(slot);
+            if (network) {
+                network->deliverNow(delivered);
+            }
+        }, key);
+    }
+
+    size_t PartitionedSimulation::runFor(const std::chrono::milliseconds& duration) {
+        auto wallStart = std::chrono::steady_clock::now();
+        refreshLatencies();
+
+        const auto runEnd = elapsed + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration);
+        auto nextWindowEnd = [&]() {
+            std::chrono::steady_clock::duration bound;
+            if (!lowerBoundOnTimestamps(bound)) {
+                return runEnd;
+            }
+            // Nothing can arrive before bound + lookahead, so the window stops just short of it
+            bound = std::max(bound, elapsed);
+            return std::min(runEnd, bound + lookahead - std::chrono::steady_clock::duration(1));
+        };
+
+        size_t executedBefore = 0;
+        for (const auto& partition : partitions) {
+            executedBefore += partition->eventsExecuted;
+        }
+
+        // Written only in the barrier completion, which every thread waits for
+        std::chrono::steady_clock::duration windowEnd = nextWindowEnd();
+        bool done = false;
+        auto completion = [&]() noexcept {
+            windows++;
+            exchangeMessages(windowEnd);
+            elapsed = windowEnd;
+            if (windowEnd >= runEnd) {
+                done = true;
+            } else {
+                windowEnd = nextWindowEnd();
+            }
+        };
+        std::barrier<decltype(completion)> windowBarrier(static_cast<std::ptrdiff_t>(partitions.size()), completion);
+
+        auto runPartition = [&](size_t index) {
+            Partition& partition = *partitions[index];
+            while (!done) {
+                partition.eventsExecuted += EngineDriver(*partition.engine).runUntil(partition.origin + windowEnd);
+                windowBarrier.arrive_and_wait();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < partitions.size(); ++i) {
+            threads.emplace_back(runPartition, i);
+        }
+        runPartition(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        size_t executed = 0;
+        for (const auto& partition : partitions) {
+            executed += partition->eventsExecuted;
+        }
+        wallTime += std::chrono::steady_clock::now() - wallStart;
+        return executed - executedBefore;
+    }
+
+    PartitionedSimulation::PartitionStats PartitionedSimulation::getPartitionStats(size_t partition) const {
+        const Partition& entry = *partitions[partition];
+        return PartitionStats{entry.devices, entry.eventsExecuted, entry.messagesSent, entry.crossPartitionSent};
+    }
+
+    void PartitionedSimulation::printStats() const {
+        std::cout << "\n=== Partitioned Simulation Statistics ===" << std::endl;
+        std::cout << "Logical processes: " << partitions.size() << std::endl;
+        std::cout << "Lookahead: "
+                  << std::chrono::duration<double, std::milli>(lookahead).count() << " ms" << std::endl;
+        std::cout << "Simulated: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms in "
+                  << windows << " windows (wall "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(wallTime).count() << " ms)" << std::endl;
+        if (lookaheadViolations > 0) {
+            std::cout << "Lookahead violations: " << lookaheadViolations << std::endl;
+        }
+        for (size_t i = 0; i < partitions.size(); ++i) {
+            const Partition& partition = *partitions[i];
+            std::cout << "  LP " << std::setw(2) << i << ": " << partition.devices << " devices, "
+                      << partition.eventsExecuted << " events, " << partition.messagesSent << " sent ("
+                      << partition.crossPartitionSent << " cross-partition)" << std::endl;
+        }
+        std::cout << "==========================================" << std::endl;
+    }
+
+} // namespace iot
@@ -0,0 +1,209 @@
+#include "../../include/simulation/ReplicaRunner.h"
+#include "../../include/network/ProtocolCharacteristics.h"
+#include "../../include/devices/Sensor.h"
+#include "../../include/devices/BatterySensors.h"
+#include "../../include/devices/ProtocolAwareDevice.h"
+#include "../../include/utils/WorkStealingPool.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+namespace iot {
+
+    Replica::Replica(size_t index, uint64_t seed)
+        : index(index)
+        , seed(seed)
+        , deviceManager(std::make_shared<DeviceManager>())
+        , networkManager(std::make_shared<NetworkManager>(deviceManager))
+        , engine(std::make_unique<SimulationEngine>(deviceManager, networkManager)) {
+        // Delivery runs on the engine thread, so one idle shard is enough
+        networkManager->setDeliveryWorkers(1);
+        networkManager->setRandomSeed(streamSeed(0));
+        engine->setTimeMode(SimulationEngine::TimeMode::VIRTUAL_TIME);
+        engine->setRandomSeed(streamSeed(1));
+        // One stream per device and purpose, keyed by handle as devices register
+        deviceManager->setRandomSeed(streamSeed(2));
+        // The day would otherwise start at the wall-clock time; scenarios may move it
+        engine->getSimClock()->setTimeOfDay(0.0);
+    }
+
+    bool Replica::sendMessage(Message message) {
+        const auto& ids = deviceManager->getIdTable();
+        DeviceHandle source = message.getSourceHandle();
+        if (!source.isValid()) {
+            source = ids->find(message.getSourceDeviceId());
+        }
+        DeviceHandle destination = message.getDestinationHandle();
+        if (!destination.isValid()) {
+            destination = ids->find(message.getDestinationDeviceId());
+        }
+        if (!destination.isValid()) {
+            return false;
+        }
+        message.setSourceHandle(source);
+        message.setDestinationHandle(destination);
+
+        if (!networkManager->admitMessage(message)) {
+            return false;
+        }
+
+        auto protocol = source.isValid() ? networkManager->getDeviceProtocol(source)
+                                         : NetworkManager::Protocol::CUSTOM;
+        auto latency = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(getProtocolCharacteristics(protocol).latencyMs));
+        NetworkManager* network = networkManager.get();
+        EngineDriver(*engine).postAt(engine->getCurrentTime() + latency, [network, message = std::move(message)]() {
+            network->deliverNow(message);
+        }, destination.value);
+        return true;
+    }
+
+    ReplicaRunner::ReplicaRunner(ScenarioBuilder scenario, size_t replicaCount)
+        : scenario(std::move(scenario))
+        , replicaCount(std::max<size_t>(1, replicaCount))
+        , baseSeed(0x5EEDULL)
+        , threadCount(0)
+        , wallTime(std::chrono::steady_clock::duration::zero()) {
+    }
+
+    size_t ReplicaRunner::run(const std::chrono::milliseconds& duration) {
+        auto wallStart = std::chrono::steady_clock::now();
+        results.assign(replicaCount, {});
+        std::vector<size_t> events(replicaCount, 0);
+
+        WorkStealingPool pool(std::min(threadCount == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                                                        : threadCount, replicaCount));
+        pool.parallelFor(replicaCount, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                events[i] = runReplica(i, duration, results[i]);
+            }
+        });
+
+        size_t total = 0;
+        for (size_t count : events) {
+            total += count;
+        }
+        wallTime = std::chrono::steady_clock::now() - wallStart;
+        return total;
+    }
+
+    size_t ReplicaRunner::runReplica(size_t index, const std::chrono::milliseconds& duration,
+                                     std::map<std::string, double>& metrics) const {
+        Replica replica(index, replicaSeed(index));
+        scenario(replica);
+
+        size_t executed = replica.engine->runFor(duration);
+        recordStandardMetrics(replica, duration);
+        replica.recordMetric("events", static_cast<double>(executed));
+        metrics = replica.getMetrics();
+        return executed;
+    }
+
+    void ReplicaRunner::recordStandardMetrics(Replica& replica, const std::chrono::milliseconds& duration) {
+        auto stats = replica.networkManager->getStats();
+        replica.recordMetric("network.sent", static_cast<double>(stats.messagesSent));
+        replica.recordMetric("network.received", static_cast<double>(stats.messagesReceived));
+        replica.recordMetric("network.dropped", static_cast<double>(stats.messagesDropped));
+        replica.recordMetric("network.errors", static_cast<double>(stats.errors));
+        size_t offered = stats.messagesSent + stats.messagesDropped;
+        if (offered > 0) {
+            replica.recordMetric("network.delivery_rate", static_cast<double>(stats.messagesReceived) / offered);
+        }
+
+        size_t powered = 0;
+        size_t depleted = 0;
+        double total = 0.0;
+        double lowest = 100.0;
+        for (const auto& device : replica.deviceManager->getAllDevices()) {
+            double level;
+            if (auto* temperature = dynamic_cast<BatteryTemperatureSensor*>(device.get())) {
+                level = temperature->getBatteryLevel();
+            } else if (auto* motion = dynamic_cast<BatteryMotionSensor*>(device.get())) {
+                level = motion->getBatteryLevel();
+            } else if (auto* aware = dynamic_cast<ProtocolAwareDevice*>(device.get())) {
+                level = aware->getBatteryLevel();
+            } else {
+                continue;
+            }
+            powered++;
+            total += level;
+            lowest = std::min(lowest, level);
+            if (level < 5.0) {
+                depleted++;
+            }
+        }
+        if (powered == 0) {
+            return;
+        }
+
+        double mean = total / powered;
+        replica.recordMetric("battery.mean_level", mean);
+        replica.recordMetric("battery.min_level", lowest);
+        replica.recordMetric("battery.depleted", static_cast<double>(depleted));
+        if (mean < 100.0) {
+            // Linear extrapolation of the fleet's average drain
+            double hours = std::chrono::duration<double, std::ratio<3600>>(duration).count();
+            replica.recordMetric("battery.lifetime_hours", hours * 100.0 / (100.0 - mean));
+        }
+    }
+
+    ReplicaRunner::MetricSummary ReplicaRunner::summarize(const std::vector<double>& values) {
+        MetricSummary summary{values.size(), 0.0, 0.0, 0.0, 0.0, 0.0};
+        if (values.empty()) {
+            return summary;
+        }
+
+        summary.min = *std::min_element(values.begin(), values.end());
+        summary.max = *std::max_element(values.begin(), values.end());
+        for (double value : values) {
+            summary.mean += value;
+        }
+        summary.mean /= values.size();
+        if (values.size() > 1) {
+            double squares = 0.0;
+            for (double value : values) {
+                squares += (value - summary.mean) * (value - summary.mean);
+            }
+            summary.stddev = std::sqrt(squares / (values.size() - 1));
+            summary.ci95 = 1.96 * summary.stddev / std::sqrt(static_cast<double>(values.size()));
+        }
+        return summary;
+    }
+
+    std::map<std::string, ReplicaRunner::MetricSummary> ReplicaRunner::summarize() const {
+        std::map<std::string, std::vector<double>> samples;
+        for (const auto& replica : results) {
+            for (const auto& [name, value] : replica) {
+                samples[name].push_back(value);
+            }
+        }
+
+        std::map<std::string, MetricSummary> summaries;
+        for (const auto& [name, values] : samples) {
+            summaries[name] = summarize(values);
+        }
+        return summaries;
+    }
+
+    void ReplicaRunner::printSummary() const {
+        // Leave std::cout formatted as the caller had it
+        std::ios_base::fmtflags savedFlags = std::cout.flags();
+        std::streamsize savedPrecision = std::cout.precision();
+        std::cout << "\n=== Monte Carlo Summary ===" << std::endl;
+        std::cout << "Replicas: " << replicaCount << " (base seed " << baseSeed << ", wall "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(wallTime).count() << " ms)" << std::endl;
+        std::cout << std::left << std::setw(26) << "Metric" << std::setw(14) << "Mean" << std::setw(14)
+                  << "+/- 95%" << std::setw(14) << "Std dev" << std::setw(14) << "Min" << "Max" << std::endl;
+        for (const auto& [name, summary] : summarize()) {
+            std::cout << std::left << std::setw(26) << name << std::setprecision(6)
+                      << std::setw(14) << summary.mean << std::setw(14) << summary.ci95
+                      << std::setw(14) << summary.stddev << std::setw(14) << summary.min
+                      << summary.max << std::endl;
+        }
+        std::cout << "===========================" << std::endl;
+        std::cout.flags(savedFlags);
+        std::cout.precision(savedPrecision);
+    }
+
+} // namespace iot
@@ -0,0 +1,80 @@
+#include "../../include/simulation/SimClock.h"
+#include <cmath>
+#include <ctime>
+
+namespace iot {
+
+    namespace {
+        constexpr std::chrono::seconds SECONDS_PER_DAY(24 * 3600);
+
+        std::chrono::seconds localTimeOfDay() {
+            std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+            std::tm local{};
+            localtime_r(&now, &local);
+            return std::chrono::seconds(local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec);
+        }
+    }
+
+    SimClock::SimClock()
+        : originTimeOfDay(localTimeOfDay())
+        , hour(-1)
+        , temperatureFactor(0.0)
+        , humidityFactor(0.0)
+        , elapsedTicks(0)
+        , followsWallTime(false)
+        , nextWallRefresh(0) {
+        advanceTo(std::chrono::steady_clock::duration::zero());
+    }
+
+    void SimClock::setTimeOfDay(double hours) {
+        setTimeOfDay(std::chrono::seconds(static_cast<long long>(std::fmod(hours, 24.0) * 3600.0)));
+    }
+
+    void SimClock::setTimeOfDay(std::chrono::seconds timeOfDay) {
+        originTimeOfDay = timeOfDay % SECONDS_PER_DAY;
+        hour = -1;
+        advanceTo(getElapsed());
+    }
+
+    void SimClock::advanceTo(std::chrono::steady_clock::duration simulatedElapsed) {
+        elapsedTicks.store(simulatedElapsed.count(), std::memory_order_relaxed);
+
+        auto timeOfDay = (originTimeOfDay + std::chrono::duration_cast<std::chrono::seconds>(simulatedElapsed))
+                         % SECONDS_PER_DAY;
+        int newHour = static_cast<int>(timeOfDay.count() / 3600);
+        if (newHour != hour.load(std::memory_order_relaxed)) {
+            setHour(newHour);
+        }
+    }
+
+    void SimClock::setHour(int newHour) {
+        // Same curves the sensors used to evaluate on every reading
+        temperatureFactor.store(std::sin((newHour - 6) * M_PI / 12.0) * 2.0, std::memory_order_relaxed);
+        humidityFactor.store(std::cos((newHour - 6) * M_PI / 12.0) * 5.0, std::memory_order_relaxed);
+        hour.store(newHour, std::memory_order_relaxed);
+    }
+
+    void SimClock::refreshFromWallTime() const {
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto due = nextWallRefresh.load(std::memory_order_relaxed);
+        if (now < due || !nextWallRefresh.compare_exchange_strong(due,
+                now + std::chrono::steady_clock::duration(std::chrono::seconds(1)).count())) {
+            return;
+        }
+
+        // Only the wall clock instance refreshes itself, and only here
+        SimClock* self = const_cast<SimClock*>(this);
+        self->originTimeOfDay = localTimeOfDay();
+        self->advanceTo(std::chrono::steady_clock::duration::zero());
+    }
+
+    std::shared_ptr<const SimClock> SimClock::wallClock() {
+        static std::shared_ptr<const SimClock> instance = [] {
+            auto clock = std::make_shared<SimClock>();
+            clock->followsWallTime = true;
+            return clock;
+        }();
+        return instance;
+    }
+
+} // namespace iot
@@ -1,27 +1,83 @@
 #include "../../include/simulation/SimulationEngine.h"
+#include "../../include/utils/CounterRng.h"
+#include "../../include/utils/CheckpointStream.h"
+#include "../../include/devices/Sensor.h"
 #include <iostream>
 #include <algorithm>
 #include <thread>
 #include <chrono>
+#include <numeric>
+#include <cerrno>
+#include <ctime>
 
 namespace iot {
     
+    namespace {
+        /**
+         * @brief Where scheduleEvent puts events while a parallel group runs on this thread
+         */
+        struct DeferredSchedule {
+            const SimulationEngine* engine = nullptr;
+            std::vector<SimulationEvent>* events = nullptr;
+        };
+        
+        thread_local DeferredSchedule deferredSchedule;
+    }
+    
     SimulationEngine::SimulationEngine(std::shared_ptr<DeviceManager> dm, 
                                      std::shared_ptr<NetworkManager> nm)
         : deviceManager(dm)
         , networkManager(nm)
         , currentState(State::STOPPED)
+        , startTime(std::chrono::steady_clock::now())
+        , currentTime(startTime)
         , simulationTimeStep(100)  // 100ms default time step
         , simulationSpeed(1.0)
+        , timeMode(TimeMode::REAL_TIME)
+        , overrunPolicy(OverrunPolicy::CATCH_UP)
+        , pacingStats{}
+        , simClock(std::make_shared<SimClock>())
+        , simulatedElapsed(std::chrono::steady_clock::duration::zero())
+        , eventQueue(startTime)
         , running(false)
         , config{1.0, 1000, 0.0, 0.0, 0.0, "INFO", "simulation.log"}
+        , jitterSeed(streamKey(getGlobalSeed(), StreamPurpose::TIMER_JITTER, 0))
+        , jitterCounter(0)
+        , deviceTickEnabled(false)
+        , tickGrainSize(1024)
+        , tickDevicesVersion(~0ULL)
+        , deviceTicks(0)
+        , deviceTickTime(std::chrono::steady_clock::duration::zero())
+        , behaviors(nullptr)
+        , activeBehaviors(0)
+        , untilWaiterCount(0)
+        , quiescentCount(0)
         , totalEventsProcessed(0)
         , simulationSteps(0) {
+        if (deviceManager) {
+            deviceManager->setSimClock(simClock);
+        }
         std::cout << "Simulation Engine initialized" << std::endl;
     }
     
     SimulationEngine::~SimulationEngine() {
         stop();
+        
+        // Destroy behaviours still suspended; their queued resumes are never run
+        {
+            std::lock_guard<std::mutex> lock(behaviorMutex);
+            untilWaiters.clear();
+            untilWaiterCount = 0;
+        }
+        while (true) {
+            Behavior::promise_type* promise;
+            {
+                std::lock_guard<std::mutex> lock(behaviorMutex);
+                promise = behaviors;
+            }
+            if (!promise) break;
+            Behavior::Handle::from_promise(*promise).destroy();
+        }
         std::cout << "Simulation Engine destroyed" << std::endl;
     }
     
@@ -37,8 +93,13 @@ namespace iot {
         
         currentState = State::RUNNING;
         running = true;
-        startTime = std::chrono::steady_clock::now();
-        currentTime = startTime;
+        
+        // Virtual time keeps the clock already used to stamp pending events
+        if (timeMode == TimeMode::REAL_TIME) {
+            std::lock_guard<std::mutex> eventLock(eventMutex);
+            startTime = std::chrono::steady_clock::now();
+            currentTime = startTime;
+        }
         
         // Start network manager if not already started
         if (networkManager) {
@@ -97,47 +158,472 @@ namespace iot {
         return currentState;
     }
     
-    void SimulationEngine::scheduleEvent(const std::chrono::milliseconds& delay,
-                                       std::function<void()> callback,
-                                       const std::string& eventId,
-                                       int priority) {
-        auto scheduledTime = std::chrono::steady_clock::now() + delay;
-        
+    EventHandle SimulationEngine::scheduleEvent(const std::chrono::milliseconds& delay,
+                                              EventCallback callback,
+                                              const std::string& eventId,
+                                              int priority,
+                                              uint64_t affinityKey) {
         SimulationEvent event;
-        event.scheduledTime = scheduledTime;
-        event.eventId = eventId.empty() ? "EVENT_" + std::to_string(totalEventsProcessed) : eventId;
-        event.callback = callback;
+        event.eventId = eventId;
+        event.callback = std::move(callback);
         event.priority = priority;
+        event.affinityKey = affinityKey;
         
+        std::chrono::steady_clock::time_point scheduledTime;
+        std::string scheduledId = eventId.empty() ? "EVENT_" + std::to_string(totalEventsProcessed) : eventId;
+        EventHandle handle;
         {
             std::lock_guard<std::mutex> lock(eventMutex);
-            eventQueue.push(event);
+            scheduledTime = clockNow() + delay;
+            event.scheduledTime = scheduledTime;
+            if (auto* deferred = deferralTarget()) {
+                handle = acquireSlot(event);
+                deferred->push_back(std::move(event));
+            } else {
+                handle = pushWithHandle(std::move(event));
+            }
         }
         
         eventCondition.notify_one();
         
-        std::cout << "Event scheduled: " << event.eventId 
+        std::cout << "Event scheduled: " << scheduledId 
                   << " at " << scheduledTime.time_since_epoch().count() << std::endl;
+        return handle;
+    }
+    
+    EventHandle SimulationEngine::scheduleRepeatingEvent(const std::chrono::milliseconds& interval,
+                                                       EventCallback callback,
+                                                       const std::string& eventId,
+                                                       int priority,
+                                                       const std::chrono::milliseconds& jitter,
+                                                       uint64_t affinityKey) {
+        if (interval <= std::chrono::milliseconds::zero()) {
+            std::cerr << "Error: repeating event interval must be positive" << std::endl;
+            return EventHandle();
+        }
+        
+        SimulationEvent event;
+        event.eventId = eventId;
+        event.callback = std::move(callback);
+        event.priority = priority;
+        event.period = interval;
+        event.jitter = std::max(jitter, std::chrono::milliseconds::zero());
+        event.affinityKey = affinityKey;
+        
+        std::chrono::steady_clock::time_point scheduledTime;
+        std::string scheduledId = eventId.empty() ? "REPEAT_" + std::to_string(totalEventsProcessed) : eventId;
+        EventHandle handle;
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            event.nominalTime = clockNow() + interval;
+            if (auto* deferred = deferralTarget()) {
+                // Jitter is drawn when the batch is flushed, in a fixed order
+                event.scheduledTime = event.nominalTime;
+                scheduledTime = event.scheduledTime;
+                handle = acquireSlot(event);
+                deferred->push_back(std::move(event));
+            } else {
+                event.scheduledTime = event.nominalTime + drawJitter(event.jitter);
+                scheduledTime = event.scheduledTime;
+                handle = pushWithHandle(std::move(event));
+            }
+        }
+        
+        eventCondition.notify_one();
+        
+        std::cout << "Repeating event scheduled: " << scheduledId 
+                  << " every " << interval.count() << " ms, first at "
+                  << scheduledTime.time_since_epoch().count() << std::endl;
+        return handle;
     }
     
-    void SimulationEngine::scheduleRepeatingEvent(const std::chrono::milliseconds& interval,
-                                                std::function<void()> callback,
-                                                const std::string& eventId,
-                                                int priority) {
-        // Create a wrapper that reschedules itself
-        std::string actualEventId = eventId.empty() ? "REPEAT_" + std::to_string(totalEventsProcessed) : eventId;
-        
-        std::function<void()> repeatingCallback = [this, interval, callback, actualEventId, priority]() {
-            callback();  // Execute the original callback
-            // Reschedule the event
-            scheduleEvent(interval, 
-                         [this, interval, callback, actualEventId, priority]() {
-                             scheduleRepeatingEvent(interval, callback, actualEventId, priority);
-                         }, 
-                         actualEventId, priority);
+    namespace {
+        /**
+         * @brief Devices of one cohort, grouped by phase bucket
+         */
+        struct CohortMembers {
+            std::vector<DeviceHandle> handles;   // bucket b is [bucketStart[b], bucketStart[b + 1])
+            std::vector<uint32_t> bucketStart;
+            CohortCallback callback;
+            
+            void fire(size_t bucket) {
+                callback(handles.data() + bucketStart[bucket], bucketStart[bucket + 1] - bucketStart[bucket]);
+            }
         };
+    }
+    
+    std::vector<EventHandle> SimulationEngine::scheduleCohortTimer(const std::chrono::milliseconds& interval,
+                                                 const std::vector<DeviceHandle>& devices,
+                                                 CohortCallback callback,
+                                                 const std::string& cohortId,
+                                                 int priority,
+                                                 const std::chrono::milliseconds& phaseResolution) {
+        if (interval <= std::chrono::milliseconds::zero() || phaseResolution <= std::chrono::milliseconds::zero()) {
+            std::cerr << "Error: cohort interval and phase resolution must be positive" << std::endl;
+            return {};
+        }
+        if (devices.empty() || !callback) {
+            return {};
+        }
+        
+        const size_t bucketCount = static_cast<size_t>(
+            (interval.count() + phaseResolution.count() - 1) / phaseResolution.count());
+        
+        // Counting sort by phase bucket; the hash depends only on the handle
+        // and the interval, so the spread is identical across runs
+        const uint64_t phaseKey = mixBits(jitterSeed ^ static_cast<uint64_t>(interval.count()));
+        std::vector<uint32_t> bucketOf(devices.size());
+        std::vector<uint32_t> bucketStart(bucketCount + 1, 0);
+        for (size_t i = 0; i < devices.size(); ++i) {
+            bucketOf[i] = static_cast<uint32_t>(mixBits(phaseKey ^ devices[i].value) % bucketCount);
+            bucketStart[bucketOf[i] + 1]++;
+        }
+        for (size_t b = 0; b < bucketCount; ++b) {
+            bucketStart[b + 1] += bucketStart[b];
+        }
+        
+        auto cohort = std::make_shared<CohortMembers>();
+        cohort->handles.resize(devices.size());
+        std::vector<uint32_t> cursor(bucketStart.begin(), bucketStart.end() - 1);
+        for (size_t i = 0; i < devices.size(); ++i) {
+            cohort->handles[cursor[bucketOf[i]]++] = devices[i];
+        }
+        cohort->bucketStart = std::move(bucketStart);
+        cohort->callback = std::move(callback);
+        
+        std::string baseId = cohortId.empty() ? "COHORT_" + std::to_string(interval.count()) + "MS" : cohortId;
+        std::vector<EventHandle> handles;
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            auto now = clockNow();
+            auto* deferred = deferralTarget();
+            for (size_t b = 0; b < bucketCount; ++b) {
+                if (cohort->bucketStart[b] == cohort->bucketStart[b + 1]) continue;
+                
+                SimulationEvent event;
+                event.eventId = baseId + "#" + std::to_string(b);
+                event.callback = [cohort, b]() { cohort->fire(b); };
+                event.priority = priority;
+                event.period = interval;
+                event.nominalTime = now + interval * static_cast<int64_t>(b + 1) / static_cast<int64_t>(bucketCount);
+                event.scheduledTime = event.nominalTime;
+                if (deferred) {
+                    handles.push_back(acquireSlot(event));
+                    deferred->push_back(std::move(event));
+                } else {
+                    handles.push_back(pushWithHandle(std::move(event)));
+                }
+            }
+        }
+        
+        eventCondition.notify_one();
+        
+        std::cout << "Cohort timer scheduled: " << baseId << " (" << devices.size() << " devices in "
+                  << handles.size() << " phase buckets, every " << interval.count() << " ms)" << std::endl;
+        return handles;
+    }
+    
+    void SimulationEngine::spawn(Behavior behavior, DeviceHandle device) {
+        if (!behavior) {
+            return;
+        }
+        Behavior::Handle coroutine = behavior.release();
+        Behavior::promise_type& promise = coroutine.promise();
+        promise.engine = this;
+        promise.device = device;
+        {
+            std::lock_guard<std::mutex> lock(behaviorMutex);
+            promise.next = behaviors;
+            if (behaviors) {
+                behaviors->previous = &promise;
+            }
+            behaviors = &promise;
+            activeBehaviors++;
+        }
+        scheduleResume(std::chrono::milliseconds(0), coroutine);
+    }
+    
+    size_t SimulationEngine::getActiveBehaviors() const {
+        std::lock_guard<std::mutex> lock(behaviorMutex);
+        return activeBehaviors;
+    }
+    
+    void SimulationEngine::scheduleResume(const std::chrono::milliseconds& delay, Behavior::Handle coroutine) {
+        DeviceHandle device = coroutine.promise().device;
+        std::chrono::steady_clock::time_point time;
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            time = clockNow() + delay;
+        }
+        postAt(time, [coroutine]() { coroutine.resume(); },
+               device.isValid() ? device.value : SimulationEvent::NO_AFFINITY);
+    }
+    
+    void SimulationEngine::postAt(std::chrono::steady_clock::time_point time, EventCallback callback,
+                                  uint64_t affinityKey) {
+        SimulationEvent event;
+        event.callback = std::move(callback);
+        event.priority = 0;
+        event.affinityKey = affinityKey;
+        event.scheduledTime = time;
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            if (auto* deferred = deferralTarget()) {
+                deferred->push_back(std::move(event));
+            } else {
+                enqueue(std::move(event));
+            }
+        }
+        eventCondition.notify_one();
+    }
+    
+    void SimulationEngine::addUntilWaiter(UntilAwaitable& waiter) {
+        std::lock_guard<std::mutex> lock(behaviorMutex);
+        untilWaiters.push_back(&waiter);
+        untilWaiterCount.store(untilWaiters.size(), std::memory_order_relaxed);
+    }
+    
+    void SimulationEngine::checkUntilWaiters() {
+        {
+            std::lock_guard<std::mutex> lock(behaviorMutex);
+            untilScratch.swap(untilWaiters);
+        }
         
-        scheduleEvent(interval, repeatingCallback, actualEventId, priority);
+        // Predicates run unlocked: they may read engine state or schedule events
+        size_t waiting = 0;
+        for (UntilAwaitable* waiter : untilScratch) {
+            if (waiter->predicate()) {
+                scheduleResume(std::chrono::milliseconds(0), waiter->coroutine);
+            } else {
+                untilScratch[waiting++] = waiter;
+            }
+        }
+        untilScratch.resize(waiting);
+        
+        std::lock_guard<std::mutex> lock(behaviorMutex);
+        untilWaiters.insert(untilWaiters.begin(), untilScratch.begin(), untilScratch.end());
+        untilWaiterCount.store(untilWaiters.size(), std::memory_order_relaxed);
+        untilScratch.clear();
+    }
+    
+    void SimulationEngine::atQuiescentPoint(EventCallback callback) {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        quiescentCallbacks.push_back(std::move(callback));
+        quiescentCount.store(quiescentCallbacks.size(), std::memory_order_relaxed);
+    }
+    
+    void SimulationEngine::runQuiescentCallbacks() {
+        std::vector<EventCallback> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            callbacks.swap(quiescentCallbacks);
+            quiescentCount.store(0, std::memory_order_relaxed);
+        }
+        for (auto& callback : callbacks) {
+            callback();
+        }
+    }
+    
+    void SimulationEngine::unlinkBehavior(Behavior::promise_type& promise) {
+        std::lock_guard<std::mutex> lock(behaviorMutex);
+        if (promise.previous) {
+            promise.previous->next = promise.next;
+        } else {
+            behaviors = promise.next;
+        }
+        if (promise.next) {
+            promise.next->previous = promise.previous;
+        }
+        activeBehaviors--;
+    }
+    
+    void SimulationEngine::rearm(SimulationEvent&& event) {
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            EventSlot* slot = nullptr;
+            if (event.handleSlot != SimulationEvent::NO_SLOT) {
+                if (!slotMatches(event.handleSlot, event.handleGeneration)) {
+                    return;  // cancelled while executing
+                }
+                slot = &eventSlots[event.handleSlot];
+            }
+            
+            if (slot && slot->rescheduled) {
+                event.nominalTime = slot->nextTime;
+                event.scheduledTime = event.nominalTime;
+                slot->rescheduled = false;
+            } else {
+                event.nominalTime += event.period;
+                event.scheduledTime = event.nominalTime + drawJitter(event.jitter);
+            }
+            
+            enqueue(std::move(event));
+        }
+        eventCondition.notify_one();
+    }
+    
+    EventHandle SimulationEngine::pushWithHandle(SimulationEvent&& event) {
+        EventHandle handle = acquireSlot(event);
+        enqueue(std::move(event));
+        return handle;
+    }
+    
+    EventHandle SimulationEngine::acquireSlot(SimulationEvent& event) {
+        uint32_t index;
+        if (freeEventSlots.empty()) {
+            index = static_cast<uint32_t>(eventSlots.size());
+            eventSlots.emplace_back();
+        } else {
+            index = freeEventSlots.back();
+            freeEventSlots.pop_back();
+        }
+        
+        EventSlot& slot = eventSlots[index];
+        slot.queued = false;
+        slot.rescheduled = false;
+        event.handleSlot = index;
+        event.handleGeneration = slot.generation;
+        return EventHandle(this, index, slot.generation);
+    }
+    
+    void SimulationEngine::enqueue(SimulationEvent&& event) {
+        uint32_t slot = event.handleSlot;
+        auto ticket = eventQueue.push(std::move(event));
+        if (slot != SimulationEvent::NO_SLOT) {
+            eventSlots[slot].ticket = ticket;
+            eventSlots[slot].queued = true;
+        }
+    }
+    
+    SimulationEvent SimulationEngine::popEvent() {
+        SimulationEvent event = eventQueue.pop();
+        if (event.handleSlot != SimulationEvent::NO_SLOT) {
+            eventSlots[event.handleSlot].queued = false;
+        }
+        return event;
+    }
+    
+    bool SimulationEngine::claimForExecution(SimulationEvent& event) {
+        if (event.handleSlot == SimulationEvent::NO_SLOT) {
+            return true;
+        }
+        if (!slotMatches(event.handleSlot, event.handleGeneration)) {
+            return false;  // cancelled after it left the queue
+        }
+        if (event.isPeriodic()) {
+            return true;  // the slot lives on; rearm() applies any reschedule
+        }
+        
+        EventSlot& slot = eventSlots[event.handleSlot];
+        if (slot.rescheduled) {
+            event.scheduledTime = slot.nextTime;
+            event.nominalTime = slot.nextTime;
+            slot.rescheduled = false;
+            enqueue(std::move(event));
+            return false;
+        }
+        releaseSlot(event.handleSlot);
+        return true;
+    }
+    
+    std::vector<SimulationEvent>* SimulationEngine::deferralTarget() const {
+        return deferredSchedule.engine == this ? deferredSchedule.events : nullptr;
+    }
+    
+    void SimulationEngine::flushDeferred(std::vector<SimulationEvent>& deferred) {
+        for (auto& event : deferred) {
+            if (event.handleSlot != SimulationEvent::NO_SLOT) {
+                if (!slotMatches(event.handleSlot, event.handleGeneration)) {
+                    continue;  // cancelled before the barrier
+                }
+                EventSlot& slot = eventSlots[event.handleSlot];
+                if (slot.rescheduled) {
+                    event.nominalTime = slot.nextTime;
+                    event.scheduledTime = slot.nextTime;
+                    slot.rescheduled = false;
+                } else if (event.isPeriodic()) {
+                    event.scheduledTime = event.nominalTime + drawJitter(event.jitter);
+                }
+            }
+            enqueue(std::move(event));
+        }
+        deferred.clear();
+    }
+    
+    void SimulationEngine::releaseSlot(uint32_t slot) {
+        EventSlot& entry = eventSlots[slot];
+        entry.generation++;
+        entry.queued = false;
+        entry.rescheduled = false;
+        freeEventSlots.push_back(slot);
+    }
+    
+    bool SimulationEngine::cancelEvent(uint32_t slot, uint32_t generation) {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        if (!slotMatches(slot, generation)) {
+            return false;
+        }
+        
+        // The wheel keeps a tombstone that is reclaimed when its slot is reached
+        if (eventSlots[slot].queued) {
+            eventQueue.take(eventSlots[slot].ticket);
+        }
+        releaseSlot(slot);
+        return true;
+    }
+    
+    bool SimulationEngine::rescheduleEvent(uint32_t slot, uint32_t generation,
+                                           const std::chrono::milliseconds& delay) {
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            if (!slotMatches(slot, generation)) {
+                return false;
+            }
+            
+            EventSlot& entry = eventSlots[slot];
+            auto time = clockNow() + delay;
+            if (!entry.queued) {
+                // Executing repeating event: rearm() picks up the new time
+                entry.rescheduled = true;
+                entry.nextTime = time;
+                return true;
+            }
+            
+            auto event = eventQueue.take(entry.ticket);
+            if (!event) {
+                return false;
+            }
+            event->nominalTime = time;
+            event->scheduledTime = time;
+            enqueue(std::move(*event));
+        }
+        eventCondition.notify_one();
+        return true;
+    }
+    
+    bool SimulationEngine::isEventPending(uint32_t slot, uint32_t generation) const {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        return slotMatches(slot, generation);
+    }
+    
+    bool EventHandle::cancel() {
+        return engine && engine->cancelEvent(slot, generation);
+    }
+    
+    bool EventHandle::reschedule(const std::chrono::milliseconds& delay) {
+        return engine && engine->rescheduleEvent(slot, generation, delay);
+    }
+    
+    bool EventHandle::isPending() const {
+        return engine && engine->isEventPending(slot, generation);
+    }
+    
+    std::chrono::steady_clock::duration SimulationEngine::drawJitter(std::chrono::steady_clock::duration jitter) {
+        if (jitter <= std::chrono::steady_clock::duration::zero()) {
+            return std::chrono::steady_clock::duration::zero();
+        }
+        double fraction = counterUniform(jitterSeed, jitterCounter++);
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(jitter * fraction);
     }
     
     void SimulationEngine::setSimulationSpeed(double speed) {
@@ -145,11 +631,275 @@ namespace iot {
         std::cout << "Simulation speed set to " << simulationSpeed << "x" << std::endl;
     }
     
-    std::chrono::steady_clock::time_point SimulationEngine::getCurrentTime() const {
+    void SimulationEngine::setParallelEventWorkers(size_t workers) {
         std::lock_guard<std::mutex> lock(stateMutex);
+        if (currentState != State::STOPPED) {
+            std::cout << "Parallel event workers can only be changed while the simulation is stopped" << std::endl;
+            return;
+        }
+        
+        eventPool = workers > 1 ? std::make_unique<WorkStealingPool>(workers) : nullptr;
+        std::cout << "Same-timestamp events run on " << getParallelEventWorkers() << " thread(s)" << std::endl;
+    }
+    
+    size_t SimulationEngine::getParallelEventWorkers() const {
+        return eventPool ? eventPool->getThreadCount() : 1;
+    }
+    
+    void SimulationEngine::setTimeMode(TimeMode mode) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (currentState != State::STOPPED) {
+            std::cout << "Time mode can only be changed while the simulation is stopped" << std::endl;
+            return;
+        }
+        
+        timeMode = mode;
+        std::cout << "Simulation time mode set to "
+                  << (mode == TimeMode::VIRTUAL_TIME ? "VIRTUAL" : "REAL_TIME") << std::endl;
+    }
+    
+    void SimulationEngine::setRandomSeed(uint64_t seed) {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (currentState != State::STOPPED) {
+                std::cout << "Random seed can only be changed while the simulation is stopped" << std::endl;
+                return;
+            }
+        }
+        
+        std::lock_guard<std::mutex> lock(eventMutex);
+        jitterSeed = seed;
+        jitterCounter = 0;
+    }
+    
+    SimulationEngine::TimeMode SimulationEngine::getTimeMode() const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return timeMode;
+    }
+    
+    void SimulationEngine::setTimeStep(const std::chrono::milliseconds& step) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (currentState != State::STOPPED) {
+            std::cout << "Time step can only be changed while the simulation is stopped" << std::endl;
+            return;
+        }
+        
+        simulationTimeStep = std::max(step, std::chrono::milliseconds(1));
+    }
+    
+    void SimulationEngine::setOverrunPolicy(OverrunPolicy policy) {
+        std::lock_guard<std::mutex> lock(pacingMutex);
+        overrunPolicy = policy;
+    }
+    
+    SimulationEngine::OverrunPolicy SimulationEngine::getOverrunPolicy() const {
+        std::lock_guard<std::mutex> lock(pacingMutex);
+        return overrunPolicy;
+    }
+    
+    SimulationEngine::PacingStats SimulationEngine::getPacingStats() const {
+        std::lock_guard<std::mutex> lock(pacingMutex);
+        return pacingStats;
+    }
+    
+    void SimulationEngine::resetPacingStats() {
+        std::lock_guard<std::mutex> lock(pacingMutex);
+        pacingStats = PacingStats{};
+    }
+    
+    size_t SimulationEngine::runFor(const std::chrono::milliseconds& duration) {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (timeMode != TimeMode::VIRTUAL_TIME) {
+                std::cout << "runFor requires virtual time mode" << std::endl;
+                return 0;
+            }
+            if (currentState != State::STOPPED) {
+                std::cout << "runFor cannot be used while the simulation thread is active" << std::endl;
+                return 0;
+            }
+        }
+        
+        std::chrono::steady_clock::time_point endTime;
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            endTime = currentTime + duration;
+        }
+        return runUntil(endTime);
+    }
+    
+    size_t SimulationEngine::runUntil(std::chrono::steady_clock::time_point endTime) {
+        size_t executed = 0;
+        size_t stepExecuted = 0;
+        while (processNextTimestamp(endTime, true, stepExecuted)) {
+            executed += stepExecuted;
+        }
+        
+        // The clock reaches the end of the window even if the queue ran dry
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            advanceClock(std::max(currentTime, endTime));
+        }
+        simulationSteps++;
+        
+        return executed;
+    }
+    
+    bool SimulationEngine::nextEventTime(std::chrono::steady_clock::time_point& time) {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        if (eventQueue.empty()) {
+            return false;
+        }
+        time = eventQueue.peek()->scheduledTime;
+        return true;
+    }
+    
+    std::chrono::steady_clock::time_point SimulationEngine::getCurrentTime() const {
+        std::lock_guard<std::mutex> lock(eventMutex);
         return currentTime;
     }
     
+    std::chrono::steady_clock::time_point SimulationEngine::clockNow() const {
+        if (timeMode == TimeMode::VIRTUAL_TIME) {
+            return currentTime;
+        }
+        return std::chrono::steady_clock::now();
+    }
+    
+    void SimulationEngine::advanceClock(std::chrono::steady_clock::time_point time) {
+        if (timeMode == TimeMode::VIRTUAL_TIME) {
+            simulatedElapsed += time - currentTime;
+        } else {
+            // Wall time scaled by the speed factor, so a 1000x run sees 1000x days
+            simulatedElapsed += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                (time - currentTime) * simulationSpeed);
+        }
+        currentTime = time;
+        simClock->advanceTo(simulatedElapsed);
+    }
+    
+    size_t SimulationEngine::getUnnamedPendingEvents() const {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        size_t unnamed = 0;
+        eventQueue.forEach([&unnamed](const SimulationEvent& event, uint64_t) {
+            if (event.eventId.empty()) unnamed++;
+        });
+        return unnamed;
+    }
+    
+    size_t SimulationEngine::writeCheckpoint(CheckpointWriter& out) const {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        out.writeDuration(simulatedElapsed);
+        out.writeSigned(simClock->getStartTimeOfDay().count());
+        out.writeU64(jitterSeed);
+        out.writeVarint(jitterCounter);
+        out.writeVarint(totalEventsProcessed.load());
+        
+        // Saved in queue order so equal-time events keep their order on restore
+        std::vector<std::pair<const SimulationEvent*, uint64_t>> pending;
+        pending.reserve(eventQueue.size());
+        size_t unnamed = 0;
+        eventQueue.forEach([&pending, &unnamed](const SimulationEvent& event, uint64_t sequence) {
+            if (event.eventId.empty()) {
+                unnamed++;
+            } else {
+                pending.emplace_back(&event, sequence);
+            }
+        });
+        std::sort(pending.begin(), pending.end(), [](const auto& a, const auto& b) {
+            if (*a.first > *b.first) return false;
+            if (*b.first > *a.first) return true;
+            return a.second < b.second;
+        });
+        
+        auto now = clockNow();
+        out.writeVarint(pending.size());
+        for (const auto& [event, sequence] : pending) {
+            out.writeString(event->eventId);
+            out.writeDuration(event->scheduledTime - now);
+            out.writeDuration(event->isPeriodic() ? event->nominalTime - now : event->scheduledTime - now);
+            out.writeDuration(event->period);
+            out.writeDuration(event->jitter);
+            out.writeSigned(event->priority);
+            out.writeU64(event->affinityKey);
+        }
+        return unnamed;
+    }
+    
+    bool SimulationEngine::readCheckpoint(CheckpointReader& in, const EventRebinder& rebinder,
+                                          size_t& restored, size_t& dropped) {
+        restored = 0;
+        dropped = 0;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (currentState != State::STOPPED) {
+                std::cerr << "Engine state can only be restored while the simulation is stopped" << std::endl;
+                return false;
+            }
+        }
+        
+        auto elapsed = in.readDuration();
+        std::chrono::seconds timeOfDay(in.readSigned());
+        uint64_t seed = in.readU64();
+        uint64_t counter = in.readVarint();
+        uint64_t processed = in.readVarint();
+        size_t count = in.readCount();
+        std::vector<CheckpointEvent> saved;
+        saved.reserve(count);
+        for (size_t i = 0; i < count && in.ok(); ++i) {
+            CheckpointEvent event;
+            event.eventId = in.readString();
+            event.due = in.readDuration();
+            event.nominalDue = in.readDuration();
+            event.period = in.readDuration();
+            event.jitter = in.readDuration();
+            event.priority = static_cast<int>(in.readSigned());
+            event.affinityKey = in.readU64();
+            saved.push_back(std::move(event));
+        }
+        if (!in.ok()) {
+            return false;
+        }
+        
+        // Rebinding runs unlocked: the scenario may look things up on the engine
+        std::vector<EventCallback> callbacks;
+        callbacks.reserve(saved.size());
+        for (const auto& event : saved) {
+            callbacks.push_back(rebinder ? rebinder(event) : EventCallback());
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            simulatedElapsed = elapsed;
+            simClock->setTimeOfDay(timeOfDay);
+            simClock->advanceTo(simulatedElapsed);
+            jitterSeed = seed;
+            jitterCounter = counter;
+            totalEventsProcessed = processed;
+            
+            auto now = clockNow();
+            for (size_t i = 0; i < saved.size(); ++i) {
+                if (!callbacks[i]) {
+                    dropped++;
+                    continue;
+                }
+                SimulationEvent event;
+                event.eventId = std::move(saved[i].eventId);
+                event.callback = std::move(callbacks[i]);
+                event.priority = saved[i].priority;
+                event.period = saved[i].period;
+                event.jitter = saved[i].jitter;
+                event.affinityKey = saved[i].affinityKey;
+                event.scheduledTime = now + saved[i].due;
+                event.nominalTime = now + saved[i].nominalDue;
+                enqueue(std::move(event));
+                restored++;
+            }
+        }
+        eventCondition.notify_one();
+        return true;
+    }
+    
     bool SimulationEngine::loadConfig(const std::string& configFile) {
     // Create a simple config string for demonstration
     std::string configString = R"(
@@ -202,6 +952,14 @@ max_devices=500
         std::cout << "\n=== Simulation Statistics ===" << std::endl;
         std::cout << "Total Events Processed: " << totalEventsProcessed << std::endl;
         std::cout << "Simulation Steps: " << simulationSteps << std::endl;
+        if (deviceTicks > 0) {
+            std::cout << "Device Ticks: " << deviceTicks << " (" << getDeviceTicksPerSecond()
+                      << " ticks/s over " << tickDevices.size() << " devices)" << std::endl;
+        }
+        size_t behaviorCount = getActiveBehaviors();
+        if (behaviorCount > 0) {
+            std::cout << "Active Behaviours: " << behaviorCount << std::endl;
+        }
         std::cout << "Current State: ";
         switch (getState()) {
             case State::RUNNING: std::cout << "RUNNING"; break;
@@ -210,6 +968,33 @@ max_devices=500
         }
         std::cout << std::endl;
         std::cout << "Simulation Speed: " << simulationSpeed << "x" << std::endl;
+        std::cout << "Time Mode: " << (timeMode == TimeMode::VIRTUAL_TIME ? "VIRTUAL" : "REAL_TIME") << std::endl;
+        
+        PacingStats pacing = getPacingStats();
+        if (timeMode == TimeMode::REAL_TIME && pacing.steps > 0) {
+            auto ms = [](std::chrono::nanoseconds value) { return value.count() / 1e6; };
+            std::cout << "Pacing: " << pacing.steps << " steps, " << pacing.deadlineMisses << " deadline misses, "
+                      << pacing.stepsShed << " steps shed ("
+                      << (getOverrunPolicy() == OverrunPolicy::CATCH_UP ? "CATCH_UP" : "SHED_LOAD") << ")" << std::endl;
+            std::cout << "Lag: current " << ms(pacing.currentLag) << " ms, max " << ms(pacing.maxLag) << " ms, mean "
+                      << (pacing.deadlineMisses > 0 ? ms(pacing.totalLag) / pacing.deadlineMisses : 0.0)
+                      << " ms per miss" << std::endl;
+            std::cout << "Wake-up jitter (max " << pacing.maxJitter.count() / 1000 << " us):" << std::endl;
+            for (size_t i = 0; i < PacingStats::JITTER_BUCKETS; ++i) {
+                if (pacing.jitterHistogram[i] == 0) continue;
+                if (i == 0) {
+                    std::cout << "  < 1 us: ";
+                } else if (i + 1 == PacingStats::JITTER_BUCKETS) {
+                    std::cout << "  >= " << (1ULL << (i - 1)) << " us: ";
+                } else {
+                    std::cout << "  " << (1ULL << (i - 1)) << "-" << (1ULL << i) << " us: ";
+                }
+                std::cout << pacing.jitterHistogram[i] << std::endl;
+            }
+        }
+        std::cout << "Simulated Time Elapsed: " 
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(getCurrentTime() - startTime).count()
+                  << " ms" << std::endl;
         
         if (networkManager) {
             networkManager->printStats();
@@ -220,69 +1005,404 @@ max_devices=500
     void SimulationEngine::runSimulation() {
         std::cout << "Simulation loop started" << std::endl;
         
+        // Real-time steps start on a fixed grid of deadlines, so the time a
+        // step takes does not push the following ones back
+        std::chrono::steady_clock::time_point deadline;
+        bool onSchedule = false;
+        
         while (running) {
             {
                 std::lock_guard<std::mutex> lock(stateMutex);
                 if (currentState != State::RUNNING) {
+                    onSchedule = false;  // start a fresh grid on resume
                     // Wait a bit if paused or stopped
                     std::this_thread::sleep_for(std::chrono::milliseconds(10));
                     continue;
                 }
             }
             
+            if (timeMode == TimeMode::VIRTUAL_TIME) {
+                // Idle only while there is nothing to jump to
+                {
+                    std::unique_lock<std::mutex> lock(eventMutex);
+                    eventCondition.wait_for(lock, simulationTimeStep, [this] {
+                        return !eventQueue.empty() || !running;
+                    });
+                    if (eventQueue.empty()) continue;
+                }
+                
+                simulationStep();
+                processEvents();
+                continue;
+            }
+            
+            if (!onSchedule) {
+                deadline = std::chrono::steady_clock::now();
+                onSchedule = true;
+            }
+            
             // Execute simulation step
             simulationStep();
             
             // Process scheduled events
             processEvents();
             
-            // Apply simulation speed
-            if (simulationSpeed != 1.0) {
-                auto sleepTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::duration<double, std::milli>(simulationTimeStep.count() / simulationSpeed)
-                );
-                std::this_thread::sleep_for(sleepTime);
+            waitForNextDeadline(deadline);
+        }
+        
+        std::cout << "Simulation loop ended" << std::endl;
+    }
+    
+    void SimulationEngine::waitForNextDeadline(std::chrono::steady_clock::time_point& deadline) {
+        auto period = std::max<std::chrono::nanoseconds>(std::chrono::microseconds(1),
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::duration<double, std::milli>(simulationTimeStep.count() / simulationSpeed)));
+        deadline += period;
+        
+        {
+            std::lock_guard<std::mutex> lock(pacingMutex);
+            pacingStats.steps++;
+            auto finished = std::chrono::steady_clock::now();
+            if (finished <= deadline) {
+                pacingStats.currentLag = std::chrono::nanoseconds::zero();
             } else {
-                std::this_thread::sleep_for(simulationTimeStep);
+                auto lag = std::chrono::duration_cast<std::chrono::nanoseconds>(finished - deadline);
+                pacingStats.deadlineMisses++;
+                pacingStats.currentLag = lag;
+                pacingStats.maxLag = std::max(pacingStats.maxLag, lag);
+                pacingStats.totalLag += lag;
+                if (overrunPolicy == OverrunPolicy::CATCH_UP) {
+                    return;  // the next step is already due
+                }
+                auto missed = lag / period + 1;
+                deadline += missed * period;
+                pacingStats.stepsShed += static_cast<size_t>(missed);
             }
         }
         
-        std::cout << "Simulation loop ended" << std::endl;
+        // steady_clock's epoch is unspecified, so the absolute wake-up time is
+        // rebuilt on CLOCK_MONOTONIC from the time left until the deadline
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() > 0) {
+            timespec wakeAt;
+            clock_gettime(CLOCK_MONOTONIC, &wakeAt);
+            int64_t nanos = static_cast<int64_t>(wakeAt.tv_nsec) + remaining.count();
+            wakeAt.tv_sec += static_cast<time_t>(nanos / 1000000000);
+            wakeAt.tv_nsec = static_cast<long>(nanos % 1000000000);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeAt, nullptr) == EINTR) {
+            }
+        }
+        
+        auto jitter = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - deadline);
+        size_t bucket = 0;
+        for (auto micros = jitter.count() / 1000; micros > 0 && bucket + 1 < PacingStats::JITTER_BUCKETS; micros >>= 1) {
+            bucket++;
+        }
+        std::lock_guard<std::mutex> lock(pacingMutex);
+        pacingStats.jitterHistogram[bucket]++;
+        pacingStats.maxJitter = std::max(pacingStats.maxJitter, jitter);
     }
     
     void SimulationEngine::processEvents() {
-        auto now = std::chrono::steady_clock::now();
+        size_t executed = 0;
         
-        std::unique_lock<std::mutex> lock(eventMutex);
-        while (!eventQueue.empty() && eventQueue.top().scheduledTime <= now) {
-            SimulationEvent event = eventQueue.top();
-            eventQueue.pop();
+        if (timeMode == TimeMode::VIRTUAL_TIME) {
+            // Jump to the earliest pending timestamp; everything due at that
+            // instant (including events it schedules for "now") runs this step
+            std::chrono::steady_clock::time_point stepTime;
+            {
+                std::lock_guard<std::mutex> lock(eventMutex);
+                if (eventQueue.empty()) return;
+                stepTime = std::max(currentTime, eventQueue.peek()->scheduledTime);
+            }
             
+            while (processNextTimestamp(stepTime, true, executed)) {
+            }
+            return;
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        while (processNextTimestamp(now, false, executed)) {
+        }
+    }
+    
+    bool SimulationEngine::processNextTimestamp(std::chrono::steady_clock::time_point limit,
+                                                bool moveClock, size_t& executed) {
+        executed = 0;
+        std::unique_lock<std::mutex> lock(eventMutex);
+        if (eventQueue.empty() || eventQueue.peek()->scheduledTime > limit) {
+            return false;
+        }
+        
+        auto time = eventQueue.peek()->scheduledTime;
+        if (moveClock) {
+            // Never move the clock backwards for events scheduled in the past
+            advanceClock(std::max(currentTime, time));
+        }
+        
+        if (!eventPool) {
+            SimulationEvent event = popEvent();
+            bool claimed = claimForExecution(event);
             lock.unlock();  // Unlock before executing callback
             
-            try {
-                if (event.callback) {
-                    event.callback();
-                    totalEventsProcessed++;
+            if (claimed && executeEvent(event)) {
+                executed = 1;
+            }
+            if (claimed && event.isPeriodic()) {
+                rearm(std::move(event));
+            }
+            if (untilWaiterCount.load(std::memory_order_relaxed) != 0) {
+                checkUntilWaiters();
+            }
+            if (quiescentCount.load(std::memory_order_relaxed) != 0) {
+                runQuiescentCallbacks();
+            }
+            return true;
+        }
+        
+        // Take everything due at this instant; the clock stays here until the batch is done
+        while (!eventQueue.empty() && eventQueue.peek()->scheduledTime == time) {
+            dueBatch.push_back(popEvent());
+        }
+        lock.unlock();
+        
+        executed = executeBatch();
+        if (untilWaiterCount.load(std::memory_order_relaxed) != 0) {
+            checkUntilWaiters();
+        }
+        if (quiescentCount.load(std::memory_order_relaxed) != 0) {
+            runQuiescentCallbacks();
+        }
+        return true;
+    }
+    
+    size_t SimulationEngine::executeBatch() {
+        size_t executed = 0;
+        size_t index = 0;
+        while (index < dueBatch.size()) {
+            SimulationEvent& event = dueBatch[index];
+            if (event.affinityKey == SimulationEvent::NO_AFFINITY) {
+                bool claimed;
+                {
+                    std::lock_guard<std::mutex> lock(eventMutex);
+                    claimed = claimForExecution(event);
+                }
+                if (!claimed) {
+                    event.callback = nullptr;
+                } else if (executeEvent(event)) {
+                    executed++;
                 }
-            } catch (const std::exception& e) {
-                std::cerr << "Error executing event " << event.eventId << ": " << e.what() << std::endl;
+                index++;
+                continue;
             }
             
-            lock.lock();  // Lock again for next iteration
+            // A keyed run ends at an unkeyed event or a change of priority
+            size_t end = index + 1;
+            while (end < dueBatch.size() && dueBatch[end].affinityKey != SimulationEvent::NO_AFFINITY &&
+                   dueBatch[end].priority == event.priority) {
+                end++;
+            }
+            executed += executeKeyedRun(index, end);
+            index = end;
         }
+        
+        for (auto& event : dueBatch) {
+            if (event.isPeriodic() && event.callback) {
+                rearm(std::move(event));
+            }
+        }
+        dueBatch.clear();
+        return executed;
+    }
+    
+    size_t SimulationEngine::executeKeyedRun(size_t begin, size_t end) {
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            for (size_t i = begin; i < end; ++i) {
+                if (!claimForExecution(dueBatch[i])) {
+                    dueBatch[i].callback = nullptr;
+                }
+            }
+        }
+        
+        // Group by key; the index breaks ties so each group keeps queue order
+        groupOrder.resize(end - begin);
+        std::iota(groupOrder.begin(), groupOrder.end(), static_cast<uint32_t>(begin));
+        std::sort(groupOrder.begin(), groupOrder.end(), [this](uint32_t a, uint32_t b) {
+            if (dueBatch[a].affinityKey != dueBatch[b].affinityKey) {
+                return dueBatch[a].affinityKey < dueBatch[b].affinityKey;
+            }
+            return a < b;
+        });
+        groupStart.clear();
+        for (size_t i = 0; i < groupOrder.size(); ++i) {
+            if (i == 0 || dueBatch[groupOrder[i]].affinityKey != dueBatch[groupOrder[i - 1]].affinityKey) {
+                groupStart.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        groupStart.push_back(static_cast<uint32_t>(groupOrder.size()));
+        
+        size_t groupCount = groupStart.size() - 1;
+        if (groupDeferred.size() < groupCount) {
+            groupDeferred.resize(groupCount);
+        }
+        
+        std::atomic<size_t> executed{0};
+        size_t grain = std::max<size_t>(1, groupCount / (eventPool->getThreadCount() * 8));
+        eventPool->parallelFor(groupCount, grain, [&](size_t first, size_t last) {
+            DeferredSchedule saved = deferredSchedule;
+            size_t local = 0;
+            for (size_t group = first; group < last; ++group) {
+                deferredSchedule = DeferredSchedule{this, &groupDeferred[group]};
+                for (size_t i = groupStart[group]; i < groupStart[group + 1]; ++i) {
+                    if (executeEvent(dueBatch[groupOrder[i]])) {
+                        local++;
+                    }
+                }
+            }
+            deferredSchedule = saved;
+            executed.fetch_add(local, std::memory_order_relaxed);
+        });
+        
+        // Barrier passed: queue what the groups scheduled, in key order
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            for (size_t group = 0; group < groupCount; ++group) {
+                flushDeferred(groupDeferred[group]);
+            }
+        }
+        eventCondition.notify_one();
+        return executed.load();
+    }
+    
+    bool SimulationEngine::executeEvent(SimulationEvent& event) {
+        try {
+            if (event.callback) {
+                event.callback();
+                totalEventsProcessed++;
+                return true;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error executing event " << (event.eventId.empty() ? "(unnamed)" : event.eventId)
+                      << ": " << e.what() << std::endl;
+        }
+        return false;
     }
     
     void SimulationEngine::simulationStep() {
         simulationSteps++;
-        currentTime = std::chrono::steady_clock::now();
+        if (timeMode == TimeMode::REAL_TIME) {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            advanceClock(std::chrono::steady_clock::now());
+        }
         
-        // This is where you'd add periodic simulation logic
-        // For example, you could trigger device updates, network checks, etc.
+        // Virtual time only steps when it jumps to an event, so device ticks
+        // there are scheduled explicitly (see runDeviceTick)
+        if (timeMode == TimeMode::REAL_TIME && deviceTickEnabled && deviceManager) {
+            runDeviceTick();
+        }
+    }
+    
+    void SimulationEngine::setTickWorkers(size_t workers) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (currentState != State::STOPPED) {
+            std::cout << "Tick workers can only be changed while the simulation is stopped" << std::endl;
+            return;
+        }
         
-        if (simulationSteps % 100 == 0) {  // Every 100 steps
-            // Periodic maintenance or logging
+        tickPool = workers > 1 ? std::make_unique<WorkStealingPool>(workers) : nullptr;
+        deviceTickEnabled = true;
+        std::cout << "Device tick pipeline runs on " << (tickPool ? tickPool->getThreadCount() : 1)
+                  << " thread(s)" << std::endl;
+    }
+    
+    void SimulationEngine::enableDeviceTick(bool enabled) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (currentState != State::STOPPED) {
+            std::cout << "The device tick can only be toggled while the simulation is stopped" << std::endl;
+            return;
         }
+        deviceTickEnabled = enabled;
+    }
+    
+    void SimulationEngine::setTickGrainSize(size_t devices) {
+        tickGrainSize = std::max<size_t>(1, devices);
+    }
+    
+    double SimulationEngine::getDeviceTicksPerSecond() const {
+        double seconds = std::chrono::duration<double>(deviceTickTime).count();
+        return seconds > 0.0 ? deviceTicks / seconds : 0.0;
+    }
+    
+    void SimulationEngine::refreshTickDevices() {
+        uint64_t version = deviceManager->getRegistrationVersion();
+        if (version == tickDevicesVersion) {
+            return;
+        }
+        
+        tickDevices = deviceManager->getAllDevices();
+        tickSensors.clear();
+        for (const auto& device : tickDevices) {
+            if (auto* sensor = dynamic_cast<Sensor*>(device.get())) {
+                tickSensors.push_back(sensor);
+            }
+        }
+        tickDevicesVersion = version;
+    }
+    
+    void SimulationEngine::forEachTickChunk(size_t count, const WorkStealingPool::RangeTask& task) {
+        if (tickPool) {
+            tickPool->parallelFor(count, tickGrainSize, task);
+        } else if (count > 0) {
+            task(0, count);
+        }
+    }
+    
+    size_t SimulationEngine::runDeviceTick() {
+        if (!deviceManager) {
+            return 0;
+        }
+        auto tickStart = std::chrono::steady_clock::now();
+        refreshTickDevices();
+        
+        // 1. Device state
+        forEachTickChunk(tickDevices.size(), [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                IoTDevice& device = *tickDevices[i];
+                if (device.isActiveDevice()) {
+                    device.update();
+                }
+            }
+        });
+        
+        // 2. Sensor sampling
+        forEachTickChunk(tickSensors.size(), [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                tickSensors[i]->sample();
+            }
+        });
+        
+        // 3. Outbox flush, one ingress batch per chunk
+        std::atomic<size_t> flushed{0};
+        if (networkManager) {
+            forEachTickChunk(tickDevices.size(), [this, &flushed](size_t begin, size_t end) {
+                // Reused across ticks; sendBatch leaves moved-from messages behind
+                thread_local std::vector<Message> batch;
+                batch.clear();
+                for (size_t i = begin; i < end; ++i) {
+                    if (tickDevices[i]->getOutboxSize() > 0) {
+                        tickDevices[i]->takeOutbox(batch);
+                    }
+                }
+                if (!batch.empty()) {
+                    flushed.fetch_add(networkManager->sendBatch(batch), std::memory_order_relaxed);
+                }
+            });
+        }
+        
+        deviceTicks++;
+        deviceTickTime += std::chrono::steady_clock::now() - tickStart;
+        return flushed.load();
     }
     
 } // namespace iot
\ No newline at end of file
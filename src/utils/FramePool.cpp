@@ -0,0 +1,96 @@
+#include "../../include/utils/FramePool.h"
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace iot {
+
+    namespace {
+        constexpr size_t CLASS_COUNT = FramePool::MAX_POOLED_SIZE / FramePool::CLASS_SIZE;
+        constexpr size_t SLAB_BYTES = 64 * 1024;
+
+        struct FreeFrame {
+            FreeFrame* next;
+        };
+
+        struct alignas(64) SizeClass {
+            std::mutex mutex;
+            FreeFrame* freeList = nullptr;
+        };
+
+        struct PoolState {
+            SizeClass classes[CLASS_COUNT];
+            std::atomic<size_t> liveFrames{0};
+            std::atomic<size_t> reservedBytes{0};
+            std::atomic<size_t> slabAllocations{0};
+            std::atomic<size_t> heapFallbacks{0};
+        };
+
+        // Never destroyed: frames may still be freed during static destruction
+        PoolState& state() {
+            static PoolState* pool = new PoolState();
+            return *pool;
+        }
+
+        size_t classIndex(size_t size) {
+            return (size + FramePool::CLASS_SIZE - 1) / FramePool::CLASS_SIZE - 1;
+        }
+    }
+
+    void* FramePool::allocate(size_t size) {
+        PoolState& pool = state();
+        if (size == 0 || size > MAX_POOLED_SIZE) {
+            pool.heapFallbacks.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(size == 0 ? 1 : size);
+        }
+
+        size_t index = classIndex(size);
+        SizeClass& sizeClass = pool.classes[index];
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        if (!sizeClass.freeList) {
+            // Carve a new slab into frames of this class
+            const size_t frameBytes = (index + 1) * CLASS_SIZE;
+            const size_t frames = SLAB_BYTES / frameBytes;
+            auto* slab = static_cast<unsigned char*>(::operator new(frames * frameBytes));
+            for (size_t i = frames; i-- > 0;) {
+                auto* frame = reinterpret_cast<FreeFrame*>(slab + i * frameBytes);
+                frame->next = sizeClass.freeList;
+                sizeClass.freeList = frame;
+            }
+            pool.reservedBytes.fetch_add(frames * frameBytes, std::memory_order_relaxed);
+            pool.slabAllocations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        FreeFrame* frame = sizeClass.freeList;
+        sizeClass.freeList = frame->next;
+        pool.liveFrames.fetch_add(1, std::memory_order_relaxed);
+        return frame;
+    }
+
+    void FramePool::deallocate(void* frame, size_t size) noexcept {
+        if (!frame) {
+            return;
+        }
+        PoolState& pool = state();
+        if (size == 0 || size > MAX_POOLED_SIZE) {
+            ::operator delete(frame);
+            return;
+        }
+
+        SizeClass& sizeClass = pool.classes[classIndex(size)];
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        auto* freed = static_cast<FreeFrame*>(frame);
+        freed->next = sizeClass.freeList;
+        sizeClass.freeList = freed;
+        pool.liveFrames.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    FramePool::Stats FramePool::getStats() {
+        PoolState& pool = state();
+        return Stats{pool.liveFrames.load(std::memory_order_relaxed),
+                     pool.reservedBytes.load(std::memory_order_relaxed),
+                     pool.slabAllocations.load(std::memory_order_relaxed),
+                     pool.heapFallbacks.load(std::memory_order_relaxed)};
+    }
+
+} // namespace iot
@@ -0,0 +1,140 @@
+#include "../../include/utils/WorkStealingPool.h"
+#include <algorithm>
+
+namespace iot {
+
+    WorkStealingPool::WorkStealingPool(size_t threadCount)
+        : participantCount(threadCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threadCount)
+        , jobGeneration(0)
+        , activeWorkers(0)
+        , stopping(false)
+        , currentTask(nullptr)
+        , currentCount(0)
+        , currentGrain(1)
+        , steals(0) {
+        queues.reset(new ChunkQueue[participantCount]);
+        for (size_t i = 1; i < participantCount; ++i) {
+            workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            stopping = true;
+        }
+        jobReady.notify_all();
+        for (auto& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    void WorkStealingPool::parallelFor(size_t count, size_t grain, const RangeTask& task) {
+        if (count == 0) {
+            return;
+        }
+        grain = std::max<size_t>(1, grain);
+        size_t chunks = (count + grain - 1) / grain;
+        if (workers.empty() || chunks == 1) {
+            task(0, count);
+            return;
+        }
+
+        std::lock_guard<std::mutex> callLock(callMutex);
+
+        // Deal each participant an equal run of chunks
+        for (size_t i = 0; i < participantCount; ++i) {
+            std::lock_guard<std::mutex> lock(queues[i].mutex);
+            queues[i].next = chunks * i / participantCount;
+            queues[i].end = chunks * (i + 1) / participantCount;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            currentTask = &task;
+            currentCount = count;
+            currentGrain = grain;
+            activeWorkers = workers.size();
+            jobGeneration++;
+        }
+        jobReady.notify_all();
+
+        runChunks(0);
+
+        std::unique_lock<std::mutex> lock(jobMutex);
+        jobDone.wait(lock, [this] { return activeWorkers == 0; });
+        currentTask = nullptr;
+    }
+
+    void WorkStealingPool::workerLoop(size_t index) {
+        uint64_t seenGeneration = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(jobMutex);
+                jobReady.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+                if (stopping) {
+                    return;
+                }
+                seenGeneration = jobGeneration;
+            }
+
+            runChunks(index);
+
+            std::lock_guard<std::mutex> lock(jobMutex);
+            if (--activeWorkers == 0) {
+                jobDone.notify_all();
+            }
+        }
+    }
+
+    void WorkStealingPool::runChunks(size_t index) {
+        size_t chunk;
+        while (true) {
+            if (takeChunk(index, chunk)) {
+                size_t begin = chunk * currentGrain;
+                (*currentTask)(begin, std::min(currentCount, begin + currentGrain));
+            } else if (!stealChunks(index)) {
+                return;  // nothing left anywhere (chunks in transit belong to their thief)
+            }
+        }
+    }
+
+    bool WorkStealingPool::takeChunk(size_t index, size_t& chunk) {
+        ChunkQueue& queue = queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.next >= queue.end) {
+            return false;
+        }
+        chunk = queue.next++;
+        return true;
+    }
+
+    bool WorkStealingPool::stealChunks(size_t thief) {
+        for (size_t offset = 1; offset < participantCount; ++offset) {
+            ChunkQueue& victim = queues[(thief + offset) % participantCount];
+            size_t first;
+            size_t last;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                size_t remaining = victim.end - victim.next;
+                if (remaining == 0) {
+                    continue;
+                }
+                last = victim.end;
+                first = last - (remaining + 1) / 2;
+                victim.end = first;
+            }
+
+            ChunkQueue& own = queues[thief];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.next = first;
+            own.end = last;
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+} // namespace iot
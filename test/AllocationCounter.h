@@ -0,0 +1,83 @@
+#ifndef IOT_SIMULATION_TEST_ALLOCATION_COUNTER_H
+#define IOT_SIMULATION_TEST_ALLOCATION_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @brief Replaces the global allocator to count every heap allocation
+ *
+ * Include from exactly one translation unit of a test program. Every
+ * operator new and delete form is replaced (plain, array, sized,
+ * aligned and nothrow), so every form a library call can reach allocates
+ * from and releases to the same malloc heap.
+ */
+namespace allocation_counter {
+    inline std::atomic<size_t> count{0};
+
+    inline void* allocate(std::size_t size) {
+        count.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    inline void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+        count.fetch_add(1, std::memory_order_relaxed);
+        std::size_t align = static_cast<std::size_t>(alignment);
+        // aligned_alloc wants the size to be a multiple of the alignment
+        return std::aligned_alloc(align, (size + align - 1) / align * align);
+    }
+
+    // Kept out of line: once a replaced delete is inlined next to a call to
+    // operator new, GCC pairs the two and flags the free as mismatched
+    [[gnu::noinline]] inline void release(void* block) noexcept { std::free(block); }
+
+    inline size_t allocations() { return count.load(std::memory_order_relaxed); }
+}
+
+void* operator new(std::size_t size) {
+    if (void* block = allocation_counter::allocate(size)) return block;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* block = allocation_counter::allocate(size)) return block;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocation_counter::allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocation_counter::allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* block = allocation_counter::allocateAligned(size, alignment)) return block;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (void* block = allocation_counter::allocateAligned(size, alignment)) return block;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocation_counter::allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocation_counter::allocateAligned(size, alignment);
+}
+
+void operator delete(void* block) noexcept { allocation_counter::release(block); }
+void operator delete[](void* block) noexcept { allocation_counter::release(block); }
+void operator delete(void* block, std::size_t) noexcept { allocation_counter::release(block); }
+void operator delete[](void* block, std::size_t) noexcept { allocation_counter::release(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { allocation_counter::release(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { allocation_counter::release(block); }
+void operator delete(void* block, std::align_val_t) noexcept { allocation_counter::release(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { allocation_counter::release(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { allocation_counter::release(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept { allocation_counter::release(block); }
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept { allocation_counter::release(block); }
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept { allocation_counter::release(block); }
+
+#endif // IOT_SIMULATION_TEST_ALLOCATION_COUNTER_H
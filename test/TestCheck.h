@@ -0,0 +1,37 @@
+#ifndef IOT_SIMULATION_TEST_TEST_CHECK_H
+#define IOT_SIMULATION_TEST_TEST_CHECK_H
+
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Minimal harness shared by the standalone test programs
+ *
+ * A test prints its banner with begin, reports each condition with check,
+ * and returns finish from main: exit code 0 only if every check passed.
+ */
+namespace test_check {
+    inline int failures = 0;
+
+    inline void check(bool condition, const std::string& description) {
+        std::cout << (condition ? "[PASS] " : "[FAIL] ") << description << std::endl;
+        if (!condition) failures++;
+    }
+
+    inline void begin(const std::string& title) {
+        std::cout << "=========================================" << std::endl;
+        std::cout << title << std::endl;
+        std::cout << "=========================================" << std::endl;
+    }
+
+    inline int finish(const std::string& title) {
+        std::cout << "\n=========================================" << std::endl;
+        std::cout << title << (failures == 0 ? " PASSED" : " FAILED") << std::endl;
+        std::cout << "=========================================" << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+using test_check::check;
+
+#endif // IOT_SIMULATION_TEST_TEST_CHECK_H
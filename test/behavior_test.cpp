@@ -0,0 +1,150 @@
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+#include "../include/core/DeviceManager.h"
+#include "../include/network/NetworkManager.h"
+#include "../include/simulation/SimulationEngine.h"
+#include "AllocationCounter.h"
+#include "TestCheck.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    class InboxDevice : public iot::IoTDevice {
+    public:
+        std::atomic<size_t> received{0};
+
+        explicit InboxDevice(const std::string& id) : IoTDevice(id, "INBOX", "Inbox " + id) {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message&) override { received++; }
+    };
+
+    iot::Behavior reportEvery(iot::SimulationEngine& sim, std::chrono::milliseconds period, int reports,
+                              std::vector<Clock::time_point>& log) {
+        for (int i = 0; i < reports; ++i) {
+            co_await sim.sleep(period);
+            log.push_back(sim.getCurrentTime());
+        }
+    }
+
+    iot::Behavior waitForThreshold(iot::SimulationEngine& sim, const int& level, Clock::time_point& reached) {
+        co_await sim.until([&level]() { return level >= 5; });
+        reached = sim.getCurrentTime();
+    }
+
+    iot::Behavior echo(iot::SimulationEngine& sim, iot::NetworkManager& net, std::string& payload,
+                       Clock::time_point& at) {
+        auto message = co_await net.receive();
+        if (message) {
+            payload = message->getPayload();
+            at = sim.getCurrentTime();
+        }
+    }
+
+    iot::Behavior failing(iot::SimulationEngine& sim) {
+        co_await sim.sleep(std::chrono::seconds(1));
+        throw std::runtime_error("sensor unplugged");
+    }
+
+    iot::Behavior tick(iot::SimulationEngine& sim, size_t& resumes, int loops) {
+        for (int i = 0; i < loops; ++i) {
+            co_await sim.sleep(std::chrono::seconds(1));
+            resumes++;
+        }
+    }
+}
+
+int main() {
+    test_check::begin("Behavior Test");
+
+    auto deviceManager = std::make_shared<iot::DeviceManager>();
+    auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+    iot::SimulationEngine engine(deviceManager, networkManager);
+    engine.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+    auto origin = engine.getCurrentTime();
+
+    // 1. sleep() resumes after exactly the requested simulated time
+    std::vector<Clock::time_point> reports;
+    engine.spawn(reportEvery(engine, std::chrono::seconds(30), 3, reports));
+    check(engine.getActiveBehaviors() == 1, "spawned behaviour is tracked");
+    engine.runFor(std::chrono::seconds(100));
+    check(reports.size() == 3 && reports[0] - origin == std::chrono::seconds(30) &&
+          reports[2] - origin == std::chrono::seconds(90), "sleep resumes after the simulated delay");
+    check(engine.getActiveBehaviors() == 0, "finished behaviour releases its frame");
+
+    // 2. until() resumes at the first event after which the predicate holds
+    int level = 0;
+    Clock::time_point reached{};
+    auto untilOrigin = engine.getCurrentTime();
+    engine.spawn(waitForThreshold(engine, level, reached));
+    engine.scheduleRepeatingEvent(std::chrono::seconds(1), [&level]() { level++; }, "LEVEL");
+    engine.runFor(std::chrono::seconds(10));
+    check(reached - untilOrigin == std::chrono::seconds(5), "until resumes when the predicate becomes true");
+
+    // 3. network.receive() resumes the device's behaviour with the delivered message
+    auto inbox = std::make_shared<InboxDevice>("INBOX");
+    deviceManager->registerDevice(inbox);
+    std::string payload;
+    Clock::time_point receivedAt{};
+    engine.spawn(echo(engine, *networkManager, payload, receivedAt), inbox->getHandle());
+    engine.runFor(std::chrono::milliseconds(1));
+    networkManager->start();
+    networkManager->sendMessage(iot::Message("SENDER", "INBOX", "ping"));
+    auto deadline = Clock::now() + std::chrono::seconds(10);
+    while (payload.empty() && Clock::now() < deadline) {
+        engine.runFor(std::chrono::milliseconds(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    networkManager->stop();
+    check(payload == "ping" && inbox->received == 1, "receive yields the message the device was sent");
+
+    // 4. An exception ends only the throwing behaviour
+    std::cerr.setstate(std::ios::failbit);
+    engine.spawn(failing(engine));
+    engine.runFor(std::chrono::seconds(2));
+    std::cerr.clear();
+    check(engine.getActiveBehaviors() == 0, "a throwing behaviour is cleaned up");
+
+    // 5. Many concurrent behaviours: pooled frames, no allocation per resume
+    {
+        std::ostringstream discard;
+        std::streambuf* original = std::cout.rdbuf(discard.rdbuf());
+        iot::SimulationEngine fleet(deviceManager, networkManager);
+        fleet.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+        const size_t behaviours = 200000;
+        size_t resumes = 0;
+        auto framesBefore = iot::FramePool::getStats();
+        for (size_t i = 0; i < behaviours; ++i) {
+            fleet.spawn(tick(fleet, resumes, 4));
+        }
+        auto framesSpawned = iot::FramePool::getStats();
+        fleet.runFor(std::chrono::milliseconds(1500));  // start + first resume sizes the queue
+        size_t allocationsBefore = allocation_counter::allocations();
+        fleet.runFor(std::chrono::seconds(2));
+        size_t steadyAllocations = allocation_counter::allocations() - allocationsBefore;
+        size_t concurrent = fleet.getActiveBehaviors();
+        fleet.runFor(std::chrono::seconds(2));
+        auto framesDone = iot::FramePool::getStats();
+        std::cout.rdbuf(original);
+
+        size_t frameBytes = (framesSpawned.reservedBytes - framesBefore.reservedBytes) / behaviours;
+        std::cout << "Frames: " << framesSpawned.liveFrames - framesBefore.liveFrames << " live, ~"
+                  << frameBytes << " B each, " << framesSpawned.slabAllocations - framesBefore.slabAllocations
+                  << " slabs" << std::endl;
+        std::cout << "Steady-state allocations: " << steadyAllocations << " over " << behaviours * 2
+                  << " resumes" << std::endl;
+        check(concurrent == behaviours && resumes == behaviours * 4, "200k behaviours run concurrently");
+        check(framesSpawned.heapFallbacks == framesBefore.heapFallbacks, "frames come from the pool");
+        check(steadyAllocations == 0, "resuming behaviours does not allocate");
+        check(framesDone.liveFrames == framesBefore.liveFrames, "finished frames return to the pool");
+    }
+
+    return test_check::finish("Behavior Test");
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <sstream>
+#include "../include/devices/ProtocolSensors.h"
+#include "../include/network/MeshNetwork.h"
+#include "../include/security/IPSecManager.h"
+#include "../include/simulation/ReplicaRunner.h"
+#include "../include/simulation/BranchRunner.h"
+
+/**
+ * @brief Cost of warming a large scenario versus forking what-if branches from it
+ *
+ * Warm-up registers the devices, builds a mesh of 1000-device regions
+ * and creates an IPsec security association per gateway. Each branch
+ * then changes the packet loss and runs one minute of simulated time.
+ *
+ * Usage: ./branch_benchmark [devices] [branches]  (the 500k scenario: ./branch_benchmark 500000)
+ */
+
+int main(int argc, char* argv[]) {
+    size_t deviceCount = 100000;
+    size_t branchCount = 8;
+    if (argc > 1) deviceCount = std::stoul(argv[1]);
+    if (argc > 2) branchCount = std::stoul(argv[2]);
+    const size_t regionSize = 1000;
+
+    std::ostringstream discard;
+    std::streambuf* original = std::cout.rdbuf(discard.rdbuf());
+    auto warmStart = std::chrono::steady_clock::now();
+
+    iot::Replica warmed(0, 1);
+    auto ipsec = std::make_shared<iot::IPSecManager>();
+    warmed.networkManager->setIPSecManager(ipsec);
+    iot::MeshNetwork mesh(10, warmed.deviceManager->getIdTable());
+    std::vector<std::string> ids;
+    for (size_t i = 0; i < deviceCount; ++i) {
+        ids.push_back("DEV_" + std::to_string(i));
+        warmed.deviceManager->registerDevice(std::make_shared<iot::LoRaTemperatureSensor>(ids.back(), ids.back()));
+        warmed.networkManager->setDeviceProtocol(ids.back(), iot::NetworkManager::Protocol::LORA);
+        bool gateway = i % regionSize == 0;
+        mesh.addDevice(ids.back(), gateway);
+        if (!gateway) {
+            mesh.addNeighbor(ids[i - 1], ids.back());
+        } else {
+            ipsec->createSecurityAssociation("10.0." + std::to_string(i / regionSize) + ".1", "10.255.0.1");
+        }
+    }
+    for (size_t i = 0; i < deviceCount; i += 10) {
+        size_t gateway = i / regionSize * regionSize;
+        warmed.engine->scheduleRepeatingEvent(std::chrono::seconds(30), [&warmed, &ids, i, gateway]() {
+            warmed.sendMessage(iot::Message(ids[i], ids[gateway], "report"));
+        }, "REPORT");
+    }
+    auto warmTime = std::chrono::steady_clock::now() - warmStart;
+    std::cout.rdbuf(original);
+
+    iot::BranchRunner runner("branch_benchmark_results");
+    for (size_t b = 0; b < branchCount; ++b) {
+        double loss = 0.05 * b;
+        runner.addBranch("loss_" + std::to_string(b * 5), [&warmed, loss](iot::BranchContext& branch) {
+            warmed.networkManager->setNetworkConditions(loss);
+            branch.recordMetric("events", static_cast<double>(warmed.engine->runFor(std::chrono::minutes(1))));
+            auto stats = warmed.networkManager->getStats();
+            branch.recordMetric("received", static_cast<double>(stats.messagesReceived));
+            return true;
+        });
+    }
+    auto branchStart = std::chrono::steady_clock::now();
+    runner.runAll();
+    auto branchTime = std::chrono::steady_clock::now() - branchStart;
+
+    double startup = 0.0;
+    for (const auto& result : runner.getResults()) {
+        startup = std::max(startup, result.startupMs);
+    }
+
+    runner.printResults();
+    std::cout << "\n=== BRANCH BENCHMARK ===" << std::endl;
+    std::cout << "Devices: " << deviceCount << ", branches: " << branchCount << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Warm-up:               " << std::chrono::duration<double, std::milli>(warmTime).count() << " ms" << std::endl;
+    std::cout << "Slowest branch start:  " << startup << " ms" << std::endl;
+    std::cout << "All branches (wall):   " << std::chrono::duration<double, std::milli>(branchTime).count() << " ms" << std::endl;
+    std::cout << "========================" << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <cstdlib>
+#include <csignal>
+#include "../include/devices/ProtocolSensors.h"
+#include "../include/simulation/ReplicaRunner.h"
+#include "../include/simulation/BranchRunner.h"
+#include "TestCheck.h"
+
+namespace {
+    class Gateway : public iot::IoTDevice {
+    public:
+        size_t reports = 0;
+
+        Gateway() : IoTDevice("GATEWAY", "GATEWAY", "Gateway") {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message&) override {
+            if (isActive) reports++;
+        }
+    };
+
+    double metric(const iot::BranchRunner::BranchResult& result, const std::string& name) {
+        auto entry = result.metrics.find(name);
+        return entry == result.metrics.end() ? -1.0 : entry->second;
+    }
+}
+
+int main() {
+    test_check::begin("Branch Runner Test");
+
+    // Warm up once: 2000 LoRa sensors reporting to a gateway every 10 s
+    std::ostringstream discard;
+    std::streambuf* original = std::cout.rdbuf(discard.rdbuf());
+    iot::Replica warmed(0, 7);
+    auto gateway = std::make_shared<Gateway>();
+    warmed.deviceManager->registerDevice(gateway);
+    for (size_t i = 0; i < 2000; ++i) {
+        std::string id = "LORA_" + std::to_string(i);
+        warmed.deviceManager->registerDevice(std::make_shared<iot::LoRaTemperatureSensor>(id, id));
+        warmed.networkManager->setDeviceProtocol(id, iot::NetworkManager::Protocol::LORA);
+        warmed.engine->scheduleRepeatingEvent(std::chrono::seconds(10), [&warmed, id]() {
+            warmed.sendMessage(iot::Message(id, "GATEWAY", "report"));
+        }, "REPORT_" + id);
+    }
+    std::vector<char> warmedState(64 << 20, 1);  // stands in for a large warmed-up heap
+    auto warmedTime = warmed.engine->getCurrentTime();
+    std::cout.rdbuf(original);
+
+    auto runFor = [&warmed, &gateway](iot::BranchContext& branch) {
+        size_t events = warmed.engine->runFor(std::chrono::minutes(10));
+        branch.recordMetric("events", static_cast<double>(events));
+        branch.recordMetric("reports", static_cast<double>(gateway->reports));
+        return true;
+    };
+
+    iot::BranchRunner runner("branch_results");
+    runner.addBranch("baseline", runFor);
+    runner.addBranch("lossy", [&](iot::BranchContext& branch) {
+        warmed.networkManager->setNetworkConditions(0.5);
+        return runFor(branch);
+    });
+    runner.addBranch("gateway_down", [&](iot::BranchContext& branch) {
+        gateway->setActive(false);
+        std::cout << "Gateway failed" << std::endl;
+        return runFor(branch);
+    });
+    runner.addBranch("scribbler", [&](iot::BranchContext& branch) {
+        std::fill(warmedState.begin(), warmedState.end(), 2);
+        return runFor(branch);
+    });
+    runner.addBranch("crash", [](iot::BranchContext&) -> bool {
+        std::abort();
+    });
+    check(!runner.addBranch("baseline", runFor), "branch names are unique");
+
+    bool allSucceeded = runner.runAll();
+    runner.printResults();
+    const auto& results = runner.getResults();
+
+    // 1. Branches start from the warmed state and diverge independently
+    //    (LoRa reports take a second, so the last round is still in flight)
+    const auto& baseline = results[0];
+    check(baseline.succeeded && metric(baseline, "reports") == 2000 * 59, "baseline branch runs the warmed scenario");
+    check(results[1].succeeded && metric(results[1], "reports") > 0 &&
+          metric(results[1], "reports") < metric(baseline, "reports") * 0.6, "lossy branch loses reports");
+    check(results[2].succeeded && metric(results[2], "reports") == 0, "gateway failure branch gets no reports");
+
+    // 2. Nothing a branch does reaches the parent
+    check(gateway->reports == 0 && gateway->isActiveDevice() && warmed.engine->getCurrentTime() == warmedTime,
+          "the parent simulation is untouched");
+    check(warmedState.front() == 1 && warmedState.back() == 1, "branch writes are copy-on-write");
+
+    // 3. A crashing branch is reported without affecting the others
+    const auto& crash = results[4];
+    check(!allSucceeded && !crash.succeeded && crash.signal == SIGABRT, "a crashing branch is reported");
+    check(results[3].succeeded, "other branches finish normally");
+
+    // 4. Per-branch files and startup cost
+    std::ifstream log("branch_results/gateway_down.log");
+    std::string line;
+    std::getline(log, line);
+    check(line == "Gateway failed", "branch output goes to its own log");
+    check(baseline.startupMs >= 0.0 && baseline.startupMs < 1000.0, "branches start without re-initialising");
+
+    return test_check::finish("Branch Runner Test");
+}
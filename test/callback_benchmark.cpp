@@ -0,0 +1,116 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include <atomic>
+#include "../include/simulation/TimingWheel.h"
+#include "../include/utils/InlineFunction.h"
+#include "AllocationCounter.h"
+
+/**
+ * @brief Schedule + fire throughput of std::function versus EventCallback
+ *
+ * Each round schedules a batch of timer events with random delays into a
+ * TimingWheel (as SimulationEngine does), then pops and fires all of them.
+ * Captures of 16, 40 and 64 bytes cover the three cases. 16 B fits both
+ * small buffers. 40 B fits only the 48-byte inline buffer. 64 B spills to
+ * the heap for both, and shows up in EventCallback's fallback counter.
+ *
+ * Usage: ./callback_benchmark [events_per_round] [rounds]
+ */
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    template <typename Callback>
+    struct BenchEvent {
+        Clock::time_point scheduledTime;
+        int priority = 0;
+        Callback callback;
+
+        bool operator>(const BenchEvent& other) const {
+            if (scheduledTime == other.scheduledTime) return priority < other.priority;
+            return scheduledTime > other.scheduledTime;
+        }
+    };
+
+    template <size_t Words>
+    struct Capture {
+        uint64_t* sink;
+        uint64_t words[Words];
+    };
+
+    struct Result {
+        double nsPerEvent;
+        double allocationsPerEvent;
+    };
+
+    template <typename Callback, size_t Words>
+    Result run(size_t eventsPerRound, size_t rounds) {
+        iot::TimingWheel<BenchEvent<Callback>> wheel;
+        std::mt19937_64 rng(11);
+        std::uniform_int_distribution<long long> delayMs(1, 1000);
+        uint64_t sink = 0;
+        auto now = Clock::now();
+
+        size_t allocationsBefore = allocation_counter::allocations();
+        auto start = Clock::now();
+        for (size_t round = 0; round < rounds; ++round) {
+            for (size_t i = 0; i < eventsPerRound; ++i) {
+                Capture<Words> capture{&sink, {}};
+                capture.words[0] = i;
+                BenchEvent<Callback> event;
+                event.scheduledTime = now + std::chrono::milliseconds(delayMs(rng));
+                event.callback = [capture]() { *capture.sink += capture.words[0]; };
+                wheel.push(std::move(event));
+            }
+            while (!wheel.empty()) {
+                auto event = wheel.pop();
+                now = event.scheduledTime;
+                event.callback();
+            }
+        }
+        double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        size_t allocations = allocation_counter::allocations() - allocationsBefore;
+
+        const double total = static_cast<double>(eventsPerRound) * rounds;
+        if (sink == 42) std::cout << "";  // keep the callbacks observable
+        return {elapsed / total, allocations / total};
+    }
+
+    template <size_t Words>
+    void report(size_t eventsPerRound, size_t rounds) {
+        Result standard = run<std::function<void()>, Words>(eventsPerRound, rounds);
+        Result inlined = run<iot::InlineFunction<void()>, Words>(eventsPerRound, rounds);
+        std::cout << std::left << std::setw(12) << sizeof(Capture<Words>) << std::fixed << std::setprecision(1)
+                  << std::setw(18) << standard.nsPerEvent << std::setw(18) << inlined.nsPerEvent
+                  << std::setprecision(2) << std::setw(18) << standard.allocationsPerEvent
+                  << inlined.allocationsPerEvent << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t eventsPerRound = 100000;
+    size_t rounds = 20;
+    if (argc > 1) eventsPerRound = std::stoul(argv[1]);
+    if (argc > 2) rounds = std::stoul(argv[2]);
+
+    // Warm the wheel's storage pattern once so the first column is not penalised
+    run<std::function<void()>, 1>(eventsPerRound, 1);
+
+    std::cout << "\n=== EVENT CALLBACK BENCHMARK ===" << std::endl;
+    std::cout << "Events per round: " << eventsPerRound << ", rounds: " << rounds << std::endl;
+    std::cout << std::left << std::setw(12) << "Capture B" << std::setw(18) << "function ns/ev"
+              << std::setw(18) << "inline ns/ev" << std::setw(18) << "function alloc/ev"
+              << "inline alloc/ev" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------" << std::endl;
+    report<1>(eventsPerRound, rounds);
+    report<4>(eventsPerRound, rounds);
+    report<7>(eventsPerRound, rounds);
+    std::cout << "EventCallback heap fallbacks: " << iot::InlineFunction<void()>::heapFallbacks() << std::endl;
+    std::cout << "================================================================================" << std::endl;
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <string>
+#include "../include/devices/BatterySensors.h"
+#include "../include/simulation/ReplicaRunner.h"
+#include "../include/simulation/SimulationCheckpoint.h"
+
+/**
+ * @brief Checkpoint capture, write and restore times for a large fleet
+ *
+ * Each device has a reading timer, so the engine section holds one
+ * pending event per device. Restoring is compared against building the
+ * same fleet with per-device registerDevice calls; both include device
+ * construction, so registration is also timed on its own.
+ *
+ * Usage: ./checkpoint_benchmark [devices]
+ */
+
+namespace {
+    double millis(std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    iot::EventCallback reading(iot::Replica& replica, const std::string& id) {
+        auto* sensor = static_cast<iot::Sensor*>(replica.deviceManager->getDevice(id).get());
+        return [sensor]() { sensor->sample(); };
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t deviceCount = 100000;
+    if (argc > 1) deviceCount = std::stoul(argv[1]);
+    const std::string path = "checkpoint_benchmark.snap";
+
+    std::cout.setstate(std::ios::failbit);
+    iot::Replica original(0, 1);
+    auto buildStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < deviceCount; ++i) {
+        std::string id = "BAT_" + std::to_string(i);
+        original.deviceManager->registerDevice(std::make_shared<iot::BatteryTemperatureSensor>(id, id));
+    }
+    auto buildTime = std::chrono::steady_clock::now() - buildStart;
+    for (size_t i = 0; i < deviceCount; ++i) {
+        std::string id = "BAT_" + std::to_string(i);
+        original.engine->scheduleRepeatingEvent(std::chrono::seconds(60), reading(original, id), "READ_" + id);
+    }
+    original.engine->runFor(std::chrono::minutes(5));
+
+    iot::SimulationCheckpoint checkpoint(original.deviceManager, original.networkManager, *original.engine);
+    auto saveStart = std::chrono::steady_clock::now();
+    checkpoint.saveAsync(path);
+    auto pause = checkpoint.getLastCapturePause();
+    checkpoint.waitForWrite();
+    auto saveTime = std::chrono::steady_clock::now() - saveStart;
+
+    iot::Replica restored(0, 1);
+    iot::SimulationCheckpoint loader(restored.deviceManager, restored.networkManager, *restored.engine);
+    loader.restore(path, [&restored](const iot::CheckpointEvent& event) {
+        return reading(restored, event.eventId.substr(5));
+    });
+
+    // Registration alone, with the devices already constructed
+    std::vector<std::shared_ptr<iot::IoTDevice>> fleet;
+    for (size_t i = 0; i < deviceCount; ++i) {
+        std::string id = "BAT_" + std::to_string(i);
+        fleet.push_back(std::make_shared<iot::BatteryTemperatureSensor>(id, id));
+    }
+    iot::DeviceManager oneByOne;
+    auto singleStart = std::chrono::steady_clock::now();
+    for (const auto& device : fleet) {
+        oneByOne.registerDevice(device);
+    }
+    auto singleTime = std::chrono::steady_clock::now() - singleStart;
+    iot::DeviceManager bulk;
+    auto bulkStart = std::chrono::steady_clock::now();
+    bulk.registerDevices(fleet);
+    auto bulkTime = std::chrono::steady_clock::now() - bulkStart;
+    std::cout.clear();
+
+    const auto& report = loader.getLastRestore();
+    std::cout << "\n=== CHECKPOINT BENCHMARK ===" << std::endl;
+    std::cout << "Devices: " << deviceCount << ", pending events: " << report.events << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Capture pause:              " << millis(pause) << " ms" << std::endl;
+    std::cout << "Capture + background write: " << millis(saveTime) << " ms" << std::endl;
+    std::cout << "Restore (mmap + bulk):      " << millis(report.loadTime) << " ms" << std::endl;
+    std::cout << "Build with registerDevice:  " << millis(buildTime) << " ms" << std::endl;
+    std::cout << "Registration only:          " << millis(singleTime) << " ms one by one, "
+              << millis(bulkTime) << " ms bulk" << std::endl;
+    std::cout << "============================" << std::endl;
+    return report.devices == deviceCount ? 0 : 1;
+}
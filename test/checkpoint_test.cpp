@@ -0,0 +1,285 @@
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include "../include/devices/BatterySensors.h"
+#include "../include/devices/ProtocolSensors.h"
+#include "../include/devices/ConcreteActuators.h"
+#include "../include/network/MeshNetwork.h"
+#include "../include/security/IPSecManager.h"
+#include "../include/simulation/ReplicaRunner.h"
+#include "../include/simulation/SimulationCheckpoint.h"
+#include "TestCheck.h"
+
+namespace {
+    class Gateway : public iot::IoTDevice {
+    public:
+        size_t reports = 0;
+
+        Gateway(const std::string& id, const std::string& name) : IoTDevice(id, "Gateway", name) {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message&) override { reports++; }
+
+        void writeState(iot::CheckpointWriter& out) const override {
+            IoTDevice::writeState(out);
+            out.writeVarint(reports);
+        }
+
+        bool readState(iot::CheckpointReader& in) override {
+            IoTDevice::readState(in);
+            reports = in.readVarint();
+            return in.ok();
+        }
+    };
+
+    // A device kind no checkpoint knows about
+    class Probe : public iot::IoTDevice {
+    public:
+        Probe() : IoTDevice("PROBE", "Probe", "Probe") {}
+        void sendData() override {}
+        void receiveData(const iot::Message&) override {}
+    };
+
+    /**
+     * @brief Battery sensors and LoRa sensors read every 10 s; the LED is switched on once
+     */
+    struct Scenario {
+        std::unique_ptr<iot::Replica> replica;
+        std::shared_ptr<iot::MeshNetwork> mesh;
+        std::shared_ptr<iot::IPSecManager> ipsec;
+        std::unique_ptr<iot::SimulationCheckpoint> checkpoint;
+
+        Scenario() : replica(std::make_unique<iot::Replica>(0, 11)) {
+            mesh = std::make_shared<iot::MeshNetwork>(10, replica->deviceManager->getIdTable());
+            ipsec = std::make_shared<iot::IPSecManager>();
+            replica->networkManager->setIPSecManager(ipsec);
+            checkpoint = std::make_unique<iot::SimulationCheckpoint>(replica->deviceManager, replica->networkManager,
+                                                                     *replica->engine);
+            checkpoint->setMeshNetwork(mesh);
+            checkpoint->registerDeviceKind<Gateway>("Gateway");
+        }
+
+        iot::EventCallback reading(const std::string& id) {
+            auto device = replica->deviceManager->getDevice(id);
+            if (auto* sensor = dynamic_cast<iot::Sensor*>(device.get())) {
+                return [sensor]() { sensor->sample(); };
+            }
+            return iot::EventCallback();
+        }
+
+        iot::EventCallback ledOn() {
+            auto led = std::dynamic_pointer_cast<iot::LED>(replica->deviceManager->getDevice("LED"));
+            return [led]() { led->setState(true); };
+        }
+
+        iot::EventHandle scheduleReading(const std::string& id) {
+            return replica->engine->scheduleRepeatingEvent(std::chrono::seconds(10), reading(id), "READ_" + id);
+        }
+
+        void build() {
+            auto& devices = *replica->deviceManager;
+            devices.registerDevice(std::make_shared<Gateway>("GATEWAY", "Gateway"));
+            mesh->addDevice("GATEWAY", true);
+            for (int i = 0; i < 200; ++i) {
+                std::string id = "BAT_" + std::to_string(i);
+                devices.registerDevice(std::make_shared<iot::BatteryTemperatureSensor>(id, "Battery " + id));
+                scheduleReading(id);
+            }
+            for (int i = 0; i < 50; ++i) {
+                std::string id = "LORA_" + std::to_string(i);
+                devices.registerDevice(std::make_shared<iot::LoRaTemperatureSensor>(id, id));
+                replica->networkManager->setDeviceProtocol(id, iot::NetworkManager::Protocol::LORA);
+                mesh->addDevice(id);
+                mesh->addNeighbor(i == 0 ? "GATEWAY" : "LORA_" + std::to_string(i - 1), id);
+                scheduleReading(id);
+            }
+            devices.registerDevice(std::make_shared<iot::LED>("LED", "Status LED"));
+            devices.registerDevice(std::make_shared<iot::Motor>("MOTOR", "Fan", 60));
+            replica->engine->scheduleEvent(std::chrono::minutes(30), ledOn(), "LED_ON");
+            ipsec->createSecurityAssociation("10.0.0.1", "10.0.0.2", "SPI_A");
+            ipsec->createSecurityAssociation("10.0.0.3", "10.0.0.4", "SPI_B");
+            replica->networkManager->setNetworkConditions(0.1, 5.0, 20.0);
+        }
+
+        iot::EventRebinder rebinder() {
+            return [this](const iot::CheckpointEvent& event) -> iot::EventCallback {
+                if (event.eventId == "LED_ON") return ledOn();
+                if (event.eventId.rfind("READ_", 0) == 0) return reading(event.eventId.substr(5));
+                return iot::EventCallback();
+            };
+        }
+
+        std::vector<double> batteryLevels() const {
+            std::vector<double> levels;
+            for (const auto& device : replica->deviceManager->getAllDevices()) {
+                if (auto* battery = dynamic_cast<iot::BatteryTemperatureSensor*>(device.get())) {
+                    levels.push_back(battery->getBatteryLevel());
+                } else if (auto* lora = dynamic_cast<iot::LoRaTemperatureSensor*>(device.get())) {
+                    levels.push_back(lora->getBatteryLevel());
+                }
+            }
+            return levels;
+        }
+
+        std::vector<double> readings() const {
+            std::vector<double> values;
+            for (const auto& device : replica->deviceManager->getAllDevices()) {
+                if (auto* sensor = dynamic_cast<iot::Sensor*>(device.get())) {
+                    values.push_back(sensor->getCurrentValue());
+                }
+            }
+            return values;
+        }
+
+        bool ledIsOn() const {
+            auto led = std::dynamic_pointer_cast<iot::LED>(replica->deviceManager->getDevice("LED"));
+            return led && led->getState();
+        }
+    };
+
+    std::vector<char> readFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string& path, const std::vector<char>& bytes) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), bytes.size());
+    }
+}
+
+int main() {
+    test_check::begin("Simulation Checkpoint Test");
+
+    const std::string path = "checkpoint_test.snap";
+    std::cout.setstate(std::ios::failbit);
+
+    // Run 20 minutes, checkpoint, then keep going as the reference
+    Scenario original;
+    original.build();
+    original.replica->deviceManager->registerDevice(std::make_shared<Probe>());
+    original.replica->engine->runFor(std::chrono::minutes(20));
+    original.replica->networkManager->deliverNow(iot::Message("LORA_3", "GATEWAY", "report"));
+    auto savedLevels = original.batteryLevels();
+    auto savedElapsed = original.replica->engine->getSimClock()->getElapsed();
+    bool saved = original.checkpoint->save(path);
+    auto pause = original.checkpoint->getLastCapturePause();
+    original.replica->engine->runFor(std::chrono::minutes(20));
+    auto finalLevels = original.batteryLevels();
+    auto finalReadings = original.readings();
+
+    // Restore into fresh components and run the same 20 minutes
+    Scenario restored;
+    bool loaded = restored.checkpoint->restore(path, restored.rebinder());
+    auto report = restored.checkpoint->getLastRestore();
+    auto restoredLevels = restored.batteryLevels();
+    auto restoredElapsed = restored.replica->engine->getSimClock()->getElapsed();
+    auto ids = restored.replica->deviceManager->getIdTable();
+    auto gateway = std::dynamic_pointer_cast<Gateway>(restored.replica->deviceManager->getDevice("GATEWAY"));
+    auto motor = std::dynamic_pointer_cast<iot::Motor>(restored.replica->deviceManager->getDevice("MOTOR"));
+    auto lora = restored.replica->deviceManager->getDevice("LORA_7");
+    bool ledBefore = restored.ledIsOn();
+    restored.replica->engine->runFor(std::chrono::minutes(20));
+    auto continuedLevels = restored.batteryLevels();
+    auto continuedReadings = restored.readings();
+    std::cout.clear();
+
+    // 1. Everything that was saved comes back
+    check(saved && loaded, "checkpoint is saved and restored");
+    check(report.devices == 253 && report.skippedDevices == 0 && original.checkpoint->getUnsavedDevices() == 1,
+          "devices of registered kinds are rebuilt, others reported");
+    check(ids->size() == original.replica->deviceManager->getIdTable()->size() &&
+          lora && lora->getHandle() == original.replica->deviceManager->getHandle("LORA_7") &&
+          lora->getDeviceName() == "LORA_7", "device handles and names match the original");
+    check(restoredLevels == savedLevels, "battery levels are restored exactly");
+    check(gateway && gateway->reports == 1 && motor && motor->getMaxSpeed() == 60,
+          "custom and constructor-configured device state is restored");
+    check(restored.replica->networkManager->getDeviceProtocol("LORA_7") == iot::NetworkManager::Protocol::LORA &&
+          restored.replica->networkManager->getStats().messagesReceived == 1, "protocols and network statistics are restored");
+    check(restored.mesh->getHopCount("LORA_9") == 10 && restored.mesh->getGateway() == "GATEWAY" &&
+          restored.mesh->getNeighbors("LORA_0").size() == 2, "mesh topology is restored without rerouting");
+    const auto* sa = restored.ipsec->getSecurityAssociation("SPI_B");
+    const auto* originalSa = original.ipsec->getSecurityAssociation("SPI_B");
+    check(sa && originalSa && sa->encryptionKey == originalSa->encryptionKey && sa->destinationIP == "10.0.0.4",
+          "IPsec security associations are restored");
+    check(restoredElapsed == savedElapsed && report.events == 251 && report.droppedEvents == 0,
+          "engine clock and pending events are restored");
+
+    // 2. The restored run continues exactly like the original
+    check(continuedLevels == finalLevels, "restored simulation continues identically");
+    check(continuedReadings == finalReadings && !finalReadings.empty(),
+          "sensor noise streams resume where they were saved");
+    check(!ledBefore && restored.ledIsOn() && original.ledIsOn(), "one-shot events fire at their saved time");
+
+    // 3. Damaged or foreign files are refused
+    auto image = readFile(path);
+    auto corrupt = image;
+    corrupt[corrupt.size() / 2] ^= 0x01;
+    writeFile("checkpoint_test_corrupt.snap", corrupt);
+    auto otherVersion = image;
+    otherVersion[8] = 99;
+    writeFile("checkpoint_test_version.snap", otherVersion);
+    writeFile("checkpoint_test_short.snap", std::vector<char>(image.begin(), image.begin() + 20));
+    std::cout.setstate(std::ios::failbit);
+    Scenario target;
+    bool corruptLoaded = target.checkpoint->restore("checkpoint_test_corrupt.snap", target.rebinder());
+    bool versionLoaded = target.checkpoint->restore("checkpoint_test_version.snap", target.rebinder());
+    bool truncatedLoaded = target.checkpoint->restore("checkpoint_test_short.snap", target.rebinder());
+    bool intoUsed = restored.checkpoint->restore(path, restored.rebinder());
+    std::cout.clear();
+    check(!corruptLoaded && !versionLoaded && !truncatedLoaded && target.replica->deviceManager->getDeviceCount() == 0,
+          "corrupt, truncated and other-version files are refused");
+    check(!intoUsed, "restore refuses a device manager that already has devices");
+
+    // 4. Periodic checkpoints are captured at quiescent points and written in the background
+    const std::string periodicPath = "checkpoint_test_periodic.snap";
+    std::remove(periodicPath.c_str());
+    std::cout.setstate(std::ios::failbit);
+    original.checkpoint->scheduleCheckpoints(std::chrono::minutes(5), periodicPath);
+    original.replica->engine->runFor(std::chrono::minutes(20));
+    bool periodicWritten = original.checkpoint->waitForWrite();
+    Scenario resumed;
+    bool resumedLoaded = resumed.checkpoint->restore(periodicPath, resumed.rebinder());
+    std::cout.clear();
+    auto resumedElapsed = resumed.replica->engine->getSimClock()->getElapsed();
+    check(periodicWritten && original.checkpoint->getCheckpointsWritten() >= 2 && resumedLoaded,
+          "periodic checkpoints are written and restorable");
+    check(resumedElapsed % std::chrono::minutes(5) == std::chrono::steady_clock::duration::zero() &&
+          resumed.checkpoint->getLastRestore().events == 250 && resumed.checkpoint->getLastRestore().droppedEvents == 0,
+          "a periodic checkpoint holds every timer and not its own");
+
+    // 5. State a restore could not rebuild makes capture refuse instead of dropping it
+    const std::string refusedPath = "checkpoint_test_refused.snap";
+    std::remove(refusedPath.c_str());
+    std::cerr.setstate(std::ios::failbit);
+    size_t sent = 0;
+    for (int i = 0; i < 10; ++i) {
+        sent += resumed.replica->sendMessage(iot::Message("LORA_3", "GATEWAY", "report")) ? 1 : 0;
+    }
+    bool deliverySaved = resumed.checkpoint->save(refusedPath);
+    std::cerr.clear();
+    check(sent > 0 && !deliverySaved && resumed.checkpoint->getRefusedCaptures() == 1 && readFile(refusedPath).empty(),
+          "a message delivery pending in the engine refuses the checkpoint");
+
+    std::cout.setstate(std::ios::failbit);
+    std::cerr.setstate(std::ios::failbit);
+    Scenario anonymous;
+    anonymous.build();
+    anonymous.replica->engine->scheduleEvent(std::chrono::seconds(1), []() {});
+    bool anonymousSaved = anonymous.checkpoint->save(refusedPath);
+    std::cerr.clear();
+    std::cout.clear();
+    check(!anonymousSaved && anonymous.checkpoint->getRefusedCaptures() == 1 && readFile(refusedPath).empty(),
+          "an event scheduled without an ID refuses the checkpoint");
+
+    std::cout << "\nCheckpoint size: " << image.size() << " bytes, capture pause: "
+              << std::chrono::duration<double, std::milli>(pause).count() << " ms, restore: "
+              << std::chrono::duration<double, std::milli>(report.loadTime).count() << " ms" << std::endl;
+
+    return test_check::finish("Simulation Checkpoint Test");
+}
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <sstream>
+#include "../include/core/DeviceManager.h"
+#include "../include/network/NetworkManager.h"
+#include "../include/simulation/SimulationEngine.h"
+#include "../include/devices/ConcreteSensors.h"
+
+/**
+ * @brief Ticks/second of SimulationEngine::runDeviceTick versus tick workers
+ *
+ * The fleet is 90% lightweight meters and 10% TemperatureSensors. Every
+ * meter updates its state each tick and reports to a sink every 30 ticks.
+ * Every sensor is sampled each tick.
+ *
+ * Usage: ./device_tick_benchmark [devices] [ticks] [grain] [max_workers]
+ */
+
+namespace {
+    class MeterDevice : public iot::IoTDevice {
+    private:
+        double reading = 0.0;
+        uint32_t ticks;
+
+    public:
+        MeterDevice(const std::string& id, uint32_t phase)
+            : IoTDevice(id, "METER", "Meter"), ticks(phase) {}
+
+        void update() override {
+            reading = reading * 0.9 + static_cast<double>(ticks % 7);
+            if (++ticks % 30 == 0) {
+                queueMessage(iot::Message(deviceId, "SINK", "42.0"));
+            }
+        }
+
+        void sendData() override {}
+        void receiveData(const iot::Message&) override {}
+    };
+
+    class SinkDevice : public iot::IoTDevice {
+    public:
+        explicit SinkDevice(const std::string& id) : IoTDevice(id, "SINK", "Benchmark Sink") {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message&) override {}
+    };
+}
+
+int main(int argc, char* argv[]) {
+    size_t deviceCount = 1000000;
+    size_t ticks = 20;
+    size_t grain = 1024;
+    size_t maxWorkers = std::max(4u, std::thread::hardware_concurrency());
+    if (argc > 1) deviceCount = std::stoul(argv[1]);
+    if (argc > 2) ticks = std::stoul(argv[2]);
+    if (argc > 3) grain = std::stoul(argv[3]);
+    if (argc > 4) maxWorkers = std::stoul(argv[4]);
+
+    std::ostringstream discard;
+    std::streambuf* original = std::cout.rdbuf(discard.rdbuf());
+
+    auto deviceManager = std::make_shared<iot::DeviceManager>();
+    deviceManager->registerDevice(std::make_shared<SinkDevice>("SINK"));
+    for (size_t i = 0; i < deviceCount; ++i) {
+        if (i % 10 == 0) {
+            deviceManager->registerDevice(std::make_shared<iot::TemperatureSensor>("TEMP_" + std::to_string(i), "Temp"));
+        } else {
+            deviceManager->registerDevice(std::make_shared<MeterDevice>("METER_" + std::to_string(i),
+                                                                        static_cast<uint32_t>(i % 30)));
+        }
+    }
+    auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+    networkManager->start();
+
+    std::vector<std::pair<size_t, double>> results;
+    for (size_t workers = 1; workers <= maxWorkers; workers *= 2) {
+        iot::SimulationEngine engine(deviceManager, networkManager);
+        engine.setTickWorkers(workers);
+        engine.setTickGrainSize(grain);
+        engine.runDeviceTick();  // warm-up: builds the cached device list
+        auto start = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < ticks; ++t) {
+            engine.runDeviceTick();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        results.push_back({workers, ticks / seconds});
+        discard.str("");
+    }
+
+    networkManager->stop();
+    std::cout.rdbuf(original);
+
+    std::cout << "\n=== DEVICE TICK BENCHMARK ===" << std::endl;
+    std::cout << "Devices: " << deviceCount << ", ticks: " << ticks << ", grain: " << grain << std::endl;
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::left << std::setw(12) << "Workers" << std::setw(16) << "Ticks/sec"
+              << std::setw(20) << "Device updates/sec" << "Speedup" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------" << std::endl;
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(12) << result.first << std::fixed << std::setprecision(2)
+                  << std::setw(16) << result.second << std::setprecision(0)
+                  << std::setw(20) << result.second * deviceCount << std::setprecision(2)
+                  << result.second / results.front().second << "x" << std::endl;
+    }
+    std::cout << "================================================================================" << std::endl;
+    return 0;
+}
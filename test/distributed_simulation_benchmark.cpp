@@ -0,0 +1,145 @@
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include "../include/simulation/DistributedSimulation.h"
+#include "../include/utils/CounterRng.h"
+
+/**
+ * @brief Speedup of DistributedSimulation versus the number of worker processes
+ *
+ * The scenario of partitioned_simulation_benchmark, spread over processes
+ * instead of threads: whole regions of regionSize devices are placed in
+ * each worker, every device reports every 100 ms with a little work and
+ * messages one device, 90% of them in its own region. Devices alternate
+ * between ZigBee (30 ms) and MQTT (5 ms), so the lookahead is 5 ms. The
+ * largest process count is also run over the TCP transport. Wall time
+ * includes forking the workers and building their partitions.
+ *
+ * Usage: ./distributed_simulation_benchmark [devices] [simulated_seconds] [region_size] [max_processes]
+ */
+
+namespace {
+    volatile uint64_t workSink = 0;
+
+    void simulateWork(uint64_t seed) {
+        uint64_t value = seed;
+        for (int i = 0; i < 200; ++i) value = iot::mixBits(value);
+        workSink = workSink + value;
+    }
+
+    class RegionDevice : public iot::IoTDevice {
+    public:
+        size_t received = 0;
+
+        explicit RegionDevice(const std::string& id) : IoTDevice(id, "REGION", "Region Device") {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message&) override {
+            simulateWork(received++);
+        }
+    };
+
+    struct Result {
+        size_t processes;
+        const char* transport;
+        bool succeeded;
+        double wallSeconds;
+        size_t events;
+        size_t windows;
+        size_t crossPartition;
+        double syncShare;
+    };
+
+    Result run(size_t processes, bool tcp, size_t deviceCount, size_t seconds, size_t regionSize) {
+        const size_t regions = (deviceCount + regionSize - 1) / regionSize;
+        iot::DistributedSimulation simulation(processes, [=](iot::DistributedPartition& partition) {
+            for (size_t i = 0; i < deviceCount; ++i) {
+                std::string id = "DEV_" + std::to_string(i);
+                if (!partition.addDevice(id, [&id]() { return std::make_shared<RegionDevice>(id); })) {
+                    continue;
+                }
+                partition.getNetworkManager()->setDeviceProtocol(id, i % 2 == 0 ? iot::NetworkManager::Protocol::ZIGBEE
+                                                                                : iot::NetworkManager::Protocol::MQTT);
+                partition.getEngine().scheduleRepeatingEvent(std::chrono::milliseconds(100),
+                    [&partition, id, i, counter = uint64_t(0), deviceCount, regionSize]() mutable {
+                        uint64_t draw = iot::mixBits((static_cast<uint64_t>(i) << 32) ^ counter++);
+                        simulateWork(draw);
+                        size_t target;
+                        if (draw % 10 != 0) {
+                            size_t regionStart = i / regionSize * regionSize;
+                            target = regionStart + (draw >> 8) % std::min(regionSize, deviceCount - regionStart);
+                        } else {
+                            target = (draw >> 8) % deviceCount;
+                        }
+                        partition.sendMessage(iot::Message(id, "DEV_" + std::to_string(target), "report"));
+                    }, "REPORT", 0, std::chrono::milliseconds(100));
+            }
+        }, "distributed_benchmark_logs");
+        simulation.setPlacement([regions, regionSize](const std::string& id, size_t partitions) {
+            return std::stoul(id.substr(4)) / regionSize * partitions / regions;
+        });
+        if (tcp) {
+            simulation.useTcp();
+        }
+
+        Result result{processes, tcp ? "TCP" : "shm", false, 0.0, 0, 0, 0, 0.0};
+        std::cout.setstate(std::ios::failbit);
+        result.succeeded = simulation.run(std::chrono::seconds(seconds));
+        std::cout.clear();
+
+        double busy = 0.0, sync = 0.0;
+        for (size_t p = 0; p < processes; ++p) {
+            const auto& stats = simulation.getPartitionStats(p);
+            result.events += stats.eventsExecuted;
+            result.crossPartition += stats.crossPartitionSent;
+            busy += std::chrono::duration<double>(stats.busyTime).count();
+            sync += std::chrono::duration<double>(stats.syncTime).count();
+        }
+        result.wallSeconds = std::chrono::duration<double>(simulation.getWallTime()).count();
+        result.windows = simulation.getWindowCount();
+        result.syncShare = busy + sync > 0.0 ? sync / (busy + sync) : 0.0;
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t deviceCount = 100000;
+    size_t seconds = 2;
+    size_t regionSize = 1000;
+    size_t maxProcesses = 8;
+    if (argc > 1) deviceCount = std::stoul(argv[1]);
+    if (argc > 2) seconds = std::stoul(argv[2]);
+    if (argc > 3) regionSize = std::stoul(argv[3]);
+    if (argc > 4) maxProcesses = std::stoul(argv[4]);
+
+    std::vector<Result> results;
+    for (size_t processes = 1; processes <= maxProcesses; processes *= 2) {
+        results.push_back(run(processes, false, deviceCount, seconds, regionSize));
+    }
+    results.push_back(run(results.back().processes, true, deviceCount, seconds, regionSize));
+
+    std::cout << "\n=== DISTRIBUTED SIMULATION BENCHMARK ===" << std::endl;
+    std::cout << "Devices: " << deviceCount << ", simulated: " << seconds << " s, region size: " << regionSize
+              << ", hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::left << std::setw(11) << "Processes" << std::setw(11) << "Transport" << std::setw(10)
+              << "Wall s" << std::setw(14) << "Events/s" << std::setw(10) << "Windows" << std::setw(13)
+              << "Cross msgs" << std::setw(8) << "Sync" << "Speedup" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------" << std::endl;
+    bool succeeded = true;
+    for (const auto& result : results) {
+        succeeded = succeeded && result.succeeded;
+        std::cout << std::left << std::setw(11) << result.processes << std::setw(11) << result.transport
+                  << std::fixed << std::setprecision(3) << std::setw(10) << result.wallSeconds
+                  << std::setprecision(0) << std::setw(14) << result.events / result.wallSeconds
+                  << std::setw(10) << result.windows << std::setw(13) << result.crossPartition
+                  << std::setw(8) << (std::to_string(static_cast<int>(result.syncShare * 100)) + "%")
+                  << std::setprecision(2) << results.front().wallSeconds / result.wallSeconds << "x"
+                  << (result.succeeded ? "" : "  FAILED") << std::endl;
+    }
+    std::cout << "================================================================================" << std::endl;
+    return succeeded ? 0 : 1;
+}
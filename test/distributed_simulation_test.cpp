@@ -0,0 +1,147 @@
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <unistd.h>
+#include "../include/devices/BatterySensors.h"
+#include "../include/simulation/DistributedSimulation.h"
+#include "../include/utils/CounterRng.h"
+#include "TestCheck.h"
+
+namespace {
+    constexpr size_t DEVICES = 400;
+    constexpr size_t SENSORS = 50;
+    const std::string LOGS = "distributed_test_logs";
+
+    /**
+     * @brief Device that checks each message's arrival time and folds it into the partition's metrics
+     */
+    class PingDevice : public iot::IoTDevice {
+    private:
+        iot::DistributedPartition* partition;
+
+    public:
+        PingDevice(const std::string& id, iot::DistributedPartition* owner)
+            : IoTDevice(id, "PING", "Ping " + id), partition(owner) {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message& message) override {
+            auto offset = std::chrono::duration_cast<std::chrono::microseconds>(
+                partition->getEngine().getCurrentTime() - partition->getOrigin()).count();
+            size_t sender = std::stoul(message.getSourceDeviceId().substr(5));
+            int64_t latency = sender % 2 == 0 ? 30000 : 5000;
+            // Summed over processes, so each term must be exact in a double
+            uint64_t fingerprint = iot::mixBits(static_cast<uint64_t>(offset) * 1000003 + sender * 1009 +
+                                                std::stoul(getDeviceId().substr(5)));
+            partition->recordMetric("received", 1);
+            partition->recordMetric("late", offset % 1000000 == latency ? 0 : 1);
+            partition->recordMetric("fingerprint", static_cast<double>(fingerprint & 0xFFFFF));
+        }
+    };
+
+    /**
+     * @brief Every device pings two others once per second; some sensors are read too
+     */
+    void buildRing(iot::DistributedPartition& partition) {
+        for (size_t i = 0; i < DEVICES; ++i) {
+            std::string id = "PING_" + std::to_string(i);
+            if (!partition.addDevice(id, [&]() { return std::make_shared<PingDevice>(id, &partition); })) {
+                continue;
+            }
+            partition.getNetworkManager()->setDeviceProtocol(id,
+                i % 2 == 0 ? iot::NetworkManager::Protocol::ZIGBEE : iot::NetworkManager::Protocol::MQTT);
+            std::string first = "PING_" + std::to_string((i + 1) % DEVICES);
+            std::string second = "PING_" + std::to_string((i + 7) % DEVICES);
+            partition.getEngine().scheduleRepeatingEvent(std::chrono::seconds(1), [&partition, id, first, second]() {
+                partition.sendMessage(iot::Message(id, first, "ping"));
+                partition.sendMessage(iot::Message(id, second, "ping"));
+            }, "PING_TIMER");
+        }
+
+        for (size_t i = 0; i < SENSORS; ++i) {
+            std::string id = "BAT_" + std::to_string(i);
+            if (!partition.addDevice(id, [&]() { return std::make_shared<iot::BatteryTemperatureSensor>(id, id); })) {
+                continue;
+            }
+            auto* sensor = static_cast<iot::Sensor*>(partition.getDeviceManager()->getDevice(id).get());
+            partition.getEngine().scheduleRepeatingEvent(std::chrono::seconds(1), [&partition, sensor]() {
+                partition.recordMetric("readings", std::llround(sensor->sample() * 1000.0));
+            }, "READ_" + id);
+        }
+    }
+
+    struct RunResult {
+        bool succeeded;
+        double received, late, fingerprint, readings;
+        size_t devices, busiest, crossSent, crossReceived, violations;
+        std::chrono::steady_clock::duration lookahead;
+    };
+
+    RunResult runRing(size_t processes, bool tcp) {
+        iot::DistributedSimulation simulation(processes, buildRing, LOGS);
+        if (tcp) {
+            simulation.useTcp();
+        }
+        RunResult result{};
+        result.succeeded = simulation.run(std::chrono::milliseconds(10500));
+        result.received = simulation.getMetric("received");
+        result.late = simulation.getMetric("late");
+        result.fingerprint = simulation.getMetric("fingerprint");
+        result.readings = simulation.getMetric("readings");
+        result.lookahead = simulation.getLookahead();
+        for (size_t p = 0; p < processes; ++p) {
+            const auto& stats = simulation.getPartitionStats(p);
+            result.devices += stats.devices;
+            result.busiest = std::max(result.busiest, stats.devices);
+            result.crossSent += stats.crossPartitionSent;
+            result.crossReceived += stats.crossPartitionReceived;
+            result.violations += stats.lookaheadViolations;
+        }
+        if (processes == 4 && !tcp) {
+            simulation.printStats();
+        }
+        return result;
+    }
+
+    bool sameOutcome(const RunResult& a, const RunResult& b) {
+        return a.succeeded && b.succeeded && a.received == b.received && a.fingerprint == b.fingerprint &&
+               a.readings == b.readings && a.late == b.late;
+    }
+}
+
+int main() {
+    test_check::begin("Distributed Simulation Test");
+
+    // 1. Worker processes over shared-memory rings reproduce the single-process run
+    auto single = runRing(1, false);
+    auto two = runRing(2, false);
+    auto four = runRing(4, false);
+    check(single.succeeded && single.received == DEVICES * 2 * 10, "every ping is delivered once");
+    check(single.late == 0 && four.late == 0 && four.violations == 0, "messages arrive exactly one protocol latency later");
+    check(sameOutcome(single, two) && sameOutcome(single, four), "two and four processes reproduce one process");
+    check(single.readings != 0, "sensor readings do not depend on the process count");
+    check(four.devices == DEVICES + SENSORS && four.busiest < (DEVICES + SENSORS) / 2,
+          "devices are spread over the workers");
+    check(single.crossSent == 0 && four.crossSent > 0 && four.crossSent == four.crossReceived,
+          "cross-partition messages travel between processes");
+    check(four.lookahead == std::chrono::milliseconds(5), "lookahead is the smallest protocol latency");
+
+    // 2. The TCP fallback gives the same run
+    auto overTcp = runRing(2, true);
+    check(sameOutcome(single, overTcp) && overTcp.crossSent == two.crossSent, "TCP transport reproduces the run");
+
+    // 3. A crashed worker fails the run instead of hanging it
+    auto started = std::chrono::steady_clock::now();
+    iot::DistributedSimulation crashing(3, [](iot::DistributedPartition& partition) {
+        buildRing(partition);
+        if (partition.getIndex() == 1) {
+            _exit(3);
+        }
+    }, LOGS);
+    bool crashed = !crashing.run(std::chrono::milliseconds(10500));
+    check(crashed && std::chrono::steady_clock::now() - started < std::chrono::seconds(10),
+          "a crashed worker is detected");
+
+    return test_check::finish("Distributed Simulation Test");
+}
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include "../include/simulation/SimulationEngine.h"
+#include "../include/simulation/TimingWheel.h"
+
+/**
+ * @brief Compares the engine's timing wheel with the old priority queue
+ *
+ * For each pending-event count N the queue is filled with N device timers
+ * (random delays up to one hour), then measured in the classic "hold"
+ * pattern: pop the earliest event and schedule a replacement a random
+ * delay later, as a periodic device timer does.
+ *
+ * Usage: ./event_queue_benchmark [max_pending] [hold_operations]
+ */
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using PriorityQueue = std::priority_queue<iot::SimulationEvent, std::vector<iot::SimulationEvent>,
+                                              std::greater<iot::SimulationEvent>>;
+
+    struct Result {
+        double fillNs;  // per insert
+        double holdNs;  // per pop + insert pair
+    };
+
+    iot::SimulationEvent makeEvent(Clock::time_point time, int* counter) {
+        iot::SimulationEvent event;
+        event.scheduledTime = time;
+        event.priority = 0;
+        event.eventId = "DEVICE_TIMER";
+        event.callback = [counter]() { (*counter)++; };
+        return event;
+    }
+
+    double nsPer(Clock::time_point start, size_t operations) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations;
+    }
+
+    template <typename Push, typename Pop>
+    Result run(size_t pending, size_t holds, Push push, Pop pop) {
+        std::mt19937_64 rng(7);
+        std::uniform_int_distribution<long long> delayMs(1, 3600 * 1000);
+        auto origin = Clock::now();
+        int fired = 0;
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < pending; ++i) {
+            push(makeEvent(origin + std::chrono::milliseconds(delayMs(rng)), &fired));
+        }
+        double fill = nsPer(start, pending);
+
+        start = Clock::now();
+        for (size_t i = 0; i < holds; ++i) {
+            iot::SimulationEvent event = pop();
+            event.callback();
+            event.scheduledTime += std::chrono::milliseconds(delayMs(rng));
+            push(std::move(event));
+        }
+        double hold = nsPer(start, holds);
+        return {fill, hold};
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t maxPending = 10000000;
+    size_t holds = 1000000;
+    if (argc > 1) maxPending = std::stoul(argv[1]);
+    if (argc > 2) holds = std::stoul(argv[2]);
+
+    std::cout << "\n=== EVENT QUEUE BENCHMARK ===" << std::endl;
+    std::cout << "Hold operations per size: " << holds << std::endl;
+    std::cout << std::left << std::setw(12) << "Pending"
+              << std::setw(18) << "Heap insert ns" << std::setw(18) << "Wheel insert ns"
+              << std::setw(18) << "Heap hold ns" << "Wheel hold ns" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------" << std::endl;
+
+    for (size_t pending = 10000; pending <= maxPending; pending *= 10) {
+        Result heap;
+        {
+            PriorityQueue queue;
+            heap = run(pending, holds,
+                [&queue](iot::SimulationEvent&& event) { queue.push(std::move(event)); },
+                [&queue]() {
+                    // The old engine copied the top; events are move-only now,
+                    // so this moves it out, which flatters the heap slightly
+                    iot::SimulationEvent event = std::move(const_cast<iot::SimulationEvent&>(queue.top()));
+                    queue.pop();
+                    return event;
+                });
+        }
+
+        Result wheel;
+        {
+            iot::TimingWheel<iot::SimulationEvent> queue;
+            wheel = run(pending, holds,
+                [&queue](iot::SimulationEvent&& event) { queue.push(std::move(event)); },
+                [&queue]() { return queue.pop(); });
+        }
+
+        std::cout << std::left << std::setw(12) << pending << std::fixed << std::setprecision(1)
+                  << std::setw(18) << heap.fillNs << std::setw(18) << wheel.fillNs
+                  << std::setw(18) << heap.holdNs << wheel.holdNs << std::endl;
+    }
+    std::cout << "================================================================================" << std::endl;
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <sstream>
+#include "../include/core/DeviceManager.h"
+#include "../include/core/Message.h"
+#include "../include/network/NetworkManager.h"
+#include "AllocationCounter.h"
+
+/**
+ * @brief Counts heap allocations per message on the send/deliver path
+ *
+ * Usage: ./message_allocation_benchmark [messages]
+ */
+
+namespace {
+    class SinkDevice : public iot::IoTDevice {
+    public:
+        explicit SinkDevice(const std::string& id)
+            : IoTDevice(id, "SINK", "Benchmark Sink " + id) {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message&) override {}
+    };
+
+    const std::string payloadText(256, 'x');  // well past the small-string buffer
+
+    double perMessage(size_t allocations, size_t messages) {
+        return static_cast<double>(allocations) / static_cast<double>(messages);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t messageCount = 200000;
+    if (argc > 1) messageCount = std::stoul(argv[1]);
+    const int destinations = 64;
+
+    std::ostringstream discard;
+    std::streambuf* original = std::cout.rdbuf();
+    std::cout.rdbuf(discard.rdbuf());
+
+    auto deviceManager = std::make_shared<iot::DeviceManager>();
+    std::vector<std::string> destinationIds;
+    for (int i = 0; i < destinations; ++i) {
+        destinationIds.push_back("SINK_" + std::to_string(i));
+        deviceManager->registerDevice(std::make_shared<SinkDevice>(destinationIds.back()));
+    }
+    auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+    networkManager->start();
+
+    // 1. Copying a message shares its payload buffer
+    iot::Message prototype("SOURCE", destinationIds[0], payloadText);
+    size_t before = allocation_counter::allocations();
+    {
+        std::vector<iot::Message> copies;
+        copies.reserve(messageCount);
+        before = allocation_counter::allocations();
+        for (size_t i = 0; i < messageCount; ++i) {
+            copies.push_back(prototype);
+        }
+    }
+    double copyAllocations = perMessage(allocation_counter::allocations() - before, messageCount);
+
+    // 2. Send + deliver, messages built up front
+    auto sharedPayload = std::make_shared<const std::string>(payloadText);
+    std::vector<iot::Message> batch;
+    batch.reserve(messageCount);
+    for (size_t i = 0; i < messageCount; ++i) {
+        batch.emplace_back("SOURCE", destinationIds[i % destinations], sharedPayload);
+    }
+
+    // Warm-up round so shard slabs and heaps reach their steady-state size
+    for (size_t i = 0; i < 10000; ++i) {
+        networkManager->sendMessage(iot::Message(batch[i % messageCount]));
+    }
+    while (networkManager->getStats().messagesReceived < 10000) std::this_thread::yield();
+    networkManager->resetStats();
+
+    before = allocation_counter::allocations();
+    for (auto& message : batch) {
+        networkManager->sendMessage(std::move(message));
+    }
+    while (networkManager->getStats().messagesReceived < messageCount) std::this_thread::yield();
+    double deliveryAllocations = perMessage(allocation_counter::allocations() - before, messageCount);
+
+    // 3. Broadcast shares one message across every device
+    iot::Message broadcast("SOURCE", "ALL", payloadText);
+    const size_t broadcasts = 1000;
+    before = allocation_counter::allocations();
+    for (size_t i = 0; i < broadcasts; ++i) {
+        deviceManager->broadcastMessage(broadcast);
+    }
+    double broadcastAllocations = perMessage(allocation_counter::allocations() - before, broadcasts * (destinations - 1));
+
+    networkManager->stop();
+    std::cout.rdbuf(original);
+
+    std::cout << "\n=== MESSAGE ALLOCATION BENCHMARK ===" << std::endl;
+    std::cout << "Messages: " << messageCount << ", payload bytes: " << payloadText.size() << std::endl;
+    std::cout << std::left << std::setw(28) << "Path" << "Allocations/message" << std::endl;
+    std::cout << "------------------------------------------------" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::left << std::setw(28) << "Message copy" << copyAllocations << std::endl;
+    std::cout << std::left << std::setw(28) << "Send + deliver" << deliveryAllocations << std::endl;
+    std::cout << std::left << std::setw(28) << "Broadcast (per recipient)" << broadcastAllocations << std::endl;
+    std::cout << "================================================" << std::endl;
+    return 0;
+}
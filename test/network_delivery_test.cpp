@@ -0,0 +1,238 @@
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <set>
+#include "../include/core/DeviceManager.h"
+#include "../include/core/Message.h"
+#include "../include/network/NetworkManager.h"
+#include "TestCheck.h"
+
+namespace {
+    /**
+     * @brief Device that records the payloads it receives
+     */
+    class RecordingDevice : public iot::IoTDevice {
+    private:
+        mutable std::mutex receivedMutex;
+        std::vector<std::string> received;
+
+    public:
+        explicit RecordingDevice(const std::string& id)
+            : IoTDevice(id, "RECORDER", "Recording Device " + id) {}
+
+        void sendData() override {}
+
+        void receiveData(const iot::Message& message) override {
+            std::lock_guard<std::mutex> lock(receivedMutex);
+            received.push_back(message.getPayload());
+        }
+
+        std::vector<std::string> getReceived() const {
+            std::lock_guard<std::mutex> lock(receivedMutex);
+            return received;
+        }
+
+        void clearReceived() {
+            std::lock_guard<std::mutex> lock(receivedMutex);
+            received.clear();
+        }
+    };
+
+    bool waitForReceived(const iot::NetworkManager& network, size_t expected) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (network.getStats().messagesReceived < expected) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+}
+
+int main() {
+    test_check::begin("Network Delivery Test");
+
+    const int deviceCount = 8;
+    const int messagesPerDevice = 200;
+
+    auto deviceManager = std::make_shared<iot::DeviceManager>();
+    std::vector<std::shared_ptr<RecordingDevice>> devices;
+    for (int i = 0; i < deviceCount; ++i) {
+        auto device = std::make_shared<RecordingDevice>("RECORDER_" + std::to_string(i));
+        deviceManager->registerDevice(device);
+        devices.push_back(device);
+    }
+
+    // Handles are issued at registration and resolve in both directions
+    iot::DeviceHandle firstHandle = devices[0]->getHandle();
+    check(firstHandle.isValid() && deviceManager->getHandle("RECORDER_0") == firstHandle,
+          "registration issues a device handle");
+    check(deviceManager->getDevice(firstHandle) == devices[0] &&
+          deviceManager->getDeviceId(firstHandle) == "RECORDER_0",
+          "handle resolves to the device and its ID");
+    check(!deviceManager->getHandle("MISSING_DEVICE").isValid(), "unknown ID has no handle");
+
+    auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+    networkManager->setDeliveryWorkers(4);
+    check(networkManager->getDeliveryWorkers() == 4, "delivery worker pool is configurable");
+    networkManager->start();
+
+    // Several producers interleave sends to every device
+    std::vector<std::thread> producers;
+    for (int p = 0; p < deviceCount; ++p) {
+        producers.emplace_back([&, p]() {
+            for (int seq = 0; seq < messagesPerDevice; ++seq) {
+                iot::Message message("PRODUCER_" + std::to_string(p), devices[p]->getDeviceId(),
+                                     std::to_string(seq));
+                networkManager->sendMessage(message);
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+
+    const size_t total = static_cast<size_t>(deviceCount) * messagesPerDevice;
+    check(waitForReceived(*networkManager, total), "all messages are delivered");
+
+    bool inOrder = true;
+    for (const auto& device : devices) {
+        auto received = device->getReceived();
+        if (received.size() != static_cast<size_t>(messagesPerDevice)) {
+            inOrder = false;
+            break;
+        }
+        for (int seq = 0; seq < messagesPerDevice; ++seq) {
+            if (received[seq] != std::to_string(seq)) {
+                inOrder = false;
+                break;
+            }
+        }
+    }
+    check(inOrder, "each device receives its messages in send order");
+
+    auto stats = networkManager->getStats();
+    check(stats.messagesSent == total, "sent counter aggregates across shards");
+    check(stats.errors == 0, "no delivery errors");
+
+    // Unknown destinations are counted as errors, not deliveries
+    networkManager->sendMessage(iot::Message("PRODUCER_0", "MISSING_DEVICE", "lost"));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (networkManager->getStats().errors == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    check(networkManager->getStats().errors == 1, "unknown destination is reported as an error");
+
+    // Simulated latency overlaps instead of serialising the delivery thread
+    const size_t delayedCount = 200;
+    networkManager->resetStats();
+    networkManager->setNetworkConditions(0.0, 50.0, 100.0);
+    auto delayedStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < delayedCount; ++i) {
+        networkManager->sendMessage(iot::Message("PRODUCER_0", devices[i % deviceCount]->getDeviceId(), "delayed"));
+    }
+    bool delayedDelivered = waitForReceived(*networkManager, delayedCount);
+    auto delayedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - delayedStart).count();
+    std::cout << "Delivered " << delayedCount << " messages with 50-100ms latency in " << delayedMs << " ms" << std::endl;
+    check(delayedDelivered, "delayed messages are delivered");
+    check(delayedMs >= 50 && delayedMs < 2000, "in-flight delays overlap rather than accumulate");
+
+    // A batch keeps per-device order and is split across the shards
+    networkManager->setNetworkConditions(0.0, 0.0, 0.0);
+    networkManager->resetStats();
+    for (const auto& device : devices) device->clearReceived();
+    std::vector<iot::Message> batch;
+    for (int seq = 0; seq < messagesPerDevice; ++seq) {
+        for (const auto& device : devices) {
+            batch.emplace_back("GATEWAY", device->getDeviceId(), std::to_string(seq));
+        }
+    }
+    check(networkManager->sendBatch(batch) == total, "batch is accepted in full");
+    bool hollowReadable = true;
+    for (const auto& sent : batch) {
+        hollowReadable = hollowReadable && sent.getPayload().empty() && !sent.toString().empty();
+    }
+    check(hollowReadable, "messages moved out of a batch stay safe to read");
+    check(waitForReceived(*networkManager, total), "batched messages are delivered");
+    bool batchInOrder = true;
+    for (const auto& device : devices) {
+        auto received = device->getReceived();
+        for (size_t seq = 0; seq < received.size(); ++seq) {
+            if (received[seq] != std::to_string(seq)) batchInOrder = false;
+        }
+        if (received.size() != static_cast<size_t>(messagesPerDevice)) batchInOrder = false;
+    }
+    check(batchInOrder, "batched messages keep per-device order");
+
+    // Broadcast reaches everyone but the source, sharing a single payload
+    networkManager->resetStats();
+    for (const auto& device : devices) device->clearReceived();
+    iot::Message announcement(devices[0]->getDeviceId(), "BROADCAST", "hello");
+    networkManager->broadcastMessage(announcement);
+    check(waitForReceived(*networkManager, deviceCount - 1), "broadcast is delivered asynchronously");
+    bool sourceSkipped = devices[0]->getReceived().empty();
+    bool othersReached = true;
+    for (int i = 1; i < deviceCount; ++i) {
+        othersReached = othersReached && devices[i]->getReceived().size() == 1;
+    }
+    check(sourceSkipped && othersReached, "broadcast skips the source and reaches every other device");
+
+    networkManager->stop();
+
+    // Sends queued before start() are kept even past the ingress ring's capacity
+    networkManager->resetStats();
+    devices[0]->clearReceived();
+    const size_t preStartCount = 20000;
+    size_t preStartAccepted = 0;
+    std::vector<iot::Message> preStartBatch;
+    for (size_t seq = 0; seq < preStartCount; ++seq) {
+        iot::Message message("GATEWAY", devices[0]->getDeviceId(), std::to_string(seq));
+        if (seq < preStartCount / 2) {
+            preStartAccepted += networkManager->sendMessage(std::move(message)) ? 1 : 0;
+        } else {
+            preStartBatch.push_back(std::move(message));
+        }
+    }
+    preStartAccepted += networkManager->sendBatch(preStartBatch);
+    check(preStartAccepted == preStartCount && networkManager->getInFlightMessages() == preStartCount,
+          "sends before start() are held, not dropped");
+    networkManager->start();
+    bool preStartDelivered = waitForReceived(*networkManager, preStartCount);
+    auto preStartReceived = devices[0]->getReceived();
+    bool preStartInOrder = preStartReceived.size() == preStartCount;
+    for (size_t seq = 0; preStartInOrder && seq < preStartReceived.size(); ++seq) {
+        preStartInOrder = preStartReceived[seq] == std::to_string(seq);
+    }
+    check(preStartDelivered && preStartInOrder && networkManager->getInFlightMessages() == 0,
+          "held sends are delivered in order once started");
+    networkManager->stop();
+
+    // Message IDs stay unique when many threads create messages at once
+    std::vector<std::vector<uint64_t>> ids(4);
+    std::vector<std::thread> creators;
+    for (size_t t = 0; t < ids.size(); ++t) {
+        creators.emplace_back([&ids, t]() {
+            for (int i = 0; i < 10000; ++i) {
+                ids[t].push_back(iot::Message("A", "B", "").getMessageId());
+            }
+        });
+    }
+    for (auto& creator : creators) creator.join();
+    std::set<uint64_t> uniqueIds;
+    for (const auto& threadIds : ids) uniqueIds.insert(threadIds.begin(), threadIds.end());
+    check(uniqueIds.size() == 40000, "message IDs are unique across threads");
+
+    // ...and when more threads have come and gone than there are thread slots
+    std::set<uint64_t> shortLivedIds;
+    const size_t shortLivedThreads = 66000;
+    for (size_t t = 0; t < shortLivedThreads; ++t) {
+        uint64_t id = 0;
+        std::thread([&id]() { id = iot::Message("A", "B", "").getMessageId(); }).join();
+        shortLivedIds.insert(id);
+    }
+    check(shortLivedIds.size() == shortLivedThreads, "thread slots are reused without reissuing IDs");
+
+    return test_check::finish("Network Delivery Test");
+}
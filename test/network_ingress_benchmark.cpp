@@ -0,0 +1,136 @@
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <sstream>
+#include <span>
+#include <algorithm>
+#include "../include/core/DeviceManager.h"
+#include "../include/core/Message.h"
+#include "../include/network/NetworkManager.h"
+
+/**
+ * @brief Measures NetworkManager::sendMessage throughput versus producer count
+ *
+ * Each producer count is run twice: one sendMessage call per message, then
+ * sendBatch with gateway-sized bursts of 10k messages.
+ *
+ * Usage: ./network_ingress_benchmark [messages_per_producer] [max_producers]
+ */
+
+namespace {
+    class SinkDevice : public iot::IoTDevice {
+    public:
+        explicit SinkDevice(const std::string& id)
+            : IoTDevice(id, "SINK", "Benchmark Sink " + id) {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message&) override {}
+    };
+
+    struct RoundResult {
+        double sendsPerSecond;      // rate at which sendMessage calls return
+        double deliveredPerSecond;  // rate until every message reached its device
+    };
+
+    const size_t burstSize = 10000;
+
+    RoundResult runRound(int producers, int messagesPerProducer, int destinations, bool batched) {
+        auto deviceManager = std::make_shared<iot::DeviceManager>();
+        std::vector<std::string> destinationIds;
+        for (int i = 0; i < destinations; ++i) {
+            destinationIds.push_back("SINK_" + std::to_string(i));
+            deviceManager->registerDevice(std::make_shared<SinkDevice>(destinationIds.back()));
+        }
+
+        auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+        networkManager->start();
+
+        // Messages are built up front so only the send path is timed
+        std::vector<std::vector<iot::Message>> batches(producers);
+        for (int p = 0; p < producers; ++p) {
+            batches[p].reserve(messagesPerProducer);
+            for (int i = 0; i < messagesPerProducer; ++i) {
+                batches[p].emplace_back("PRODUCER_" + std::to_string(p),
+                                        destinationIds[(p + i) % destinations], "42.0");
+            }
+        }
+
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p]() {
+                ready++;
+                while (!go) std::this_thread::yield();
+                if (!batched) {
+                    for (auto& message : batches[p]) {
+                        networkManager->sendMessage(std::move(message));
+                    }
+                    return;
+                }
+                for (size_t first = 0; first < batches[p].size(); first += burstSize) {
+                    size_t last = std::min(first + burstSize, batches[p].size());
+                    networkManager->sendBatch(std::span<iot::Message>(batches[p]).subspan(first, last - first));
+                }
+            });
+        }
+
+        while (ready < producers) std::this_thread::yield();
+        auto start = std::chrono::steady_clock::now();
+        go = true;
+        for (auto& thread : threads) thread.join();
+        auto sendElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const double total = static_cast<double>(producers) * messagesPerProducer;
+        while (networkManager->getStats().messagesReceived < static_cast<size_t>(total)) {
+            std::this_thread::yield();
+        }
+        auto deliverElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        networkManager->stop();
+        return {total / sendElapsed, total / deliverElapsed};
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int messagesPerProducer = 100000;
+    int maxProducers = 16;
+    if (argc > 1) messagesPerProducer = std::stoi(argv[1]);
+    if (argc > 2) maxProducers = std::stoi(argv[2]);
+
+    // Keep per-component log lines out of the results table
+    std::ostringstream discard;
+    std::streambuf* original = std::cout.rdbuf();
+
+    std::vector<std::pair<int, std::pair<RoundResult, RoundResult>>> results;
+    for (int producers = 1; producers <= maxProducers; producers *= 2) {
+        std::cout.rdbuf(discard.rdbuf());
+        RoundResult single = runRound(producers, messagesPerProducer, 64, false);
+        RoundResult batched = runRound(producers, messagesPerProducer, 64, true);
+        std::cout.rdbuf(original);
+        discard.str("");
+        results.push_back({producers, {single, batched}});
+    }
+
+    std::cout << "\n=== NETWORK INGRESS BENCHMARK ===" << std::endl;
+    std::cout << "Messages per producer: " << messagesPerProducer << std::endl;
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::left << std::setw(12) << "Producers" << std::setw(16) << "Sends/sec"
+              << std::setw(16) << "Delivered/sec" << std::setw(16) << "Batch sends/sec"
+              << "Batch delivered/sec" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------" << std::endl;
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(12) << result.first << std::fixed << std::setprecision(0)
+                  << std::setw(16) << result.second.first.sendsPerSecond
+                  << std::setw(16) << result.second.first.deliveredPerSecond
+                  << std::setw(16) << result.second.second.sendsPerSecond
+                  << result.second.second.deliveredPerSecond << std::endl;
+    }
+    std::cout << "================================================================================" << std::endl;
+    return 0;
+}
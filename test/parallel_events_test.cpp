@@ -0,0 +1,208 @@
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include "../include/core/DeviceManager.h"
+#include "../include/network/NetworkManager.h"
+#include "../include/simulation/SimulationEngine.h"
+#include "../include/utils/WorkStealingPool.h"
+#include "../include/devices/ConcreteSensors.h"
+#include "../include/devices/BatterySensors.h"
+#include "TestCheck.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Device that counts its updates and reports every other tick
+     */
+    class ReportingDevice : public iot::IoTDevice {
+    public:
+        size_t updates = 0;
+        std::string gateway;
+
+        ReportingDevice(const std::string& id, const std::string& gatewayId)
+            : IoTDevice(id, "REPORTER", "Reporting Device " + id), gateway(gatewayId) {}
+
+        void update() override {
+            IoTDevice::update();
+            if (++updates % 2 == 0) {
+                queueMessage(iot::Message(deviceId, gateway, std::to_string(updates)));
+            }
+        }
+
+        void sendData() override {}
+        void receiveData(const iot::Message&) override {}
+    };
+
+    class GatewayDevice : public iot::IoTDevice {
+    public:
+        std::atomic<size_t> received{0};
+
+        explicit GatewayDevice(const std::string& id) : IoTDevice(id, "GATEWAY", "Gateway " + id) {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message&) override { received++; }
+    };
+
+    /**
+     * @brief Per-device log of a fleet that ticks in lockstep and pings two
+     * neighbours, so each device receives two same-time pings scheduled by
+     * different parallel groups
+     */
+    std::vector<std::vector<int64_t>> runFleet(size_t workers, size_t devices) {
+        auto deviceManager = std::make_shared<iot::DeviceManager>();
+        auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+        iot::SimulationEngine engine(deviceManager, networkManager);
+        engine.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+        engine.setParallelEventWorkers(workers);
+
+        std::vector<std::vector<int64_t>> log(devices);
+        auto origin = engine.getCurrentTime();
+        auto stamp = [&engine, origin]() {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(engine.getCurrentTime() - origin).count();
+        };
+
+        std::ostringstream discard;
+        std::streambuf* original = std::cout.rdbuf(discard.rdbuf());
+        for (size_t d = 0; d < devices; ++d) {
+            engine.scheduleRepeatingEvent(std::chrono::seconds(1), [&, d]() {
+                log[d].push_back(stamp());
+                for (size_t hop : {size_t(1), size_t(2)}) {
+                    size_t neighbour = (d + hop) % devices;
+                    engine.scheduleEvent(std::chrono::milliseconds(250), [&, d, neighbour]() {
+                        log[neighbour].push_back(-static_cast<int64_t>(d));
+                    }, "PING", 0, neighbour);
+                }
+            }, "TICK", 0, std::chrono::milliseconds(0), d);
+        }
+        engine.runFor(std::chrono::seconds(20));
+        std::cout.rdbuf(original);
+        return log;
+    }
+}
+
+int main() {
+    test_check::begin("Parallel Events Test");
+
+    // 1. The pool visits every index exactly once, even with uneven chunks
+    iot::WorkStealingPool pool(4);
+    const size_t items = 100000;
+    std::vector<std::atomic<int>> visits(items);
+    pool.parallelFor(items, 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (i < items / 8) {
+                volatile double spin = 0;
+                for (int k = 0; k < 200; ++k) spin = spin + k;
+            }
+            visits[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    bool once = true;
+    for (const auto& visit : visits) once = once && visit.load() == 1;
+    check(pool.getThreadCount() == 4, "pool runs the requested number of threads");
+    check(once, "parallelFor covers every index exactly once");
+    std::cout << "Steals: " << pool.getStealCount() << std::endl;
+
+    auto deviceManager = std::make_shared<iot::DeviceManager>();
+    auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+    iot::SimulationEngine engine(deviceManager, networkManager);
+    engine.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+    engine.setParallelEventWorkers(4);
+    check(engine.getParallelEventWorkers() == 4, "engine uses the parallel event pool");
+
+    // 2. Same-key events keep queue order and the clock holds for the batch
+    std::vector<int> order;
+    std::atomic<size_t> wrongTime{0};
+    std::atomic<size_t> otherKeys{0};
+    Clock::time_point batchTime;
+    for (int i = 0; i < 100; ++i) {
+        engine.scheduleEvent(std::chrono::seconds(1), [&, i]() {
+            order.push_back(i);
+            if (engine.getCurrentTime() != batchTime) wrongTime++;
+        }, "SAME_KEY", 0, 7);
+        engine.scheduleEvent(std::chrono::seconds(1), [&]() {
+            otherKeys++;
+            if (engine.getCurrentTime() != batchTime) wrongTime++;
+        }, "OTHER_KEY", 0, 100 + i);
+    }
+    batchTime = engine.getCurrentTime() + std::chrono::seconds(1);
+    engine.runFor(std::chrono::seconds(2));
+    bool inOrder = order.size() == 100;
+    for (size_t i = 0; inOrder && i < order.size(); ++i) inOrder = order[i] == static_cast<int>(i);
+    check(inOrder && otherKeys == 100, "events sharing a key run in queue order");
+    check(wrongTime == 0, "clock does not advance while a batch runs");
+
+    // 3. An event without a key is a serial point between keyed runs
+    std::atomic<size_t> before{0};
+    std::atomic<size_t> after{0};
+    bool serialPoint = false;
+    for (int i = 0; i < 50; ++i) {
+        engine.scheduleEvent(std::chrono::seconds(1), [&]() { before++; }, "BEFORE", 0, i);
+    }
+    engine.scheduleEvent(std::chrono::seconds(1), [&]() { serialPoint = before == 50 && after == 0; }, "BARRIER");
+    for (int i = 0; i < 50; ++i) {
+        engine.scheduleEvent(std::chrono::seconds(1), [&]() { after++; }, "AFTER", 0, i);
+    }
+    engine.runFor(std::chrono::seconds(2));
+    check(serialPoint && after == 50, "unkeyed events split the batch in queue order");
+
+    // 4. Parallel runs are reproducible and match the serial event counts
+    auto serial = runFleet(1, 500);
+    auto parallelA = runFleet(4, 500);
+    auto parallelB = runFleet(4, 500);
+    bool sameCounts = serial.size() == parallelA.size();
+    for (size_t d = 0; sameCounts && d < serial.size(); ++d) sameCounts = serial[d].size() == parallelA[d].size();
+    check(parallelA == parallelB, "parallel runs produce identical per-device histories");
+    check(sameCounts && serial == parallelA, "parallel runs reproduce the serial history");
+
+    // 5. Device tick pipeline: update, sampling and outbox flush on the pool
+    {
+        std::ostringstream discard;
+        std::streambuf* original = std::cout.rdbuf(discard.rdbuf());
+        auto tickManager = std::make_shared<iot::DeviceManager>();
+        auto gateway = std::make_shared<GatewayDevice>("GATEWAY");
+        tickManager->registerDevice(gateway);
+        std::vector<std::shared_ptr<ReportingDevice>> reporters;
+        for (int i = 0; i < 2000; ++i) {
+            reporters.push_back(std::make_shared<ReportingDevice>("REPORTER_" + std::to_string(i), "GATEWAY"));
+            tickManager->registerDevice(reporters.back());
+        }
+        reporters[0]->setActive(false);
+        auto sensor = std::make_shared<iot::TemperatureSensor>("TICK_TEMP", "Tick Sensor");
+        tickManager->registerDevice(sensor);
+        auto batterySensor = std::make_shared<iot::BatteryTemperatureSensor>("TICK_BATTERY", "Tick Battery");
+        tickManager->registerDevice(batterySensor);
+        double batteryBefore = batterySensor->getBatteryLevel();
+
+        auto tickNetwork = std::make_shared<iot::NetworkManager>(tickManager);
+        tickNetwork->start();
+        iot::SimulationEngine ticker(tickManager, tickNetwork);
+        bool offByDefault = !ticker.isDeviceTickEnabled();
+        ticker.setTickWorkers(4);
+        ticker.setTickGrainSize(64);
+        size_t flushed = 0;
+        for (int tick = 0; tick < 10; ++tick) flushed += ticker.runDeviceTick();
+        auto deadline = Clock::now() + std::chrono::seconds(10);
+        while (gateway->received < flushed && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        tickNetwork->stop();
+        std::cout.rdbuf(original);
+
+        bool everyTick = true;
+        for (size_t i = 1; i < reporters.size(); ++i) everyTick = everyTick && reporters[i]->updates == 10;
+        check(everyTick && reporters[0]->updates == 0, "tick updates every active device once");
+        check(sensor->getCurrentValue() != 0.0, "tick samples sensors");
+        check(batterySensor->getBatteryLevel() == batteryBefore, "sampling charges no battery");
+        check(offByDefault && ticker.isDeviceTickEnabled(), "real-time ticking is opt-in, enabled by setTickWorkers");
+        check(flushed == 1999 * 5 && gateway->received == flushed, "queued messages are flushed to the network");
+        check(ticker.getDeviceTicks() == 10 && ticker.getDeviceTicksPerSecond() > 0.0, "tick rate is reported");
+    }
+
+    return test_check::finish("Parallel Events Test");
+}
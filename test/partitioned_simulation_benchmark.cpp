@@ -0,0 +1,135 @@
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <atomic>
+#include "../include/core/DeviceManager.h"
+#include "../include/network/NetworkManager.h"
+#include "../include/simulation/PartitionedSimulation.h"
+#include "../include/utils/CounterRng.h"
+
+/**
+ * @brief Speedup of PartitionedSimulation versus the number of logical processes
+ *
+ * Devices are grouped into regions of regionSize and whole regions are
+ * dealt to partitions. Every device reports every 100 ms. Each report
+ * does a little work and messages one device: 90% of reports stay in the
+ * sender's region, the rest go to a random region. Devices alternate
+ * between ZigBee (30 ms) and MQTT (5 ms), so the lookahead is 5 ms.
+ *
+ * Usage: ./partitioned_simulation_benchmark [devices] [simulated_seconds] [region_size] [max_partitions]
+ */
+
+namespace {
+    volatile uint64_t workSink = 0;
+
+    void simulateWork(uint64_t seed) {
+        uint64_t value = seed;
+        for (int i = 0; i < 200; ++i) value = iot::mixBits(value);
+        workSink = workSink + value;
+    }
+
+    class RegionDevice : public iot::IoTDevice {
+    public:
+        size_t received = 0;
+
+        explicit RegionDevice(const std::string& id) : IoTDevice(id, "REGION", "Region Device") {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message&) override {
+            simulateWork(received++);
+        }
+    };
+
+    struct Result {
+        size_t partitions;
+        double wallSeconds;
+        size_t events;
+        size_t windows;
+        size_t crossPartition;
+    };
+
+    Result run(size_t partitionCount, size_t deviceCount, size_t seconds, size_t regionSize) {
+        std::ostringstream discard;
+        std::streambuf* original = std::cout.rdbuf(discard.rdbuf());
+
+        auto deviceManager = std::make_shared<iot::DeviceManager>();
+        auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+        std::vector<std::shared_ptr<RegionDevice>> fleet;
+        std::vector<std::string> ids;
+        for (size_t i = 0; i < deviceCount; ++i) {
+            ids.push_back("DEV_" + std::to_string(i));
+            fleet.push_back(std::make_shared<RegionDevice>(ids.back()));
+            deviceManager->registerDevice(fleet.back());
+            networkManager->setDeviceProtocol(ids.back(), i % 2 == 0 ? iot::NetworkManager::Protocol::ZIGBEE
+                                                                     : iot::NetworkManager::Protocol::MQTT);
+        }
+
+        iot::PartitionedSimulation simulation(deviceManager, networkManager, partitionCount);
+        const size_t regions = (deviceCount + regionSize - 1) / regionSize;
+        for (size_t i = 0; i < deviceCount; ++i) {
+            simulation.assignPartition(fleet[i]->getHandle(), (i / regionSize) * partitionCount / regions);
+        }
+
+        for (size_t i = 0; i < deviceCount; ++i) {
+            auto& engine = simulation.engineFor(fleet[i]->getHandle());
+            engine.scheduleRepeatingEvent(std::chrono::milliseconds(100),
+                [&simulation, &ids, i, counter = uint64_t(0), deviceCount, regionSize]() mutable {
+                    uint64_t draw = iot::mixBits((static_cast<uint64_t>(i) << 32) ^ counter++);
+                    simulateWork(draw);
+                    size_t target;
+                    if (draw % 10 != 0) {
+                        size_t regionStart = i / regionSize * regionSize;
+                        target = regionStart + (draw >> 8) % std::min(regionSize, deviceCount - regionStart);
+                    } else {
+                        target = (draw >> 8) % deviceCount;
+                    }
+                    simulation.sendMessage(iot::Message(ids[i], ids[target], "report"));
+                }, "REPORT", 0, std::chrono::milliseconds(100));
+        }
+
+        size_t events = simulation.runFor(std::chrono::seconds(seconds));
+        std::cout.rdbuf(original);
+
+        size_t cross = 0;
+        for (size_t p = 0; p < partitionCount; ++p) cross += simulation.getPartitionStats(p).crossPartitionSent;
+        return Result{partitionCount, std::chrono::duration<double>(simulation.getWallTime()).count(), events,
+                      simulation.getWindowCount(), cross};
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t deviceCount = 100000;
+    size_t seconds = 2;
+    size_t regionSize = 1000;
+    size_t maxPartitions = 8;
+    if (argc > 1) deviceCount = std::stoul(argv[1]);
+    if (argc > 2) seconds = std::stoul(argv[2]);
+    if (argc > 3) regionSize = std::stoul(argv[3]);
+    if (argc > 4) maxPartitions = std::stoul(argv[4]);
+
+    std::vector<Result> results;
+    for (size_t partitions = 1; partitions <= maxPartitions; partitions *= 2) {
+        results.push_back(run(partitions, deviceCount, seconds, regionSize));
+    }
+
+    std::cout << "\n=== PARTITIONED SIMULATION BENCHMARK ===" << std::endl;
+    std::cout << "Devices: " << deviceCount << ", simulated: " << seconds << " s, region size: " << regionSize
+              << ", hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::left << std::setw(12) << "Partitions" << std::setw(12) << "Wall s" << std::setw(16)
+              << "Events/s" << std::setw(10) << "Windows" << std::setw(14) << "Cross msgs" << "Speedup" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------" << std::endl;
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(12) << result.partitions << std::fixed << std::setprecision(3)
+                  << std::setw(12) << result.wallSeconds << std::setprecision(0) << std::setw(16)
+                  << result.events / result.wallSeconds << std::setw(10) << result.windows << std::setw(14)
+                  << result.crossPartition << std::setprecision(2)
+                  << results.front().wallSeconds / result.wallSeconds << "x" << std::endl;
+    }
+    std::cout << "================================================================================" << std::endl;
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include "../include/core/DeviceManager.h"
+#include "../include/network/NetworkManager.h"
+#include "../include/network/MeshNetwork.h"
+#include "../include/simulation/PartitionedSimulation.h"
+#include "TestCheck.h"
+
+namespace {
+    /**
+     * @brief Device that logs (receive time, sender) for every message
+     */
+    class PingDevice : public iot::IoTDevice {
+    public:
+        iot::SimulationEngine* engine = nullptr;
+        std::chrono::steady_clock::time_point origin;
+        std::vector<std::pair<int64_t, std::string>> log;
+
+        explicit PingDevice(const std::string& id) : IoTDevice(id, "PING", "Ping " + id) {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message& message) override {
+            auto offset = std::chrono::duration_cast<std::chrono::microseconds>(engine->getCurrentTime() - origin);
+            log.emplace_back(offset.count(), message.getSourceDeviceId());
+        }
+    };
+
+    struct RingResult {
+        std::vector<std::vector<std::pair<int64_t, std::string>>> logs;
+        size_t events;
+        size_t crossPartition;
+        size_t windows;
+        size_t violations;
+        std::chrono::steady_clock::duration lookahead;
+        bool onTime;
+    };
+
+    /**
+     * @brief Every device pings two others once per second for ten seconds
+     */
+    RingResult runRing(size_t partitionCount, size_t devices) {
+        std::ostringstream discard;
+        std::streambuf* original = std::cout.rdbuf(discard.rdbuf());
+
+        auto deviceManager = std::make_shared<iot::DeviceManager>();
+        auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+        std::vector<std::shared_ptr<PingDevice>> fleet;
+        for (size_t i = 0; i < devices; ++i) {
+            fleet.push_back(std::make_shared<PingDevice>("PING_" + std::to_string(i)));
+            deviceManager->registerDevice(fleet.back());
+            networkManager->setDeviceProtocol(fleet.back()->getDeviceId(),
+                i % 2 == 0 ? iot::NetworkManager::Protocol::ZIGBEE : iot::NetworkManager::Protocol::MQTT);
+        }
+
+        iot::PartitionedSimulation simulation(deviceManager, networkManager, partitionCount);
+        for (size_t i = 0; i < devices; ++i) {
+            auto& device = *fleet[i];
+            device.engine = &simulation.engineFor(device.getHandle());
+            device.origin = device.engine->getCurrentTime();
+            std::string self = device.getDeviceId();
+            std::string first = fleet[(i + 1) % devices]->getDeviceId();
+            std::string second = fleet[(i + 7) % devices]->getDeviceId();
+            device.engine->scheduleRepeatingEvent(std::chrono::seconds(1), [&simulation, self, first, second]() {
+                simulation.sendMessage(iot::Message(self, first, "ping"));
+                simulation.sendMessage(iot::Message(self, second, "ping"));
+            }, "PING_TIMER");
+        }
+
+        RingResult result;
+        result.events = simulation.runFor(std::chrono::milliseconds(10500));
+        std::cout.rdbuf(original);
+
+        result.crossPartition = 0;
+        for (size_t p = 0; p < simulation.getPartitionCount(); ++p) {
+            result.crossPartition += simulation.getPartitionStats(p).crossPartitionSent;
+        }
+        result.windows = simulation.getWindowCount();
+        result.violations = simulation.getLookaheadViolations();
+        result.lookahead = simulation.getLookahead();
+
+        // Each ping leaves on a whole second and arrives after its sender's latency
+        result.onTime = true;
+        for (auto& device : fleet) {
+            for (const auto& entry : device->log) {
+                size_t sender = std::stoul(entry.second.substr(5));
+                int64_t latency = sender % 2 == 0 ? 30000 : 5000;
+                result.onTime = result.onTime && entry.first % 1000000 == latency;
+            }
+            std::sort(device->log.begin(), device->log.end());
+            result.logs.push_back(device->log);
+        }
+        if (partitionCount == 4) {
+            simulation.printStats();
+        }
+        return result;
+    }
+}
+
+int main() {
+    test_check::begin("Partitioned Simulation Test");
+
+    // 1. Partitioned runs deliver exactly what the single-partition run delivers
+    auto single = runRing(1, 400);
+    auto parallel = runRing(4, 400);
+    size_t received = 0;
+    for (const auto& log : parallel.logs) received += log.size();
+    check(received == 400 * 2 * 10, "every ping is delivered once");
+    check(single.logs == parallel.logs, "four partitions reproduce the single-partition run");
+    check(parallel.onTime && parallel.violations == 0, "messages arrive exactly one protocol latency later");
+    check(parallel.crossPartition > 0 && single.crossPartition == 0, "cross-partition traffic goes through the barrier");
+
+    // 2. Lookahead comes from the fastest protocol, and idle time is skipped
+    check(parallel.lookahead == std::chrono::milliseconds(5), "lookahead is the smallest protocol latency");
+    check(parallel.windows < 100, "windows jump over idle simulated time");
+    std::cout << "Windows: " << parallel.windows << ", events: " << parallel.events << std::endl;
+
+    // 3. Mesh regions are never split across partitions
+    {
+        std::ostringstream discard;
+        std::streambuf* original = std::cout.rdbuf(discard.rdbuf());
+        auto deviceManager = std::make_shared<iot::DeviceManager>();
+        auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+        iot::MeshNetwork mesh(10, deviceManager->getIdTable());
+        std::vector<std::vector<std::string>> regions = {
+            {"A_0", "A_1", "A_2", "A_3"}, {"B_0", "B_1", "B_2"}, {"C_0", "C_1"}};
+        for (const auto& region : regions) {
+            for (size_t i = 0; i < region.size(); ++i) {
+                deviceManager->registerDevice(std::make_shared<PingDevice>(region[i]));
+                mesh.addDevice(region[i], i == 0);
+                if (i > 0) mesh.addNeighbor(region[i - 1], region[i]);
+            }
+        }
+        iot::PartitionedSimulation simulation(deviceManager, networkManager, 2);
+        size_t placed = simulation.partitionByRegion(mesh);
+        std::cout.rdbuf(original);
+
+        auto partitionOf = [&](const std::string& id) {
+            return simulation.getPartition(deviceManager->getIdTable()->find(id));
+        };
+        bool whole = true;
+        for (const auto& region : regions) {
+            for (const auto& id : region) whole = whole && partitionOf(id) == partitionOf(region[0]);
+        }
+        check(placed == 3 && whole, "each mesh region stays in one partition");
+        check(partitionOf("A_0") != partitionOf("B_0") && partitionOf("B_0") == partitionOf("C_0"),
+              "regions are balanced across partitions");
+    }
+
+    return test_check::finish("Partitioned Simulation Test");
+}
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include "../include/core/DeviceManager.h"
+#include "../include/network/NetworkManager.h"
+#include "../include/simulation/SimulationEngine.h"
+#include "AllocationCounter.h"
+#include "TestCheck.h"
+
+int main() {
+    test_check::begin("Periodic Timer Test");
+
+    auto deviceManager = std::make_shared<iot::DeviceManager>();
+    auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+    iot::SimulationEngine engine(deviceManager, networkManager);
+    engine.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+
+    // 1. Each firing is exactly one interval after the previous one
+    std::vector<std::chrono::steady_clock::time_point> fires;
+    fires.reserve(16);
+    engine.scheduleRepeatingEvent(std::chrono::seconds(10), [&]() {
+        fires.push_back(engine.getCurrentTime());
+    }, "EXACT");
+    auto origin = engine.getCurrentTime();
+    engine.runFor(std::chrono::seconds(100));
+    bool exact = fires.size() == 10;
+    for (size_t i = 0; exact && i < fires.size(); ++i) {
+        exact = fires[i] - origin == std::chrono::seconds(10) * static_cast<int>(i + 1);
+    }
+    check(exact, "repeating event fires once per interval");
+
+    // 2. Jitter delays each firing within [nominal, nominal + jitter] without drift
+    iot::SimulationEngine jittered(deviceManager, networkManager);
+    jittered.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+    std::vector<std::chrono::steady_clock::time_point> jitterFires;
+    jitterFires.reserve(128);
+    jittered.scheduleRepeatingEvent(std::chrono::seconds(30), [&]() {
+        jitterFires.push_back(jittered.getCurrentTime());
+    }, "JITTER", 0, std::chrono::milliseconds(5000));
+    auto jitterOrigin = jittered.getCurrentTime();
+    jittered.runFor(std::chrono::seconds(30 * 100));
+    bool withinJitter = jitterFires.size() >= 99;
+    bool varied = false;
+    for (size_t i = 0; i < jitterFires.size(); ++i) {
+        auto offset = jitterFires[i] - jitterOrigin - std::chrono::seconds(30) * static_cast<int>(i + 1);
+        withinJitter = withinJitter && offset >= std::chrono::milliseconds(0) && offset <= std::chrono::milliseconds(5000);
+        varied = varied || offset > std::chrono::milliseconds(0);
+    }
+    check(withinJitter && varied, "jittered firings stay within the jitter window");
+
+    // 3. 100k devices reporting every 30 s: no allocations once running
+    const size_t deviceCount = 100000;
+    iot::SimulationEngine fleet(deviceManager, networkManager);
+    fleet.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+    std::vector<uint32_t> reports(deviceCount, 0);
+
+    std::ostringstream discard;
+    std::streambuf* original = std::cout.rdbuf(discard.rdbuf());
+    for (size_t i = 0; i < deviceCount; ++i) {
+        fleet.scheduleRepeatingEvent(std::chrono::seconds(30), [&reports, i]() { reports[i]++; },
+                                     "REPORT_" + std::to_string(i), 0, std::chrono::milliseconds(30000));
+    }
+    std::cout.rdbuf(original);
+
+    fleet.runFor(std::chrono::minutes(2));  // warm up the wheel's node and heap storage
+    size_t allocationsBefore = allocation_counter::allocations();
+    size_t firings = fleet.runFor(std::chrono::minutes(10));
+    size_t allocations = allocation_counter::allocations() - allocationsBefore;
+
+    std::cout << "Firings: " << firings << ", allocations: " << allocations << std::endl;
+    check(firings >= deviceCount * 19, "every device keeps reporting");
+    check(allocations == 0, "steady-state firings do not allocate");
+
+    // 4. Cohort timers: 1M devices on three intervals share a few thousand entries
+    const uint32_t cohortSize = 1000000;
+    const std::chrono::milliseconds intervals[] = {
+        std::chrono::seconds(30), std::chrono::seconds(60), std::chrono::seconds(300)};
+    iot::SimulationEngine cohorts(deviceManager, networkManager);
+    cohorts.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+    std::vector<uint8_t> hits(cohortSize, 0);
+    size_t batches = 0;
+    size_t entries = 0;
+    for (uint32_t group = 0; group < 3; ++group) {
+        std::vector<iot::DeviceHandle> members;
+        for (uint32_t i = group; i < cohortSize; i += 3) members.emplace_back(i);
+        entries += cohorts.scheduleCohortTimer(intervals[group], members,
+            [&](const iot::DeviceHandle* handles, size_t count) {
+                batches++;
+                for (size_t j = 0; j < count; ++j) hits[handles[j].index()]++;
+            }).size();
+    }
+    check(entries <= 3900, "cohort timers need one entry per phase bucket, not per device");
+    cohorts.runFor(std::chrono::seconds(300));
+    bool everyPeriod = true;
+    for (uint32_t i = 0; i < cohortSize; ++i) {
+        everyPeriod = everyPeriod && hits[i] == 300 / (intervals[i % 3].count() / 1000);
+    }
+    check(everyPeriod, "every cohort member fires once per interval");
+    std::cout << "Cohort entries: " << entries << ", batch callbacks: " << batches << std::endl;
+
+    // 5. Phases are spread across the interval and reproducible
+    auto firstFirings = [&](iot::SimulationEngine& sim) {
+        std::vector<iot::DeviceHandle> members;
+        for (uint32_t i = 0; i < 1000; ++i) members.emplace_back(i);
+        std::vector<std::chrono::steady_clock::duration> offsets(members.size());
+        auto start = sim.getCurrentTime();
+        sim.scheduleCohortTimer(std::chrono::seconds(30), members,
+            [&](const iot::DeviceHandle* handles, size_t count) {
+                for (size_t j = 0; j < count; ++j) offsets[handles[j].index()] = sim.getCurrentTime() - start;
+            }, "PHASE", 0, std::chrono::seconds(1));
+        sim.runFor(std::chrono::seconds(30));
+        return offsets;
+    };
+    iot::SimulationEngine phaseA(deviceManager, networkManager);
+    iot::SimulationEngine phaseB(deviceManager, networkManager);
+    phaseA.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+    phaseB.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+    auto offsetsA = firstFirings(phaseA);
+    auto offsetsB = firstFirings(phaseB);
+    std::vector<bool> bucketUsed(31, false);
+    for (auto offset : offsetsA) {
+        bucketUsed[std::chrono::duration_cast<std::chrono::seconds>(offset).count() % 31] = true;
+    }
+    check(offsetsA == offsetsB, "cohort phase assignment is deterministic");
+    check(std::count(bucketUsed.begin(), bucketUsed.end(), true) == 30, "cohort phases cover every bucket");
+
+    // 6. A cohort's handles stop it like any other timer
+    iot::SimulationEngine cancelled(deviceManager, networkManager);
+    cancelled.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+    std::vector<iot::DeviceHandle> members;
+    for (uint32_t i = 0; i < 1000; ++i) members.emplace_back(i);
+    size_t cancelledFirings = 0;
+    auto cohortHandles = cancelled.scheduleCohortTimer(std::chrono::seconds(30), members,
+        [&](const iot::DeviceHandle*, size_t count) { cancelledFirings += count; });
+    cancelled.runFor(std::chrono::seconds(30));
+    size_t firstPeriod = cancelledFirings;
+    bool allCancelled = !cohortHandles.empty();
+    for (auto& handle : cohortHandles) allCancelled = handle.cancel() && allCancelled;
+    cancelled.runFor(std::chrono::seconds(60));
+    check(firstPeriod == members.size() && allCancelled && cancelledFirings == firstPeriod,
+          "cancelling a cohort's handles stops every bucket");
+
+    return test_check::finish("Periodic Timer Test");
+}
@@ -0,0 +1,171 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <thread>
+#include "../include/devices/BatterySensors.h"
+#include "../include/devices/ConcreteActuators.h"
+#include "../include/security/IPSecManager.h"
+#include "../include/simulation/ReplicaRunner.h"
+#include "../include/utils/CounterRng.h"
+#include "TestCheck.h"
+
+namespace {
+    constexpr size_t SENSORS = 2000;
+    constexpr int ROUNDS = 20;
+
+    /**
+     * @brief A fleet of battery sensors in a replica (virtual time, clock at midnight)
+     */
+    std::unique_ptr<iot::Replica> buildFleet(uint64_t seed) {
+        auto replica = std::make_unique<iot::Replica>(0, seed);
+        for (size_t i = 0; i < SENSORS; ++i) {
+            std::string id = "BAT_" + std::to_string(i);
+            replica->deviceManager->registerDevice(std::make_shared<iot::BatteryTemperatureSensor>(id, id));
+        }
+        return replica;
+    }
+
+    std::vector<iot::Sensor*> sensorsOf(const iot::Replica& replica) {
+        std::vector<iot::Sensor*> sensors;
+        for (const auto& device : replica.deviceManager->getAllDevices()) {
+            sensors.push_back(static_cast<iot::Sensor*>(device.get()));
+        }
+        return sensors;
+    }
+
+    /**
+     * @brief Every reading of every round, in device order
+     */
+    std::vector<double> sampleSerially(const iot::Replica& replica) {
+        auto sensors = sensorsOf(replica);
+        std::vector<double> readings(sensors.size() * ROUNDS);
+        for (int round = 0; round < ROUNDS; ++round) {
+            for (size_t i = 0; i < sensors.size(); ++i) {
+                readings[round * sensors.size() + i] = sensors[i]->sample();
+            }
+        }
+        return readings;
+    }
+
+    /**
+     * @brief Same readings, with devices striped over threads and visited backwards
+     */
+    std::vector<double> sampleInParallel(const iot::Replica& replica, size_t threadCount) {
+        auto sensors = sensorsOf(replica);
+        std::vector<double> readings(sensors.size() * ROUNDS);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&sensors, &readings, t, threadCount]() {
+                for (int round = 0; round < ROUNDS; ++round) {
+                    for (size_t i = sensors.size(); i-- > 0;) {
+                        if (i % threadCount == t) {
+                            readings[round * sensors.size() + i] = sensors[i]->sample();
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return readings;
+    }
+
+    /**
+     * @brief Which of each source's messages survive a lossy link
+     * @param interleaved Send the sources' messages alternately from one thread each
+     */
+    std::vector<std::vector<bool>> linkOutcomes(uint64_t seed, bool interleaved) {
+        iot::Replica replica(0, seed);
+        const size_t sources = 4, messages = 500;
+        for (size_t s = 0; s < sources; ++s) {
+            std::string id = "SRC_" + std::to_string(s);
+            replica.deviceManager->registerDevice(std::make_shared<iot::LED>(id, id));
+        }
+        replica.networkManager->setNetworkConditions(0.3);
+
+        std::vector<std::vector<bool>> delivered(sources, std::vector<bool>(messages));
+        auto send = [&replica, &delivered](size_t source, size_t index) {
+            iot::Message message("SRC_" + std::to_string(source), "SRC_0", "x");
+            delivered[source][index] = replica.networkManager->admitMessage(message);
+        };
+        if (!interleaved) {
+            for (size_t s = 0; s < sources; ++s) {
+                for (size_t m = 0; m < messages; ++m) send(s, m);
+            }
+        } else {
+            std::vector<std::thread> threads;
+            for (size_t s = sources; s-- > 0;) {
+                threads.emplace_back([&send, s]() {
+                    for (size_t m = 0; m < messages; ++m) send(s, m);
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+        return delivered;
+    }
+}
+
+int main() {
+    test_check::begin("Counter-Based Random Streams Test");
+
+    // 1. Philox matches the published known-answer vectors
+    auto zero = iot::philox2x64(0, 0, 0);
+    auto ones = iot::philox2x64(~0ULL, ~0ULL, ~0ULL);
+    check(zero.first == 0xca00a0459843d731ULL && zero.second == 0x66c24222c9a845b5ULL &&
+          ones.first == 0x65b021d60cd8310fULL && ones.second == 0x4d02f3222f86df20ULL,
+          "Philox2x64-10 known-answer vectors");
+    check(sizeof(iot::RandomStream) == 16, "a stream is 16 bytes of state");
+
+    iot::RandomStream stream(iot::streamKey(1, iot::StreamPurpose::SENSOR_NOISE, 7));
+    std::vector<double> draws;
+    for (int i = 0; i < 1000; ++i) draws.push_back(stream.uniform(-1.0, 1.0));
+    iot::RandomStream repositioned(stream.getKey(), 500);
+    bool inRange = true;
+    for (double draw : draws) inRange = inRange && draw >= -1.0 && draw < 1.0;
+    check(inRange && repositioned.uniform(-1.0, 1.0) == draws[500],
+          "draws stay in range and a stream can be positioned by its counter");
+
+    // 2. One seed fixes every device's readings, whatever the thread count
+    std::cout.setstate(std::ios::failbit);
+    auto serialFleet = buildFleet(42);
+    auto parallelFleet = buildFleet(42);
+    auto otherFleet = buildFleet(43);
+    auto serial = sampleSerially(*serialFleet);
+    auto parallel = sampleInParallel(*parallelFleet, 4);
+    auto other = sampleSerially(*otherFleet);
+    std::cout.clear();
+    check(serial == parallel, "parallel sampling is bit-identical to serial sampling");
+    check(serial != other, "a different seed gives different readings");
+
+    auto sensors = sensorsOf(*serialFleet);
+    check(sensors[0]->getCurrentValue() != sensors[1]->getCurrentValue(),
+          "devices draw from independent streams");
+
+    // 3. Packet loss follows the sender's stream, not the global send order
+    std::cout.setstate(std::ios::failbit);
+    auto inOrder = linkOutcomes(7, false);
+    auto concurrent = linkOutcomes(7, true);
+    std::cout.clear();
+    size_t lost = 0;
+    for (const auto& source : inOrder) {
+        for (bool delivered : source) lost += delivered ? 0 : 1;
+    }
+    check(inOrder == concurrent, "losses are identical however senders interleave");
+    check(lost > 400 && lost < 800, "loss rate is close to the configured 30%");
+
+    // 4. A generated SPI is the first draw of the seed's IPsec stream
+    iot::RandomStream ipsecStream(iot::streamKey(5, iot::StreamPurpose::IPSEC_KEYS, 0));
+    std::string expectedSpi = "SPI" + std::to_string(10000000 + ipsecStream.below(90000000));
+    std::cout.setstate(std::ios::failbit);
+    iot::IPSecManager ipsec;
+    ipsec.setRandomSeed(5);
+    ipsec.createSecurityAssociation("10.0.0.1", "10.0.0.2");
+    std::cout.clear();
+    check(ipsec.getSecurityAssociation(expectedSpi) != nullptr, "IPsec SPIs are reproducible from the seed");
+
+    return test_check::finish("Random Streams Test");
+}
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <numeric>
+#include <string>
+#include <thread>
+#include "../include/simulation/SimulationEngine.h"
+#include "TestCheck.h"
+
+namespace {
+    constexpr std::chrono::milliseconds STEP(10);
+
+    void spin(std::chrono::milliseconds duration) {
+        auto until = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+
+    struct PacedRun {
+        iot::SimulationEngine::PacingStats stats;
+        size_t deadlines;  // steps the wall time allowed for
+    };
+
+    /**
+     * @brief Run a 10 ms real-time loop whose steps each carry stepWork, with one long stall at 200 ms
+     */
+    PacedRun runPaced(iot::SimulationEngine::OverrunPolicy policy, std::chrono::milliseconds stepWork,
+                      std::chrono::milliseconds stall, bool print = false) {
+        std::cout.setstate(std::ios::failbit);
+        iot::SimulationEngine engine(nullptr, nullptr);
+        engine.setTimeStep(STEP);
+        engine.setOverrunPolicy(policy);
+        auto started = std::chrono::steady_clock::now();
+        engine.start();
+        if (stepWork.count() > 0) {
+            engine.scheduleRepeatingEvent(STEP, [stepWork]() { spin(stepWork); }, "WORK");
+        }
+        if (stall.count() > 0) {
+            engine.scheduleEvent(std::chrono::milliseconds(200), [stall]() { spin(stall); }, "STALL");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+        engine.stop();
+        auto elapsed = std::chrono::steady_clock::now() - started;
+        std::cout.clear();
+        if (print) {
+            engine.printStats();
+        }
+        return PacedRun{engine.getPacingStats(), static_cast<size_t>(elapsed / STEP)};
+    }
+
+    /**
+     * @brief Deadlines the loop has accounted for: steps run, steps shed, and the backlog still owed
+     *
+     * With absolute deadlines this tracks the wall time even when the
+     * thread is starved (the shortfall shows up as lag), while work + sleep
+     * pacing would fall behind with no lag to show for it.
+     */
+    size_t coveredDeadlines(const iot::SimulationEngine::PacingStats& stats) {
+        return stats.steps + stats.stepsShed + static_cast<size_t>(stats.currentLag / STEP);
+    }
+
+    /**
+     * @brief Generous bound: 80% of the wall-time deadlines, one grid step of slack for start-up and stop
+     *
+     * Work + sleep pacing with 4 ms of work covers about 70%.
+     */
+    bool keepsPace(const PacedRun& run) {
+        return (coveredDeadlines(run.stats) + 1) * 10 >= run.deadlines * 8;
+    }
+
+    size_t jitterSamples(const iot::SimulationEngine::PacingStats& stats) {
+        return std::accumulate(stats.jitterHistogram.begin(), stats.jitterHistogram.end(), size_t(0));
+    }
+}
+
+int main() {
+    test_check::begin("Real-Time Pacing Test");
+
+    using Policy = iot::SimulationEngine::OverrunPolicy;
+
+    // 1. Work inside a step does not stretch the period
+    auto steady = runPaced(Policy::CATCH_UP, std::chrono::milliseconds(4), std::chrono::milliseconds(0), true);
+    std::cout << "Steps: " << steady.stats.steps << " of " << steady.deadlines << " deadlines" << std::endl;
+    check(keepsPace(steady), "steps follow absolute deadlines, not work + sleep");
+    check(jitterSamples(steady.stats) + steady.stats.deadlineMisses == steady.stats.steps,
+          "every step either sleeps to its deadline or is counted as a miss");
+
+    // 2. After a stall, CATCH_UP runs the missed steps back to back
+    auto catchUp = runPaced(Policy::CATCH_UP, std::chrono::milliseconds(0), std::chrono::milliseconds(55));
+    check(catchUp.stats.deadlineMisses >= 1 && catchUp.stats.maxLag >= std::chrono::milliseconds(40),
+          "a stall is reported as missed deadlines and lag");
+    check(catchUp.stats.stepsShed == 0 && keepsPace(catchUp), "catch-up keeps every step");
+    check(catchUp.stats.currentLag < catchUp.stats.maxLag, "the backlog is worked off after the stall");
+
+    // 3. SHED_LOAD drops the missed steps instead
+    auto shed = runPaced(Policy::SHED_LOAD, std::chrono::milliseconds(0), std::chrono::milliseconds(55));
+    std::cout << "Shed: " << shed.stats.stepsShed << ", steps: " << shed.stats.steps << " of "
+              << shed.deadlines << " deadlines" << std::endl;
+    check(shed.stats.stepsShed >= 4 && shed.stats.steps + 3 <= shed.deadlines,
+          "shedding skips the steps missed during the stall");
+    check(keepsPace(shed), "run and shed steps together cover the wall time");
+
+    return test_check::finish("Real-Time Pacing Test");
+}
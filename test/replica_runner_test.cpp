@@ -0,0 +1,135 @@
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cmath>
+#include "../include/devices/BatterySensors.h"
+#include "../include/devices/ProtocolSensors.h"
+#include "../include/simulation/ReplicaRunner.h"
+#include "TestCheck.h"
+
+namespace {
+    /**
+     * @brief Shared read-only scenario: battery sensors report to a gateway over a lossy network
+     */
+    struct Scenario {
+        size_t sensors = 20;
+        double packetLoss = 0.2;
+        std::chrono::seconds reportInterval{10};
+        std::chrono::seconds pollInterval{60};
+    };
+
+    class Gateway : public iot::IoTDevice {
+    public:
+        size_t reports = 0;
+        double total = 0.0;
+
+        Gateway() : IoTDevice("GATEWAY", "GATEWAY", "Gateway") {}
+
+        void sendData() override {}
+        void receiveData(const iot::Message& message) override {
+            reports++;
+            total += std::stod(message.getPayload());
+        }
+    };
+
+    void buildScenario(const Scenario& scenario, iot::Replica& replica) {
+        replica.networkManager->setNetworkConditions(scenario.packetLoss);
+        auto gateway = std::make_shared<Gateway>();
+        replica.deviceManager->registerDevice(gateway);
+
+        std::vector<std::string> ids;
+        for (size_t i = 0; i < scenario.sensors; ++i) {
+            std::string id = "SENSOR_" + std::to_string(i);
+            std::shared_ptr<iot::Sensor> sensor;
+            if (i % 2 == 0) {
+                sensor = std::make_shared<iot::BatteryTemperatureSensor>(id, "Battery " + id);
+            } else {
+                sensor = std::make_shared<iot::LoRaTemperatureSensor>(id, "LoRa " + id);
+                replica.networkManager->setDeviceProtocol(id, iot::NetworkManager::Protocol::LORA);
+            }
+            replica.deviceManager->registerDevice(sensor);
+            ids.push_back(id);
+
+            replica.engine->scheduleRepeatingEvent(scenario.reportInterval, [&replica, sensor, id]() {
+                double value = sensor->sample();
+                sensor->sendData();
+                replica.sendMessage(iot::Message(id, "GATEWAY", std::to_string(value)));
+            }, "REPORT_" + id);
+        }
+
+        // Lost polls leave some sensors with more battery than others
+        replica.engine->scheduleRepeatingEvent(scenario.pollInterval, [&replica, ids]() {
+            for (const auto& id : ids) {
+                replica.sendMessage(iot::Message("GATEWAY", id, "poll"));
+            }
+        }, "POLL");
+
+        // Scenario-specific metric, read once the run is over
+        replica.engine->scheduleEvent(std::chrono::hours(1) - std::chrono::milliseconds(1), [&replica, gateway]() {
+            replica.recordMetric("gateway.mean_reading", gateway->total / std::max<size_t>(1, gateway->reports));
+        }, "SUMMARY");
+    }
+
+    std::vector<std::map<std::string, double>> runReplicas(const Scenario& scenario, uint64_t seed,
+                                                           size_t replicas, size_t threads,
+                                                           std::map<std::string, iot::ReplicaRunner::MetricSummary>* summary = nullptr) {
+        // Replicas print from several threads, so silence cout rather than redirect it
+        std::cout.setstate(std::ios::failbit);
+        iot::ReplicaRunner runner([&scenario](iot::Replica& replica) { buildScenario(scenario, replica); }, replicas);
+        runner.setBaseSeed(seed);
+        runner.setThreadCount(threads);
+        runner.run(std::chrono::hours(1));
+        std::cout.clear();
+
+        if (summary) {
+            *summary = runner.summarize();
+            runner.printSummary();
+        }
+        return runner.getResults();
+    }
+}
+
+int main() {
+    test_check::begin("Replica Runner Test");
+
+    const Scenario scenario;
+    const size_t replicas = 16;
+
+    // 1. A seed fully determines the results, whatever the thread count
+    std::map<std::string, iot::ReplicaRunner::MetricSummary> summary;
+    auto parallel = runReplicas(scenario, 42, replicas, 4, &summary);
+    auto serial = runReplicas(scenario, 42, replicas, 1);
+    auto reseeded = runReplicas(scenario, 43, replicas, 4);
+    check(parallel.size() == replicas && parallel == serial, "same seed reproduces every replica");
+    check(parallel != reseeded, "a different seed gives different results");
+
+    bool independent = false;
+    for (size_t i = 1; i < replicas; ++i) {
+        independent = independent || parallel[i] != parallel[0];
+    }
+    check(independent, "replicas draw independent random streams");
+
+    // 2. Network statistics and battery results are merged across replicas
+    const auto& delivery = summary["network.delivery_rate"];
+    check(delivery.count == replicas && std::abs(delivery.mean - (1.0 - scenario.packetLoss)) < 0.05,
+          "delivery rate matches the configured packet loss");
+    check(summary.count("battery.mean_level") && summary["battery.mean_level"].mean < 100.0 &&
+          summary["battery.mean_level"].stddev > 0.0, "battery levels vary across replicas");
+    check(summary.count("battery.lifetime_hours") && summary["battery.lifetime_hours"].mean > 1.0,
+          "battery lifetime is projected");
+    check(summary["gateway.mean_reading"].count == replicas, "scenario metrics are summarised");
+
+    // 3. Summary statistics
+    auto sample = iot::ReplicaRunner::summarize({2, 4, 4, 4, 5, 5, 7, 9});
+    double expectedDeviation = std::sqrt(32.0 / 7.0);
+    check(sample.count == 8 && sample.mean == 5.0 && sample.min == 2.0 && sample.max == 9.0,
+          "mean and range");
+    check(std::abs(sample.stddev - expectedDeviation) < 1e-12 &&
+          std::abs(sample.ci95 - 1.96 * expectedDeviation / std::sqrt(8.0)) < 1e-12,
+          "sample standard deviation and 95% confidence interval");
+    check(iot::ReplicaRunner::summarize({3.0}).ci95 == 0.0, "a single replica has no interval");
+
+    return test_check::finish("Replica Runner Test");
+}
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <string>
+#include "../include/core/DeviceManager.h"
+#include "../include/devices/SensorBank.h"
+#include "TestCheck.h"
+
+int main() {
+    test_check::begin("Sensor Bank Test");
+
+    using Kind = iot::SensorBank::Kind;
+
+    // 1. Readings stay in range and follow the diurnal pattern
+    auto bank = std::make_shared<iot::SensorBank>(42);
+    const size_t perKind = 1000;
+    for (size_t i = 0; i < perKind; ++i) {
+        bank->addSensor(Kind::TEMPERATURE, "TEMP_" + std::to_string(i));
+        bank->addSensor(Kind::HUMIDITY, "HUM_" + std::to_string(i));
+        bank->addSensor(Kind::MOTION, "MOTION_" + std::to_string(i));
+    }
+    check(bank->size() == 3 * perKind, "sensors are stored per kind");
+
+    bank->update(12);
+    bool inRange = true;
+    double noonTemperature = 0.0;
+    for (double value : bank->getValues(Kind::TEMPERATURE)) {
+        inRange = inRange && value >= 21.7 && value <= 24.3;
+        noonTemperature += value;
+    }
+    for (double value : bank->getValues(Kind::HUMIDITY)) {
+        inRange = inRange && value >= 0.0 && value <= 100.0;
+    }
+    for (double value : bank->getValues(Kind::MOTION)) {
+        inRange = inRange && (value == 0.0 || value == 1.0);
+    }
+    check(inRange, "readings match the per-object sensor model");
+
+    bank->update(0);
+    double midnightTemperature = 0.0;
+    for (double value : bank->getValues(Kind::TEMPERATURE)) midnightTemperature += value;
+    check(noonTemperature > midnightTemperature, "noon is warmer than midnight");
+
+    // 2. Same seed, same readings
+    iot::SensorBank first(7), second(7);
+    for (size_t i = 0; i < 100; ++i) {
+        first.addSensor(Kind::TEMPERATURE, "A");
+        second.addSensor(Kind::TEMPERATURE, "A");
+    }
+    for (int tick = 0; tick < 5; ++tick) {
+        first.update(tick);
+        second.update(tick);
+    }
+    check(first.getValues(Kind::TEMPERATURE) == second.getValues(Kind::TEMPERATURE),
+          "counter-based noise is reproducible from the seed");
+
+    // 3. A banked sensor can be registered like any other device
+    auto deviceManager = std::make_shared<iot::DeviceManager>();
+    auto exposed = iot::SensorBank::exposeSensor(bank, {Kind::TEMPERATURE, 3}, "Banked Temperature");
+    check(deviceManager->registerDevice(exposed), "exposed sensor registers as an IoTDevice");
+    bank->update(15);
+    check(exposed->getDeviceId() == "TEMP_3" &&
+          exposed->readValue() == bank->getValue({Kind::TEMPERATURE, 3}),
+          "exposed sensor reads the bank's current value");
+
+    // 4. Bulk update throughput
+    iot::SensorBank large(1);
+    const size_t largeCount = 1000000;
+    large.reserve(Kind::TEMPERATURE, largeCount);
+    for (size_t i = 0; i < largeCount; ++i) large.addSensor(Kind::TEMPERATURE, "");
+    auto start = std::chrono::steady_clock::now();
+    const int ticks = 10;
+    for (int tick = 0; tick < ticks; ++tick) large.update(tick);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Updated " << largeCount << " sensors x " << ticks << " ticks: "
+              << static_cast<size_t>(largeCount * ticks / seconds) << " readings/sec" << std::endl;
+
+    return test_check::finish("Sensor Bank Test");
+}
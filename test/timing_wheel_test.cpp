@@ -0,0 +1,142 @@
+#include <iostream>
+#include <chrono>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include <memory>
+#include "../include/simulation/SimulationEngine.h"
+#include "../include/simulation/TimingWheel.h"
+#include "TestCheck.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    iot::SimulationEvent makeEvent(Clock::time_point time, int priority, int id) {
+        iot::SimulationEvent event;
+        event.scheduledTime = time;
+        event.priority = priority;
+        event.eventId = std::to_string(id);
+        return event;
+    }
+
+    /**
+     * @brief Interleave pushes and pops on the wheel and a reference heap
+     *
+     * Items with equal time and priority may come out of the heap in any
+     * order, so only (time, priority) is compared.
+     */
+    bool matchesPriorityQueue(std::mt19937_64& rng, Clock::duration span, int operations) {
+        auto origin = Clock::now();
+        iot::TimingWheel<iot::SimulationEvent> wheel(origin);
+        std::priority_queue<iot::SimulationEvent, std::vector<iot::SimulationEvent>,
+                            std::greater<iot::SimulationEvent>> reference;
+        auto now = origin;
+        auto spanMs = std::chrono::duration_cast<std::chrono::milliseconds>(span).count();
+        std::uniform_int_distribution<long long> offsetMs(0, spanMs);
+        std::uniform_int_distribution<Clock::rep> offset(0, span.count());
+        std::uniform_int_distribution<int> priority(0, 2);
+
+        for (int i = 0; i < operations; ++i) {
+            if (rng() % 3 != 0 || reference.empty()) {
+                // Mostly whole milliseconds so many events share a timestamp
+                auto time = (rng() % 4 == 0) ? now + Clock::duration(offset(rng))
+                                             : now + std::chrono::milliseconds(offsetMs(rng));
+                wheel.push(makeEvent(time, priority(rng), i));
+                reference.push(makeEvent(time, 0, 0));
+            } else {
+                const auto& expected = reference.top();
+                const auto* actual = wheel.peek();
+                if (!actual || actual->scheduledTime != expected.scheduledTime) return false;
+                now = actual->scheduledTime;
+                wheel.pop();
+                reference.pop();
+            }
+        }
+        while (!reference.empty()) {
+            if (wheel.empty() || wheel.pop().scheduledTime != reference.top().scheduledTime) return false;
+            reference.pop();
+        }
+        return wheel.empty();
+    }
+}
+
+int main() {
+    test_check::begin("Timing Wheel Test");
+
+    std::mt19937_64 rng(12345);
+
+    // 1. Same-time ordering: priority first, then insertion order
+    auto origin = Clock::now();
+    iot::TimingWheel<iot::SimulationEvent> wheel(origin);
+    auto at = origin + std::chrono::milliseconds(5);
+    wheel.push(makeEvent(at, 0, 1));
+    wheel.push(makeEvent(at, 5, 2));
+    wheel.push(makeEvent(at, 0, 3));
+    wheel.push(makeEvent(origin + std::chrono::milliseconds(2), 0, 4));
+    std::string order;
+    while (!wheel.empty()) order += wheel.pop().eventId;
+    check(order == "4213", "earliest first, higher priority first, then FIFO");
+
+    // 2. Exact order against std::priority_queue at several horizons
+    check(matchesPriorityQueue(rng, std::chrono::milliseconds(200), 20000), "matches heap within level 0");
+    check(matchesPriorityQueue(rng, std::chrono::minutes(10), 20000), "matches heap across levels 1-2");
+    check(matchesPriorityQueue(rng, std::chrono::hours(24 * 30), 20000), "matches heap across level 3");
+    check(matchesPriorityQueue(rng, std::chrono::hours(24 * 365 * 3), 20000), "matches heap through the overflow heap");
+
+    // 3. Items pushed behind a cursor that has already jumped ahead
+    iot::TimingWheel<iot::SimulationEvent> jumped(origin);
+    jumped.push(makeEvent(origin + std::chrono::hours(24 * 200), 0, 1));
+    jumped.peek();
+    jumped.push(makeEvent(origin + std::chrono::seconds(1), 0, 2));
+    check(jumped.pop().eventId == "2" && jumped.pop().eventId == "1", "late inserts before the cursor stay ordered");
+
+    // 4. Taken items leave tombstones that are skipped and reclaimed lazily
+    iot::TimingWheel<iot::SimulationEvent> cancelling(origin);
+    std::vector<iot::TimingWheel<iot::SimulationEvent>::Ticket> tickets;
+    for (int i = 0; i < 1000; ++i) {
+        tickets.push_back(cancelling.push(makeEvent(origin + std::chrono::milliseconds(i * 997 % 100000), 0, i)));
+    }
+    cancelling.peek();  // some items are now in the ready heap, the rest in slots
+    size_t taken = 0;
+    for (int i = 0; i < 1000; i += 2) {
+        auto item = cancelling.take(tickets[i]);
+        if (item && item->eventId == std::to_string(i)) taken++;
+    }
+    check(taken == 500 && cancelling.size() == 500, "take removes items by ticket");
+    check(!cancelling.take(tickets[0]) && !cancelling.contains(tickets[0]), "a taken ticket is stale");
+    bool onlyKept = true;
+    auto previous = origin;
+    while (!cancelling.empty()) {
+        auto event = cancelling.pop();
+        onlyKept = onlyKept && std::stoi(event.eventId) % 2 == 1 && event.scheduledTime >= previous;
+        previous = event.scheduledTime;
+    }
+    check(onlyKept, "cancelled items never come out and order is kept");
+    auto reused = cancelling.push(makeEvent(origin, 0, 0));
+    check(!cancelling.contains(tickets[1]) && cancelling.contains(reused), "reused nodes get a new generation");
+
+    // 5. Move-only callbacks: small captures inline, large ones counted
+    struct Large { char bytes[64]; };
+    static_assert(iot::EventCallback::fitsInline<std::function<void()>>(), "std::function targets fit inline");
+    static_assert(!iot::EventCallback::fitsInline<Large>(), "64-byte captures do not fit inline");
+    int fired = 0;
+    auto unique = std::make_unique<int>(5);
+    iot::SimulationEvent owning = makeEvent(origin, 0, 1);
+    owning.callback = [&fired, value = std::move(unique)]() { fired += *value; };
+    check(owning.callback.isInline(), "captures within 48 bytes are stored inline");
+    size_t fallbacksBefore = iot::EventCallback::heapFallbacks();
+    Large large{};
+    large.bytes[0] = 2;
+    iot::SimulationEvent spilled = makeEvent(origin, 0, 2);
+    spilled.callback = [&fired, large]() { fired += large.bytes[0]; };
+    check(!spilled.callback.isInline() && iot::EventCallback::heapFallbacks() == fallbacksBefore + 1,
+          "larger captures fall back to the heap and are counted");
+    iot::TimingWheel<iot::SimulationEvent> owningWheel(origin);
+    owningWheel.push(std::move(owning));
+    owningWheel.push(std::move(spilled));
+    while (!owningWheel.empty()) owningWheel.pop().callback();
+    check(fired == 7, "move-only callbacks survive the wheel and fire");
+
+    return test_check::finish("Timing Wheel Test");
+}
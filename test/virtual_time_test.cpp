@@ -0,0 +1,106 @@
+#include <iostream>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <thread>
+#include "../include/core/DeviceManager.h"
+#include "../include/network/NetworkManager.h"
+#include "../include/simulation/SimulationEngine.h"
+#include "../include/devices/ConcreteSensors.h"
+#include "TestCheck.h"
+
+int main() {
+    test_check::begin("Virtual Time Simulation Test");
+
+    auto deviceManager = std::make_shared<iot::DeviceManager>();
+    auto networkManager = std::make_shared<iot::NetworkManager>(deviceManager);
+    iot::SimulationEngine engine(deviceManager, networkManager);
+    engine.setTimeMode(iot::SimulationEngine::TimeMode::VIRTUAL_TIME);
+
+    // 1. Ordering: earlier time first, higher priority first at the same time
+    std::vector<std::string> order;
+    engine.scheduleEvent(std::chrono::milliseconds(2000), [&]() { order.push_back("late"); }, "late");
+    engine.scheduleEvent(std::chrono::milliseconds(1000), [&]() { order.push_back("low"); }, "low", 1);
+    engine.scheduleEvent(std::chrono::milliseconds(1000), [&]() { order.push_back("high"); }, "high", 5);
+
+    auto origin = engine.getCurrentTime();
+    size_t executed = engine.runFor(std::chrono::milliseconds(1500));
+    check(executed == 2, "only events inside the window are executed");
+    check(order.size() == 2 && order[0] == "high" && order[1] == "low",
+          "same-time events run in priority order");
+    check(engine.getCurrentTime() - origin == std::chrono::milliseconds(1500),
+          "clock lands on the end of the window");
+
+    engine.runFor(std::chrono::milliseconds(1000));
+    check(order.size() == 3 && order[2] == "late", "remaining event runs in the next window");
+
+    // 2. A month of hourly reports must not take a month of wall time
+    size_t hourlyReports = 0;
+    std::chrono::steady_clock::time_point lastFire;
+    engine.scheduleRepeatingEvent(std::chrono::hours(1), [&]() {
+        hourlyReports++;
+        lastFire = engine.getCurrentTime();
+    }, "HOURLY_REPORT");
+
+    auto wallStart = std::chrono::steady_clock::now();
+    engine.runFor(std::chrono::hours(24 * 30));
+    auto wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - wallStart).count();
+
+    check(hourlyReports == 24 * 30, "repeating event fires once per simulated hour");
+    check(lastFire <= engine.getCurrentTime(), "event clock never exceeds the engine clock");
+    check(wallMs < 5000, "30 simulated days complete in under 5 wall-clock seconds");
+    std::cout << "Hourly reports: " << hourlyReports << ", wall time: " << wallMs << " ms" << std::endl;
+
+    // 3. Time of day follows the simulated clock, not the wall clock
+    auto clock = engine.getSimClock();
+    auto sensor = std::make_shared<iot::TemperatureSensor>("TEMP_CLOCK", "Clock Sensor");
+    deviceManager->registerDevice(sensor);
+    check(sensor->getSimClock() == clock, "registered devices share the engine clock");
+
+    clock->setTimeOfDay(0.0);
+    auto dayStart = clock->getElapsed();
+    engine.runFor(std::chrono::hours(6));
+    check(clock->getHour() == 6 && clock->getElapsed() - dayStart == std::chrono::hours(6),
+          "clock hour advances with virtual time");
+    engine.runFor(std::chrono::hours(6));
+    double noonReading = sensor->readValue();
+    engine.runFor(std::chrono::hours(12));
+    double midnightReading = sensor->readValue();
+    check(clock->getHour() == 0 && noonReading > 23.5 && midnightReading < 20.5,
+          "sensor follows the diurnal curve of simulated time");
+
+    // 4. Event handles cancel and reschedule without touching the callbacks
+    size_t cancelledRuns = 0;
+    size_t movedRuns = 0;
+    size_t tickerRuns = 0;
+    auto cancelled = engine.scheduleEvent(std::chrono::seconds(10), [&]() { cancelledRuns++; }, "CANCELLED");
+    auto moved = engine.scheduleEvent(std::chrono::seconds(10), [&]() { movedRuns++; }, "MOVED");
+    iot::EventHandle ticker;
+    ticker = engine.scheduleRepeatingEvent(std::chrono::seconds(1), [&]() {
+        if (++tickerRuns == 5) ticker.cancel();
+    }, "TICKER");
+    check(cancelled.cancel() && !cancelled.isPending(), "pending event can be cancelled");
+    check(!cancelled.cancel(), "cancelling twice is a no-op");
+    check(moved.reschedule(std::chrono::seconds(30)), "pending event can be rescheduled");
+    engine.runFor(std::chrono::seconds(20));
+    check(cancelledRuns == 0 && movedRuns == 0, "cancelled and postponed events do not fire early");
+    check(tickerRuns == 5 && !ticker.isPending(), "repeating event can cancel itself from its callback");
+    engine.runFor(std::chrono::seconds(20));
+    check(movedRuns == 1 && !moved.isPending() && !moved.cancel(), "handle goes stale once the event fired");
+
+    // 5. Threaded loop jumps between events instead of sleeping
+    std::atomic<size_t> threadedEvents{0};
+    engine.scheduleEvent(std::chrono::hours(24 * 365), [&]() { threadedEvents++; }, "NEXT_YEAR");
+    engine.start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (threadedEvents == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    engine.stop();
+    check(threadedEvents == 1, "threaded virtual loop reaches an event one year ahead");
+
+    return test_check::finish("Virtual Time Test");
+}